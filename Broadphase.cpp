@@ -9,8 +9,10 @@
 
 void Broadphase::build(const std::vector<Body>& bodies)
 {
-    grid.clear();
+    for (auto& [cell, indices] : grid)
+        indices.clear();
     grid.reserve(bodies.size());
+    bodyCells.resize(bodies.size());
 
     for (size_t i=0;i<bodies.size();i++)
     {
@@ -21,42 +23,42 @@ void Broadphase::build(const std::vector<Body>& bodies)
 
         Cell c{cx,cy};
 
+        bodyCells[i] = c;
         grid[c].push_back(i);
 //        std::cout << "cell bucket: " << grid.bucket(c) << " of the body ID: " << b.id << std::endl;
     }
+
+    std::erase_if(grid, [](const auto& entry) { return entry.second.empty(); });
 }
 
 std::vector<std::pair<int, int>> Broadphase::computePairs()
 {
     std::vector<std::pair<int,int>> pairs;
+    computePairs(pairs);
+    return pairs;
+}
+
+void Broadphase::computePairs(std::vector<std::pair<int, int>>& pairs)
+{
+    pairs.clear();
 
-    for (const auto& [cell, indices] : grid) {
+    // Each pair is emitted once, by its lower index. Cell vectors hold
+    // their bodies in increasing index order and the neighbours are
+    // visited in a fixed order, so the result does not depend on the
+    // hash table layout.
+    for (size_t b = 0; b < bodyCells.size(); ++b) {
+        const int i = static_cast<int>(b);
+        const Cell cell = bodyCells[b];
         // Check this cell and all 8 neighbors
         for (int dx = -1; dx <= 1; ++dx) {
             for (int dy = -1; dy <= 1; ++dy) {
-                Cell neighbor{cell.x + dx, cell.y + dy};
-                auto it = grid.find(neighbor);
+                auto it = grid.find(Cell{cell.x + dx, cell.y + dy});
                 if (it == grid.end())
                     continue;
-
-                const auto& neighborIndices = it->second;
-
-                if (dx == 0 && dy == 0) {
-                    // Same cell: pair each body with every other
-                    for (size_t a = 0; a < indices.size(); ++a)
-                        for (size_t b = a + 1; b < indices.size(); ++b)
-                            pairs.emplace_back(indices[a], indices[b]);
-                } else {
-                    // Neighbor cell: only emit pair when our index < theirs
-                    // to avoid duplicates (each neighbor pair is visited twice)
-                    for (int i : indices)
-                        for (int j : neighborIndices)
-                            if (i < j)
-                                pairs.emplace_back(i, j);
-                }
+                for (int j : it->second)
+                    if (i < j)
+                        pairs.emplace_back(i, j);
             }
         }
     }
-
-    return pairs;
 }
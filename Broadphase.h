@@ -14,10 +14,19 @@ class Broadphase
 {
 public:
 
+    // Cells keep their index vectors from the last build, only cells
+    // that ended up empty are dropped. Bodies that stay in their cell
+    // cost no allocation.
     void build(const std::vector<Body>& bodies);
 
+    // Pairs (i, j) with i < j, grouped by i in increasing order, the
+    // same whatever the layout of the hash grid. A world restored from a
+    // snapshot sees its contacts in the same order as the one that saved it.
     std::vector<std::pair<int,int>> computePairs();
 
+    // Same pairs into a caller owned buffer that keeps its capacity
+    void computePairs(std::vector<std::pair<int,int>>& pairs);
+
 private:
 
     struct Cell {
@@ -40,6 +49,7 @@ private:
     float cellSize = Body::ALLOWED_BODY_SIZE;
 
     std::unordered_map<Cell,std::vector<int>,CellHash> grid{};
+    std::vector<Cell> bodyCells;    // cell of every body, by index
 };
 
 
@@ -1,8 +1,17 @@
 #include "bench.h"
 #include "boid_flock.h"
 #include "boid.h"
+#include "contact_solver.h"
 #include "physics_world.h"
 #include "body.h"
+#include "rollback.h"
+#include "rvo_solver.h"
+#include "scenario_file.h"
+#include "thread_pool.h"
+#include "world_pool.h"
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
 #include <random>
 #include <vector>
 
@@ -10,13 +19,14 @@
 
 static std::mt19937 rng{42};
 
-static Flock make_flock(int n)
+static Flock make_flock(int n, NeighbourSearch search = NeighbourSearch::BruteForce)
 {
     std::uniform_real_distribution<float> rx(-Flock::WORLD_HALF_W, Flock::WORLD_HALF_W);
     std::uniform_real_distribution<float> ry(-Flock::WORLD_HALF_H, Flock::WORLD_HALF_H);
     std::uniform_real_distribution<float> rv(-2.0f, 2.0f);
 
     Flock flock;
+    flock.set_neighbour_search(search);
     for (int i = 0; i < n; ++i) {
         Boid b;
         b.body.id           = static_cast<uint32_t>(i);
@@ -58,6 +68,100 @@ static PhysicsWorld make_physics_world(int n, float spread = 200.0f)
     return world;
 }
 
+// Columns of resting boxes on static boxes, far enough apart to be
+// separate islands. Every box starts slightly sunk into the one below.
+static PhysicsWorld make_box_stacks(int columns, int height, PositionSolver solver)
+{
+    PhysicsWorld world(1.0f / 60.0f);
+    world.solver_settings().positionSolver = solver;
+
+    uint32_t id = 0;
+    for (int c = 0; c < columns; ++c) {
+        const float x = static_cast<float>(c) * 3.0f;
+        Body ground{};
+        ground.id         = id++;
+        ground.type       = BodyType::Static;
+        ground.position   = {x, 5.0f};
+        ground.halfWidth  = 0.5f;
+        ground.halfHeight = 0.5f;
+        ground.shape.type = Type::box;
+        world.getBodies().push_back(ground);
+
+        for (int h = 1; h <= height; ++h) {
+            Body b = ground;
+            b.id           = id++;
+            b.type         = BodyType::Dynamic;
+            b.position     = {x, 5.0f + 0.95f * static_cast<float>(h)};
+            b.acceleration = {0.0f, -9.8f};
+            b.invMass      = 1.0f;
+            world.getBodies().push_back(b);
+        }
+    }
+    return world;
+}
+
+// One island of n x n dynamic boxes, every neighbour pair in contact and
+// the left column against a static wall. The solver is prepared once,
+// every call solves the same rows again from the same velocities.
+// lanes = 0 turns the colouring off: the plain row by row solver.
+struct ContactPile {
+    std::vector<Body> start;
+    std::vector<Body> bodies;
+    SolverSettings settings;
+    ContactSolver solver;
+
+    void solve()
+    {
+        bodies = start;
+        solver.solve(bodies, settings, nullptr);
+    }
+};
+
+static ContactPile make_contact_pile(int n, int lanes)
+{
+    ContactPile pile;
+    auto id = [n](int x, int y) { return static_cast<BodyID>(1 + y * n + x); };
+    Body wall{};
+    wall.type = BodyType::Static;
+    wall.position = {-1.0f, 0.0f};
+    pile.start.push_back(wall);
+    for (int y = 0; y < n; ++y) {
+        for (int x = 0; x < n; ++x) {
+            Body b{};
+            b.id       = id(x, y);
+            b.type     = BodyType::Dynamic;
+            b.position = {static_cast<float>(x), static_cast<float>(y)};
+            b.velocity = {-1.0f - 0.01f * static_cast<float>(x), -0.5f};
+            b.invMass  = 1.0f;
+            pile.start.push_back(b);
+        }
+    }
+
+    std::vector<ContactManifold> manifolds;
+    auto touch = [&](BodyID a, BodyID b, glm::vec2 normal) {
+        ContactManifold m{};
+        m.bodyA = a;
+        m.bodyB = b;
+        m.pointCount = 1;
+        m.points[0].normal = normal;
+        manifolds.push_back(m);
+    };
+    for (int y = 0; y < n; ++y) {
+        touch(id(0, y), 0, {1.0f, 0.0f});
+        for (int x = 0; x < n; ++x) {
+            if (x + 1 < n) touch(id(x + 1, y), id(x, y), {1.0f, 0.0f});
+            if (y + 1 < n) touch(id(x, y + 1), id(x, y), {0.0f, 1.0f});
+        }
+    }
+
+    pile.settings.velocityTolerance = 0.0f;
+    pile.settings.simdLanes = lanes;
+    if (lanes == 0)
+        pile.settings.coloringMinContacts = static_cast<int>(manifolds.size()) + 1;
+    pile.solver.prepare(pile.start, manifolds, pile.settings, 0.0f);
+    return pile;
+}
+
 // ── main ─────────────────────────────────────────────────────────────────────
 
 int main()
@@ -70,10 +174,56 @@ int main()
     auto flock_2000 = make_flock(2000);
     auto flock_5000 = make_flock(5000);
 
+    // Same flocks with the uniform grid, plus a size brute force can not take
+    auto grid_1000  = make_flock(1000,  NeighbourSearch::Grid);
+    auto grid_5000  = make_flock(5000,  NeighbourSearch::Grid);
+    auto grid_20000 = make_flock(20000, NeighbourSearch::Grid);
+
     // Physics-world scenarios (integration + broadphase, sparse so no CCD log spam)
     auto world_100  = make_physics_world(100);
     auto world_500  = make_physics_world(500);
     auto world_1000 = make_physics_world(1000);
+    auto world_catchup = make_physics_world(1000);
+
+    // Rollback: 8 steps rewound and re-simulated per call
+    auto world_rollback = make_physics_world(5000);
+    RollbackBuffer rollback(world_rollback, nullptr, 16);
+    rollback.save();
+    for (int i = 0; i < 8; ++i) {
+        world_rollback.step_once(true);
+        rollback.save();
+    }
+
+    // Contact scenarios: same stacks, different position correction
+    auto stacks_split = make_box_stacks(50, 10, PositionSolver::SplitImpulse);
+    auto stacks_ngs   = make_box_stacks(50, 10, PositionSolver::NonLinearGaussSeidel);
+
+    // Velocity iterations on one ~20k body island, per lane width
+    auto pile_rows     = make_contact_pile(141, 0);
+    auto pile_lanes_4  = make_contact_pile(141, 4);
+    auto pile_lanes_8  = make_contact_pile(141, 8);
+    auto pile_lanes_16 = make_contact_pile(141, 16);
+
+    // Ensemble: 1000 small worlds (20 bodies, 30 boids) stepped in parallel
+    ThreadPool threads;
+    WorldPool ensemble(dt, 1000);
+    for (uint32_t w = 0; w < ensemble.size(); ++w) {
+        ensemble.world(w).getBodies() = make_physics_world(20, 20.0f).getBodies();
+        ensemble.flock(w) = make_flock(30);
+    }
+
+    // Scenario loading: a million bodies mapped and copied into a world
+    const std::string scenario_path =
+        (std::filesystem::temp_directory_path() / "bench_1m.scn").string();
+    write_scenario(scenario_path, make_physics_world(1000000, 2000.0f), nullptr, nullptr);
+    auto load_scenario = [&] {
+        ScenarioFile file;
+        file.open(scenario_path);
+        PhysicsWorld world(file.fixed_dt());
+        Flock flock;
+        RVOSolver rvo(file.fixed_dt());
+        file.build(world, flock, rvo);
+    };
 
     bench_run({
         // ── boids ──────────────────────────────────────────────────────────
@@ -81,10 +231,45 @@ int main()
         { "boids/brute_force  N=1000", [&]{ flock_1000.step(dt); }, 5, 100 },
         { "boids/brute_force  N=2000", [&]{ flock_2000.step(dt); }, 5,  50 },
         { "boids/brute_force  N=5000", [&]{ flock_5000.step(dt); }, 5,  20 },
+        { "boids/grid  N=1000",  [&]{ grid_1000 .step(dt); }, 5, 100 },
+        { "boids/grid  N=5000",  [&]{ grid_5000 .step(dt); }, 5,  20 },
+        { "boids/grid  N=20000", [&]{ grid_20000.step(dt); }, 2,   5 },
 
         // ── physics world (sparse — no CCD collisions) ─────────────────────
         { "physics/sparse  N=100",  [&]{ world_100 .fixed_step(dt); }, 5, 200 },
         { "physics/sparse  N=500",  [&]{ world_500 .fixed_step(dt); }, 5, 100 },
         { "physics/sparse  N=1000", [&]{ world_1000.fixed_step(dt); }, 5,  50 },
+        // fast forward: 10 steps per call, compare against 10x the line above
+        { "physics/step_n x10  N=1000", [&]{ world_catchup.step_n(10); }, 2, 10 },
+        // rewind 8 steps and re-simulate them, the whole rollback budget
+        { "physics/rollback x8  N=5000",
+          [&]{ rollback.resimulate(world_rollback.step_count() - 8, nullptr); }, 2, 20 },
+
+        // ── contacts (50 stacks of 10 boxes) ───────────────────────────────
+        { "contacts/stacks split_impulse", [&]{ stacks_split.fixed_step(dt); }, 5, 100 },
+        { "contacts/stacks ngs",           [&]{ stacks_ngs  .fixed_step(dt); }, 5, 100 },
+
+        // ── contacts (one pile of 141x141 boxes, 8 velocity iterations) ─────
+        { "contacts/pile  row_by_row", [&]{ pile_rows    .solve(); }, 3, 30 },
+        { "contacts/pile  lanes=4",    [&]{ pile_lanes_4 .solve(); }, 3, 30 },
+        { "contacts/pile  lanes=8",    [&]{ pile_lanes_8 .solve(); }, 3, 30 },
+        { "contacts/pile  lanes=16",   [&]{ pile_lanes_16.solve(); }, 3, 30 },
+
+        // ── ensemble (1000 worlds, 10 steps each per call) ─────────────────
+        { "ensemble/1000 worlds x10", [&]{ ensemble.run(10, &threads); }, 2, 20 },
+
+        // ── loading (open + build, 1M bodies) ──────────────────────────────
+        { "load/scenario  N=1000000", load_scenario, 1, 5 },
     });
+
+    // Accuracy side of the trade: overlap left after the last measured step
+    for (const auto& [name, world] : {std::pair{"split_impulse", &stacks_split},
+                                      std::pair{"ngs", &stacks_ngs}}) {
+        const SolverStats& stats = world->solver_stats();
+        std::cout << "stacks " << std::left << std::setw(14) << name
+                  << std::fixed << std::setprecision(5)
+                  << " max_penetration=" << stats.maxPenetration
+                  << " rms=" << stats.rmsPenetration
+                  << " position_iters=" << stats.positionIterations << '\n';
+    }
 }
@@ -34,4 +34,12 @@ struct Body {
     Shape shape;
 };
 
+// The broadphase grid uses cells of ALLOWED_BODY_SIZE and only looks at
+// the 3x3 cells around a body, so a bigger box would miss pairs.
+inline bool fits_broadphase_cell(const Body& b)
+{
+    return 2.0f * b.halfWidth <= Body::ALLOWED_BODY_SIZE &&
+           2.0f * b.halfHeight <= Body::ALLOWED_BODY_SIZE;
+}
+
 #endif //BODY_H
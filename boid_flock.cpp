@@ -3,101 +3,413 @@
 //
 #include "boid_flock.h"
 #include "Integrator.h"
+#include "interpolation.h"
+#include "snapshot.h"
 #include <glm/glm.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 void Flock::add_boid(Boid boid)
 {
     boids.push_back(std::move(boid));
 }
 
-glm::vec2 Flock::separation(const Boid& boid) const
+void Flock::assign_boids(const std::span<const Boid> src)
 {
-    glm::vec2 steer{0.0f, 0.0f};
-    int count = 0;
-    for (const auto& other : boids) {
-        if (&other == &boid) continue;
-        glm::vec2 diff = boid.body.position - other.body.position;
-        float d = glm::length(diff);
-        if (d > 0.0f && d < boid.perception) {
-            steer += diff / d;
-            ++count;
+    boids.assign(src.begin(), src.end());
+    prev_positions.clear();
+}
+
+void BoidsSoA::resize(const size_t n)
+{
+    x.resize(n);
+    y.resize(n);
+    vx.resize(n);
+    vy.resize(n);
+}
+
+// Counting sort of the boids into cells of the largest perception over
+// their bounding box. Boids keep their index order inside a cell. When
+// the box holds far more cells than boids (a few strays far away) the
+// cells are made larger, which only adds candidates. The packed arrays
+// are filled in the sorted order.
+void Flock::build_grid()
+{
+    const size_t n = boids.size();
+    if (m_search == NeighbourSearch::BruteForce) {
+        m_grid_w = 1;
+        m_grid_h = 1;
+        m_cell_start.assign({0, static_cast<uint32_t>(n)});
+        m_boid_cell.assign(n, 0);
+        m_cell_boids.resize(n);
+        for (size_t i = 0; i < n; ++i)
+            m_cell_boids[i] = static_cast<uint32_t>(i);
+    } else {
+        // Non-finite positions stay out of the box, they are clamped into
+        // the border cells below and are never within anyone's perception
+        glm::vec2 lo{std::numeric_limits<float>::max()};
+        glm::vec2 hi{-std::numeric_limits<float>::max()};
+        float perception = 0.0f;
+        for (const Boid& b: boids) {
+            if (std::isfinite(b.body.position.x) && std::isfinite(b.body.position.y)) {
+                lo = glm::min(lo, b.body.position);
+                hi = glm::max(hi, b.body.position);
+            }
+            perception = std::max(perception, b.perception);
         }
+        if (lo.x > hi.x)
+            lo = hi = glm::vec2{0.0f, 0.0f};
+
+        m_cell_size = perception > 0.0f ? perception : 1.0f;
+        // hi - lo overflows for boids near both ends of the float range
+        const glm::vec2 extent = hi - lo;
+        const float maxCells = 4.0f * static_cast<float>(n) + 16.0f;
+        const auto cellCount = [&] {
+            return (extent.x / m_cell_size + 1.0f) * (extent.y / m_cell_size + 1.0f);
+        };
+        while (cellCount() > maxCells && m_cell_size < std::numeric_limits<float>::max() / 2.0f)
+            m_cell_size *= 2.0f;
+
+        m_grid_origin = lo;
+        if (cellCount() > maxCells) {
+            m_grid_w = 1;
+            m_grid_h = 1;
+        } else {
+            m_grid_w = static_cast<int>(extent.x / m_cell_size) + 1;
+            m_grid_h = static_cast<int>(extent.y / m_cell_size) + 1;
+        }
+        const size_t cells = static_cast<size_t>(m_grid_w) * static_cast<size_t>(m_grid_h);
+
+        m_cell_start.assign(cells + 1, 0);
+        m_boid_cell.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            const glm::vec2 rel = (boids[i].body.position - m_grid_origin) / m_cell_size;
+            // clamped before the conversion; a NaN fails the comparison
+            // and lands in column or row 0
+            const int cx = rel.x >= 0.0f ? static_cast<int>(std::min(rel.x, static_cast<float>(m_grid_w - 1))) : 0;
+            const int cy = rel.y >= 0.0f ? static_cast<int>(std::min(rel.y, static_cast<float>(m_grid_h - 1))) : 0;
+            m_boid_cell[i] = static_cast<uint32_t>(cy * m_grid_w + cx);
+            ++m_cell_start[m_boid_cell[i] + 1];
+        }
+        for (size_t c = 0; c < cells; ++c)
+            m_cell_start[c + 1] += m_cell_start[c];
+
+        m_cell_boids.resize(n);
+        m_cell_cursor.assign(m_cell_start.begin(), m_cell_start.end() - 1);
+        for (size_t i = 0; i < n; ++i)
+            m_cell_boids[m_cell_cursor[m_boid_cell[i]]++] = static_cast<uint32_t>(i);
+    }
+
+    m_soa.resize(n);
+    for (size_t k = 0; k < n; ++k) {
+        const Body& b = boids[m_cell_boids[k]].body;
+        m_soa.x[k] = b.position.x;
+        m_soa.y[k] = b.position.y;
+        m_soa.vx[k] = b.velocity.x;
+        m_soa.vy[k] = b.velocity.y;
     }
-    if (count > 0) steer /= static_cast<float>(count);
-    return steer;
 }
 
-glm::vec2 Flock::alignment(const Boid& boid) const
-{
-    glm::vec2 avg{0.0f, 0.0f};
+namespace {
+
+// What the neighbours within perception add up to
+struct NeighbourSums {
+    float awayX = 0.0f;     // sum of unit vectors away from neighbours
+    float awayY = 0.0f;
+    float velX = 0.0f;
+    float velY = 0.0f;
+    float posX = 0.0f;
+    float posY = 0.0f;
+    int apart = 0;          // neighbours not sitting on the boid
     int count = 0;
-    for (const auto& other : boids) {
-        if (&other == &boid) continue;
-        float d = glm::length(other.body.position - boid.body.position);
-        if (d < boid.perception) {
-            avg += other.body.velocity;
-            ++count;
+};
+
+}
+
+// W candidates of [begin, end) at a time, each lane keeps its own sums
+// which are added up in lane order at the end. This is the scalar
+// fallback: candidates out of range are skipped, which gives the same
+// sums as the vector kernels adding zero for them. W = 1 is the tail.
+template <int W>
+static void accumulate_lanes(const BoidsSoA& s, const uint32_t begin, const uint32_t end,
+                             const float px, const float py, const float range,
+                             NeighbourSums& sums)
+{
+    float awayX[W] = {}, awayY[W] = {};
+    float velX[W] = {}, velY[W] = {};
+    float posX[W] = {}, posY[W] = {};
+    int apart[W] = {}, count[W] = {};
+
+    uint32_t j = begin;
+    for (; j + W <= end; j += W) {
+        for (int l = 0; l < W; ++l) {
+            const uint32_t k = j + static_cast<uint32_t>(l);
+            const float dx = px - s.x[k];
+            const float dy = py - s.y[k];
+            const float d2 = dx * dx + dy * dy;
+            if (!(d2 < range)) continue;
+            if (d2 > 0.0f) {
+                const float inv = 1.0f / std::sqrt(d2);
+                awayX[l] += dx * inv;
+                awayY[l] += dy * inv;
+                ++apart[l];
+            }
+            velX[l] += s.vx[k];
+            velY[l] += s.vy[k];
+            posX[l] += s.x[k];
+            posY[l] += s.y[k];
+            ++count[l];
         }
     }
-    if (count == 0) return glm::vec2{0.0f, 0.0f};
-    avg /= static_cast<float>(count);
-    if (glm::length(avg) > boid.max_speed)
-        avg = glm::normalize(avg) * boid.max_speed;
-    return avg - boid.body.velocity;
+
+    for (int l = 0; l < W; ++l) {
+        sums.awayX += awayX[l];
+        sums.awayY += awayY[l];
+        sums.velX += velX[l];
+        sums.velY += velY[l];
+        sums.posX += posX[l];
+        sums.posY += posY[l];
+        sums.apart += apart[l];
+        sums.count += count[l];
+    }
+
+    if constexpr (W > 1) {
+        if (j < end)
+            accumulate_lanes<1>(s, j, end, px, py, range, sums);
+    }
 }
 
-glm::vec2 Flock::cohesion(const Boid& boid) const
+#if defined(__AVX2__)
+// accumulate_lanes<8> written out for AVX2, without branches: lanes out
+// of range add zero. Square root and division are exact in both and the
+// lanes are summed in the same order, so a build with and without
+// ENGINE_AVX2 gives the same bits.
+static void accumulate_avx2(const BoidsSoA& s, const uint32_t begin, const uint32_t end,
+                            const float px, const float py, const float range,
+                            NeighbourSums& sums)
 {
-    glm::vec2 center{0.0f, 0.0f};
-    int count = 0;
-    for (const auto& other : boids) {
-        if (&other == &boid) continue;
-        float d = glm::length(other.body.position - boid.body.position);
-        if (d < boid.perception) {
-            center += other.body.position;
-            ++count;
+    const __m256 vpx = _mm256_set1_ps(px);
+    const __m256 vpy = _mm256_set1_ps(py);
+    const __m256 vrange = _mm256_set1_ps(range);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+
+    __m256 awayX = zero, awayY = zero;
+    __m256 velX = zero, velY = zero;
+    __m256 posX = zero, posY = zero;
+    __m256i apart = _mm256_setzero_si256();
+    __m256i count = _mm256_setzero_si256();
+
+    uint32_t j = begin;
+    for (; j + 8 <= end; j += 8) {
+        const __m256 x = _mm256_loadu_ps(s.x.data() + j);
+        const __m256 y = _mm256_loadu_ps(s.y.data() + j);
+        const __m256 dx = _mm256_sub_ps(vpx, x);
+        const __m256 dy = _mm256_sub_ps(vpy, y);
+        const __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        const __m256 in = _mm256_cmp_ps(d2, vrange, _CMP_LT_OQ);
+        const __m256 away = _mm256_and_ps(in, _mm256_cmp_ps(d2, zero, _CMP_GT_OQ));
+        const __m256 inv = _mm256_div_ps(one, _mm256_sqrt_ps(_mm256_blendv_ps(one, d2, away)));
+        awayX = _mm256_add_ps(awayX, _mm256_and_ps(away, _mm256_mul_ps(dx, inv)));
+        awayY = _mm256_add_ps(awayY, _mm256_and_ps(away, _mm256_mul_ps(dy, inv)));
+        velX = _mm256_add_ps(velX, _mm256_and_ps(in, _mm256_loadu_ps(s.vx.data() + j)));
+        velY = _mm256_add_ps(velY, _mm256_and_ps(in, _mm256_loadu_ps(s.vy.data() + j)));
+        posX = _mm256_add_ps(posX, _mm256_and_ps(in, x));
+        posY = _mm256_add_ps(posY, _mm256_and_ps(in, y));
+        // all bits set is -1
+        apart = _mm256_sub_epi32(apart, _mm256_castps_si256(away));
+        count = _mm256_sub_epi32(count, _mm256_castps_si256(in));
+    }
+
+    alignas(32) float lanes[6][8];
+    alignas(32) int32_t counts[2][8];
+    _mm256_store_ps(lanes[0], awayX);
+    _mm256_store_ps(lanes[1], awayY);
+    _mm256_store_ps(lanes[2], velX);
+    _mm256_store_ps(lanes[3], velY);
+    _mm256_store_ps(lanes[4], posX);
+    _mm256_store_ps(lanes[5], posY);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(counts[0]), apart);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(counts[1]), count);
+    for (int l = 0; l < 8; ++l) {
+        sums.awayX += lanes[0][l];
+        sums.awayY += lanes[1][l];
+        sums.velX += lanes[2][l];
+        sums.velY += lanes[3][l];
+        sums.posX += lanes[4][l];
+        sums.posY += lanes[5][l];
+        sums.apart += counts[0][l];
+        sums.count += counts[1][l];
+    }
+
+    if (j < end)
+        accumulate_lanes<1>(s, j, end, px, py, range, sums);
+}
+#endif
+
+// Neighbours among the candidates [begin, end), 8 per iteration
+static void accumulate_neighbours(const BoidsSoA& s, const uint32_t begin, const uint32_t end,
+                                  const float px, const float py, const float range,
+                                  NeighbourSums& sums)
+{
+#if defined(__AVX2__)
+    accumulate_avx2(s, begin, end, px, py, range, sums);
+#else
+    accumulate_lanes<8>(s, begin, end, px, py, range, sums);
+#endif
+}
+
+// One pass over the neighbours for all three rules, on the packed arrays.
+// Candidates are compared by squared distance. The candidates are the
+// 3x3 cells around the boid, three contiguous ranges, one per grid row;
+// the boid itself is cut out of its range.
+glm::vec2 Flock::steering(const Boid& boid, const uint32_t slot) const
+{
+    const glm::vec2 p = boid.body.position;
+    const float range = boid.perception > 0.0f ? boid.perception * boid.perception : 0.0f;
+
+    NeighbourSums sums;
+    const auto self = static_cast<size_t>(&boid - boids.data());
+    const int cx = static_cast<int>(m_boid_cell[self] % static_cast<uint32_t>(m_grid_w));
+    const int cy = static_cast<int>(m_boid_cell[self] / static_cast<uint32_t>(m_grid_w));
+    const int x0 = std::max(cx - 1, 0);
+    const int x1 = std::min(cx + 1, m_grid_w - 1);
+    for (int y = std::max(cy - 1, 0); y <= std::min(cy + 1, m_grid_h - 1); ++y) {
+        const uint32_t begin = m_cell_start[static_cast<size_t>(y * m_grid_w + x0)];
+        const uint32_t end = m_cell_start[static_cast<size_t>(y * m_grid_w + x1 + 1)];
+        // the range around the boid itself
+        if (slot >= begin && slot < end) {
+            accumulate_neighbours(m_soa, begin, slot, p.x, p.y, range, sums);
+            accumulate_neighbours(m_soa, slot + 1, end, p.x, p.y, range, sums);
+        } else {
+            accumulate_neighbours(m_soa, begin, end, p.x, p.y, range, sums);
         }
     }
-    if (count == 0) return glm::vec2{0.0f, 0.0f};
-    center /= static_cast<float>(count);
-    glm::vec2 desired = center - boid.body.position;
-    if (glm::length(desired) > 0.0f)
-        desired = glm::normalize(desired) * boid.max_speed;
-    return desired - boid.body.velocity;
+    if (sums.count == 0) return glm::vec2{0.0f, 0.0f};
+
+    const glm::vec2 v = boid.body.velocity;
+    const float maxSpeedSq = boid.max_speed * boid.max_speed;
+    const float inv = 1.0f / static_cast<float>(sums.count);
+
+    // separation: average direction away from the neighbours
+    const glm::vec2 sep = sums.apart > 0
+        ? glm::vec2{sums.awayX, sums.awayY} / static_cast<float>(sums.apart)
+        : glm::vec2{0.0f, 0.0f};
+
+    // alignment: towards the average velocity, capped at max_speed
+    glm::vec2 avg = glm::vec2{sums.velX, sums.velY} * inv;
+    const float avgSq = glm::dot(avg, avg);
+    if (avgSq > maxSpeedSq)
+        avg *= boid.max_speed / std::sqrt(avgSq);
+    const glm::vec2 ali = avg - v;
+
+    // cohesion: full speed towards the centre of the neighbours
+    glm::vec2 desired = glm::vec2{sums.posX, sums.posY} * inv - p;
+    const float desiredSq = glm::dot(desired, desired);
+    if (desiredSq > 0.0f)
+        desired *= boid.max_speed / std::sqrt(desiredSq);
+    const glm::vec2 coh = desired - v;
+
+    glm::vec2 steer = sep * boid.w_separation + ali * boid.w_alignment + coh * boid.w_cohesion;
+    const float steerSq = glm::dot(steer, steer);
+    if (steerSq > boid.max_force * boid.max_force)
+        steer *= boid.max_force / std::sqrt(steerSq);
+    return steer;
 }
 
-void Flock::wrap(Boid& boid)
+bool Flock::wrap(Boid& boid)
 {
     auto& p = boid.body.position;
+    const glm::vec2 before = p;
     if (p.x >  WORLD_HALF_W) p.x = -WORLD_HALF_W;
     if (p.x < -WORLD_HALF_W) p.x =  WORLD_HALF_W;
     if (p.y >  WORLD_HALF_H) p.y = -WORLD_HALF_H;
     if (p.y < -WORLD_HALF_H) p.y =  WORLD_HALF_H;
+    return p != before;
+}
+
+void Flock::interpolated_positions(const float alpha, std::vector<glm::vec2>& out) const
+{
+    out.resize(boids.size());
+    for (size_t i = 0; i < boids.size(); ++i)
+        out[i] = boids[i].body.position;
+    interpolate(prev_positions, out, alpha, out);
+}
+
+void Flock::hash_state(StateHash& h) const
+{
+    h.add(static_cast<uint32_t>(boids.size()));
+    for (const Boid& b: boids) {
+        hash_body(h, b.body);
+        h.add(b.perception);
+        h.add(b.max_speed);
+        h.add(b.max_force);
+        h.add(b.w_separation);
+        h.add(b.w_alignment);
+        h.add(b.w_cohesion);
+    }
 }
 
 void Flock::step(float dt)
 {
-    // 1. Compute and accumulate steering forces into acceleration
-    for (auto& boid : boids) {
-        glm::vec2 sep = separation(boid) * boid.w_separation;
-        glm::vec2 ali = alignment(boid)  * boid.w_alignment;
-        glm::vec2 coh = cohesion(boid)   * boid.w_cohesion;
+    prev_positions.resize(boids.size());
+    for (size_t i = 0; i < boids.size(); ++i)
+        prev_positions[i] = boids[i].body.position;
 
-        glm::vec2 steering = sep + ali + coh;
-        if (glm::length(steering) > boid.max_force)
-            steering = glm::normalize(steering) * boid.max_force;
+    if (!boids.empty())
+        build_grid();
 
-        boid.body.acceleration += steering * boid.body.invMass;
+    // 1. Compute and accumulate steering forces into acceleration, in
+    // packed order so neighbouring boids read neighbouring lanes
+    for (size_t k = 0; k < boids.size(); ++k) {
+        Boid& boid = boids[m_cell_boids[k]];
+        boid.body.acceleration += steering(boid, static_cast<uint32_t>(k)) * boid.body.invMass;
     }
 
     // 2. Integrate via the engine's semi-implicit Euler, clamp speed, wrap, reset
-    for (auto& boid : boids) {
+    for (size_t i = 0; i < boids.size(); ++i) {
+        Boid& boid = boids[i];
         Integrator::semi_implicit_euler(boid.body, dt);
 
         if (glm::length(boid.body.velocity) > boid.max_speed)
             boid.body.velocity = glm::normalize(boid.body.velocity) * boid.max_speed;
 
-        wrap(boid);
+        if (wrap(boid))
+            prev_positions[i] = boid.body.position;
         boid.body.acceleration = {0.0f, 0.0f};
     }
 }
+
+enum FlockSection : uint32_t {
+    FLOCK_BOIDS = 1,
+    FLOCK_PREV_POSITIONS
+};
+
+void Flock::save_snapshot(std::vector<std::byte>& out) const
+{
+    SnapshotWriter w(out, SnapshotKind::Flock);
+    w.write(FLOCK_BOIDS, std::span(boids));
+    w.write(FLOCK_PREV_POSITIONS, std::span(prev_positions));
+    w.finish();
+}
+
+bool Flock::accepts_snapshot(const std::span<const std::byte> in) const
+{
+    const SnapshotReader r(in, SnapshotKind::Flock);
+    return r.has<Boid>(FLOCK_BOIDS) && r.has<glm::vec2>(FLOCK_PREV_POSITIONS);
+}
+
+bool Flock::load_snapshot(const std::span<const std::byte> in)
+{
+    if (!accepts_snapshot(in))
+        return false;
+    const SnapshotReader r(in, SnapshotKind::Flock);
+    r.read(FLOCK_BOIDS, boids);
+    r.read(FLOCK_PREV_POSITIONS, prev_positions);
+    return true;
+}
@@ -4,30 +4,96 @@
 
 #ifndef ENGINELOOP_BOID_FLOCK_H
 #define ENGINELOOP_BOID_FLOCK_H
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <vector>
 #include "boid.h"
+#include "determinism.h"
 #include <glm/vec2.hpp>
 
+// How steering finds the boids within perception of a boid
+enum class NeighbourSearch {
+    // every other boid, O(N^2), kept as the reference
+    BruteForce,
+    // uniform grid with cells of the largest perception, rebuilt every
+    // step with a counting sort; only the 3x3 cells around a boid are
+    // visited
+    Grid
+};
+
+// Packed kinematic state of the boids for the neighbour pass, in grid
+// cell order: the candidates of one grid row are a contiguous range.
+struct BoidsSoA {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> vx;
+    std::vector<float> vy;
+
+    void resize(size_t n);
+};
+
 class Flock
 {
 public:
     static constexpr float WORLD_HALF_W = 10.0f;
     static constexpr float WORLD_HALF_H = 7.5f;
 
+    void set_neighbour_search(NeighbourSearch search) { m_search = search; }
+    NeighbourSearch neighbour_search() const { return m_search; }
+
     void add_boid(Boid boid);
 
+    // Replaces all boids in one copy, previous positions start over
+    void assign_boids(std::span<const Boid> boids);
+
     // Called by PhysicsWorld::fixed_step — computes steering then integrates
     // via Integrator::semi_implicit_euler, then clamps speed and wraps.
     void step(float dt);
 
+    // Boids stay the authoritative state, the packed arrays are a copy
+    // refreshed at the start of every step.
     const std::vector<Boid>& getBoids() const { return boids; }
 
+    // Boid positions at the start of the last step. A boid that wrapped
+    // around the world edge has its new position here, so it does not
+    // get drawn sliding across the whole screen.
+    const std::vector<glm::vec2>& getPreviousPositions() const { return prev_positions; }
+
+    void interpolated_positions(float alpha, std::vector<glm::vec2>& out) const;
+
+    // Boid bodies and their steering parameters, for lockstep checks
+    void hash_state(StateHash& h) const;
+
+    // Boids and previous positions in the flat format of snapshot.h.
+    // load_snapshot returns false (flock untouched) on a foreign buffer.
+    void save_snapshot(std::vector<std::byte>& out) const;
+    bool load_snapshot(std::span<const std::byte> in);
+    [[nodiscard]] bool accepts_snapshot(std::span<const std::byte> in) const;
+
 private:
-    glm::vec2 separation(const Boid& boid) const;
-    glm::vec2 alignment(const Boid& boid) const;
-    glm::vec2 cohesion(const Boid& boid) const;
-    void wrap(Boid& boid);
+    // Weighted separation + alignment + cohesion, clamped to max_force.
+    // slot is the position of the boid in m_soa.
+    glm::vec2 steering(const Boid& boid, uint32_t slot) const;
+    // true when the boid was moved to the opposite edge
+    bool wrap(Boid& boid);
+
+    void build_grid();
 
     std::vector<Boid> boids;
+    std::vector<glm::vec2> prev_positions;
+    NeighbourSearch m_search = NeighbourSearch::Grid;
+
+    // Grid over the bounding box of the boids, rebuilt by step().
+    // Brute force uses a single cell holding every boid.
+    glm::vec2 m_grid_origin{0.0f, 0.0f};
+    float m_cell_size = 1.0f;
+    int m_grid_w = 0;
+    int m_grid_h = 0;
+    std::vector<uint32_t> m_cell_start;     // cells + 1 offsets into m_cell_boids
+    std::vector<uint32_t> m_cell_boids;     // boid indices, by cell then index
+    std::vector<uint32_t> m_boid_cell;
+    std::vector<uint32_t> m_cell_cursor;    // scratch of the counting sort
+    BoidsSoA m_soa;                         // indexed like m_cell_boids
 };
 #endif //ENGINELOOP_BOID_FLOCK_H
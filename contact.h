@@ -4,6 +4,7 @@
 
 #ifndef CONTACT_H
 #define CONTACT_H
+#include <cstdint>
 #include "glm/vec2.hpp"
 
 struct ContactPoint {
@@ -12,5 +13,6 @@ struct ContactPoint {
     float penetration; // <= 0 for touching
     float Pn = 0.0f;    // accumulated normal impulse
     float Pt = 0.0f;    // accumulated tangent impulse
+    uint32_t feature = 0; // which features touch, stable across frames
 };
 #endif //CONTACT_H
@@ -0,0 +1,173 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#include "contact_cache.h"
+
+#include <algorithm>
+
+#include "narrowphase.h"
+
+uint64_t ContactCache::make_key(const BodyID a, const BodyID b)
+{
+    const BodyID lo = std::min(a, b);
+    const BodyID hi = std::max(a, b);
+    return (static_cast<uint64_t>(lo) << 32) | hi;
+}
+
+// Index of the entry holding key, or of the empty entry where it would go.
+// The table is never full, so the loop ends.
+size_t ContactCache::probe(const uint64_t key) const
+{
+    const size_t mask = m_entries.size() - 1;
+    // Fibonacci hashing spreads neighbouring ids over the table
+    size_t i = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+    while (m_entries[i].key != EMPTY && m_entries[i].key != key)
+        i = (i + 1) & mask;
+    return i;
+}
+
+void ContactCache::grow()
+{
+    const size_t capacity = m_entries.empty() ? 64 : m_entries.size() * 2;
+    m_scratch.swap(m_entries);
+    m_entries.assign(capacity, Entry{});
+    for (const Entry& e: m_scratch)
+        if (e.key != EMPTY)
+            m_entries[probe(e.key)] = e;
+    m_scratch.clear();
+}
+
+ContactCache::Entry& ContactCache::find_or_insert(const uint64_t key, bool& inserted)
+{
+    // Load factor stays at or below one half
+    if ((m_size + 1) * 2 > m_entries.size())
+        grow();
+
+    Entry& e = m_entries[probe(key)];
+    inserted = e.key == EMPTY;
+    if (inserted) {
+        e = Entry{};
+        e.key = key;
+        ++m_size;
+    }
+    return e;
+}
+
+void ContactCache::sync(const std::vector<ContactManifold>& dst)
+{
+    if (&dst == m_dst && dst.size() == m_dst_size)
+        return;
+
+    // Someone else filled dst, index what is in there
+    for (uint32_t i = 0; i < dst.size(); ++i) {
+        bool inserted;
+        Entry& e = find_or_insert(make_key(dst[i].bodyA, dst[i].bodyB), inserted);
+        e.step = m_step;
+        e.slot = i;
+        e.manifold = dst[i];
+    }
+    m_dst = &dst;
+    m_dst_size = dst.size();
+}
+
+void ContactCache::begin_step(const std::vector<ContactManifold>& solved)
+{
+    if (!m_entries.empty()) {
+        for (const ContactManifold& m: solved) {
+            Entry& e = m_entries[probe(make_key(m.bodyA, m.bodyB))];
+            if (e.key != EMPTY && e.step == m_step)
+                e.manifold = m;
+        }
+    }
+
+    ++m_step;
+    m_dst = nullptr;
+    m_dst_size = 0;
+    m_begun.clear();
+    m_persisted.clear();
+    m_ended.clear();
+}
+
+void ContactCache::merge(std::vector<ContactManifold>& dst, const ContactManifold& m)
+{
+    sync(dst);
+
+    bool inserted;
+    Entry& e = find_or_insert(make_key(m.bodyA, m.bodyB), inserted);
+    ContactManifold merged = m;
+
+    if (!inserted && e.step == m_step && e.slot < dst.size()) {
+        // Second manifold of the pair in this step, it replaces the first
+        carry_impulses(dst[e.slot], merged);
+        dst[e.slot] = merged;
+        e.manifold = merged;
+        return;
+    }
+
+    if (inserted) {
+        m_begun.push_back({m.bodyA, m.bodyB});
+    } else {
+        // Roles swapped means the normal flipped, old impulses do not apply
+        if (e.manifold.bodyA == m.bodyA)
+            carry_impulses(e.manifold, merged);
+        m_persisted.push_back({m.bodyA, m.bodyB});
+    }
+
+    e.step = m_step;
+    e.slot = static_cast<uint32_t>(dst.size());
+    e.manifold = merged;
+    dst.push_back(merged);
+    m_dst_size = dst.size();
+}
+
+void ContactCache::end_step()
+{
+    size_t removed = 0;
+    for (const Entry& e: m_entries) {
+        if (e.key != EMPTY && e.step != m_step) {
+            m_ended.push_back({e.manifold.bodyA, e.manifold.bodyB});
+            ++removed;
+        }
+    }
+    if (removed == 0)
+        return;
+
+    // Rebuild without the ended pairs, linear probing has no cheap erase
+    m_scratch.swap(m_entries);
+    m_entries.assign(m_scratch.size(), Entry{});
+    for (const Entry& e: m_scratch)
+        if (e.key != EMPTY && e.step == m_step)
+            m_entries[probe(e.key)] = e;
+    m_size -= removed;
+    m_scratch.clear();
+}
+
+void ContactCache::restore(const std::vector<ContactManifold>& manifolds, const size_t capacity)
+{
+    clear();
+    // Same capacity as the saved table, so pairs are probed and ended in
+    // the same order as they would have been in the original
+    size_t n = 64;
+    while (n < capacity || n < manifolds.size() * 2 + 2)
+        n *= 2;
+    m_entries.assign(n, Entry{});
+    for (uint32_t i = 0; i < manifolds.size(); ++i) {
+        bool inserted;
+        Entry& e = find_or_insert(make_key(manifolds[i].bodyA, manifolds[i].bodyB), inserted);
+        e.step = m_step;
+        e.slot = i;
+        e.manifold = manifolds[i];
+    }
+}
+
+void ContactCache::clear()
+{
+    m_entries.clear();
+    m_size = 0;
+    m_dst = nullptr;
+    m_dst_size = 0;
+    m_begun.clear();
+    m_persisted.clear();
+    m_ended.clear();
+}
@@ -0,0 +1,87 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#ifndef ENGINELOOP_CONTACT_CACHE_H
+#define ENGINELOOP_CONTACT_CACHE_H
+#include <cstdint>
+#include <vector>
+
+#include "contact_manifold.h"
+
+struct ContactPair {
+    BodyID bodyA;
+    BodyID bodyB;
+};
+
+// Contacts of every touching pair, kept from one step to the next.
+// Open addressing table (linear probing, power of two capacity) keyed by
+// the ordered pair of body ids. Each entry remembers the manifold of the
+// last step it was seen in, so the next step starts from the impulses the
+// solver ended with, matched point by point through the feature ids.
+//
+// Per step: begin_step -> merge for every new manifold -> end_step.
+// Pairs seen for the first time are reported by begun(), pairs touching
+// again by persisted() and pairs that stopped touching by ended().
+class ContactCache {
+public:
+    // Stores the solved impulses of last step's manifolds and opens a new
+    // step. The vector itself is left alone.
+    void begin_step(const std::vector<ContactManifold>& solved);
+
+    // Adds m to dst, or replaces the manifold of the same pair already
+    // added this step. Impulses carry over from the replaced manifold, or
+    // from the cache when the pair first shows up in this step.
+    void merge(std::vector<ContactManifold>& dst, const ContactManifold& m);
+
+    // Drops the pairs that were not merged since begin_step.
+    void end_step();
+
+    void clear();
+
+    // Puts the cache in the state end_step() left it in when manifolds
+    // were the result of that step, with a table of at least capacity
+    // entries. Used when a world is restored from a snapshot; the event
+    // lists start out empty.
+    void restore(const std::vector<ContactManifold>& manifolds, size_t capacity);
+
+    [[nodiscard]] size_t size() const { return m_size; }
+
+    [[nodiscard]] size_t capacity() const { return m_entries.size(); }
+
+    [[nodiscard]] const std::vector<ContactPair>& begun() const { return m_begun; }
+    [[nodiscard]] const std::vector<ContactPair>& persisted() const { return m_persisted; }
+    [[nodiscard]] const std::vector<ContactPair>& ended() const { return m_ended; }
+
+private:
+    static constexpr uint64_t EMPTY = UINT64_MAX;
+
+    struct Entry {
+        uint64_t key = EMPTY;
+        uint32_t step = 0;      // last step the pair was merged in
+        uint32_t slot = 0;      // index in the destination vector of that step
+        ContactManifold manifold;
+    };
+
+    static uint64_t make_key(BodyID a, BodyID b);
+    [[nodiscard]] size_t probe(uint64_t key) const;
+    Entry& find_or_insert(uint64_t key, bool& inserted);
+    void grow();
+    void sync(const std::vector<ContactManifold>& dst);
+
+    std::vector<Entry> m_entries;
+    std::vector<Entry> m_scratch;
+    size_t m_size = 0;
+    uint32_t m_step = 1;
+
+    // Destination vector as last seen by merge. Manifolds added to it
+    // from outside are indexed on the next merge.
+    const std::vector<ContactManifold>* m_dst = nullptr;
+    size_t m_dst_size = 0;
+
+    std::vector<ContactPair> m_begun;
+    std::vector<ContactPair> m_persisted;
+    std::vector<ContactPair> m_ended;
+};
+
+#endif //ENGINELOOP_CONTACT_CACHE_H
@@ -0,0 +1,1061 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#include "contact_solver.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <numeric>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "glm/glm.hpp"
+
+#include "thread_pool.h"
+
+// Static and kinematic bodies are not moved by contact impulses.
+static float solver_inv_mass(const Body& b)
+{
+    return (b.type == BodyType::Dynamic) ? b.invMass : 0.0f;
+}
+
+static void apply_impulse(std::vector<Body>& bodies, const SolverContact& c,
+                          const glm::vec2 P)
+{
+    if (c.invMassA > 0.0f)
+        bodies[c.indexA].velocity += P * c.invMassA;
+    if (c.invMassB > 0.0f)
+        bodies[c.indexB].velocity -= P * c.invMassB;
+}
+
+static void warm_start_range(std::vector<Body>& bodies,
+                             const SolverContact* first, const SolverContact* last)
+{
+    for (const SolverContact* c = first; c != last; ++c)
+        apply_impulse(bodies, *c, c->normal * c->Pn + c->tangent * c->Pt);
+}
+
+// Squared change of relative velocity caused by the impulse (dPn, dPt).
+// Normal and tangent are perpendicular, so the lengths add up squared.
+static float velocity_error_sq(const float dPn, const float dPt, const float invMassSum)
+{
+    return (dPn * dPn + dPt * dPt) * invMassSum * invMassSum;
+}
+
+static void add_error(IterationError& e, const float errorSq)
+{
+    e.maxSq = std::max(e.maxSq, errorSq);
+    e.sumSq += errorSq;
+}
+
+static IterationError solve_velocity_range(std::vector<Body>& bodies,
+                                           SolverContact* first, SolverContact* last)
+{
+    IterationError error;
+    for (SolverContact* it = first; it != last; ++it) {
+        SolverContact& c = *it;
+        const Body& A = bodies[c.indexA];
+        const Body& B = bodies[c.indexB];
+
+        // --- NORMAL ---
+        const float vn = glm::dot(A.velocity - B.velocity, c.normal);
+        float dPn = c.normalMass * (c.bias - vn);
+        const float Pn0 = c.Pn;
+        c.Pn = std::max(Pn0 + dPn, 0.0f);
+        dPn = c.Pn - Pn0;
+        apply_impulse(bodies, c, c.normal * dPn);
+
+        // --- TANGENT (Coulomb friction, bounded by the normal impulse) ---
+        const float vt = glm::dot(A.velocity - B.velocity, c.tangent);
+        float dPt = -c.tangentMass * vt;
+        const float maxPt = c.friction * c.Pn;
+        const float Pt0 = c.Pt;
+        c.Pt = std::clamp(Pt0 + dPt, -maxPt, maxPt);
+        dPt = c.Pt - Pt0;
+        apply_impulse(bodies, c, c.tangent * dPt);
+
+        add_error(error, velocity_error_sq(dPn, dPt, c.invMassA + c.invMassB));
+    }
+    return error;
+}
+
+void ContactSolver::prepare(const std::vector<Body>& bodies,
+                            const std::vector<ContactManifold>& manifolds,
+                            const SolverSettings& settings,
+                            const float restitution)
+{
+    m_contacts.clear();
+    m_stats = SolverStats{};
+
+    m_body_index.clear();
+    m_body_index.reserve(bodies.size());
+    for (uint32_t i = 0; i < bodies.size(); ++i)
+        m_body_index.emplace(bodies[i].id, i);
+
+    for (uint32_t mi = 0; mi < manifolds.size(); ++mi) {
+        const ContactManifold& m = manifolds[mi];
+        if (m.pointCount == 0)
+            continue;
+
+        const auto itA = m_body_index.find(m.bodyA);
+        const auto itB = m_body_index.find(m.bodyB);
+        if (itA == m_body_index.end() || itB == m_body_index.end())
+            continue;
+
+        const Body& A = bodies[itA->second];
+        const Body& B = bodies[itB->second];
+
+        const float invMassA = solver_inv_mass(A);
+        const float invMassB = solver_inv_mass(B);
+        const float invMassSum = invMassA + invMassB;
+        if (invMassSum <= 0.0f)
+            continue;
+
+        for (int pi = 0; pi < m.pointCount; ++pi) {
+            const ContactPoint& cp = m.points[pi];
+
+            SolverContact c{};
+            c.indexA = itA->second;
+            c.indexB = itB->second;
+            c.invMassA = invMassA;
+            c.invMassB = invMassB;
+            c.normal = cp.normal;
+            c.tangent = {-cp.normal.y, cp.normal.x};
+            // No rotation in this engine, so both rows share the same mass.
+            c.normalMass = 1.0f / invMassSum;
+            c.tangentMass = c.normalMass;
+            c.friction = settings.friction;
+            c.Pn = cp.Pn;
+            c.Pt = cp.Pt;
+            c.penetration = cp.penetration;
+            c.originA = A.position;
+            c.originB = B.position;
+            c.manifold = mi;
+            c.point = static_cast<uint32_t>(pi);
+
+            const float vn = glm::dot(A.velocity - B.velocity, c.normal);
+            c.bias = (vn < -settings.restitutionThreshold) ? -restitution * vn : 0.0f;
+            c.normalVelocity0 = vn;
+
+            m_contacts.push_back(c);
+        }
+    }
+
+    build_islands(static_cast<uint32_t>(bodies.size()));
+
+    if (settings.mode == SolverMode::SoftStep) {
+        m_velocity0.resize(bodies.size());
+        for (size_t i = 0; i < bodies.size(); ++i)
+            m_velocity0[i] = bodies[i].velocity;
+    }
+
+    m_batches.clear();
+    const auto coloringMin = static_cast<uint32_t>(std::max(settings.coloringMinContacts, 1));
+    bool soaReady = false;
+    for (ContactIsland& island: m_islands) {
+        if (island.count < coloringMin)
+            continue;
+        if (!soaReady) {
+            m_body_colors.assign(bodies.size(), 0);
+            m_body_slot.resize(bodies.size());
+            m_soa.resize(m_contacts.size());
+            soaReady = true;
+        }
+        color_island(island);
+    }
+}
+
+// Union-find over body indices. Only dynamic bodies are linked, a static
+// wall touched by two piles must not merge them into one island.
+// Rows keep their relative order inside an island, so solving islands
+// one by one visits every body in the same order as a single serial pass.
+void ContactSolver::build_islands(const uint32_t bodyCount)
+{
+    m_islands.clear();
+    if (m_contacts.empty())
+        return;
+
+    m_parent.resize(bodyCount);
+    std::iota(m_parent.begin(), m_parent.end(), 0u);
+
+    auto find = [this](uint32_t x) {
+        while (m_parent[x] != x) {
+            m_parent[x] = m_parent[m_parent[x]];
+            x = m_parent[x];
+        }
+        return x;
+    };
+
+    for (const SolverContact& c: m_contacts) {
+        if (c.invMassA <= 0.0f || c.invMassB <= 0.0f)
+            continue;
+        const uint32_t ra = find(c.indexA);
+        const uint32_t rb = find(c.indexB);
+        if (ra != rb)
+            m_parent[std::max(ra, rb)] = std::min(ra, rb);
+    }
+
+    // Island ids in order of first appearance
+    m_island_of_root.assign(bodyCount, UINT32_MAX);
+    m_row_island.resize(m_contacts.size());
+    for (size_t i = 0; i < m_contacts.size(); ++i) {
+        const SolverContact& c = m_contacts[i];
+        const uint32_t root = find(c.invMassA > 0.0f ? c.indexA : c.indexB);
+        uint32_t& id = m_island_of_root[root];
+        if (id == UINT32_MAX) {
+            id = static_cast<uint32_t>(m_islands.size());
+            m_islands.push_back({0, 0});
+        }
+        m_row_island[i] = id;
+        ++m_islands[id].count;
+    }
+
+    // Dynamic bodies per island, in body order
+    m_body_island.assign(bodyCount, UINT32_MAX);
+    for (size_t i = 0; i < m_contacts.size(); ++i) {
+        const SolverContact& c = m_contacts[i];
+        const uint32_t id = m_row_island[i];
+        if (c.invMassA > 0.0f && m_body_island[c.indexA] == UINT32_MAX) {
+            m_body_island[c.indexA] = id;
+            ++m_islands[id].bodyCount;
+        }
+        if (c.invMassB > 0.0f && m_body_island[c.indexB] == UINT32_MAX) {
+            m_body_island[c.indexB] = id;
+            ++m_islands[id].bodyCount;
+        }
+    }
+    uint32_t bodyOffset = 0;
+    for (ContactIsland& island: m_islands) {
+        island.bodyBegin = bodyOffset;
+        bodyOffset += island.bodyCount;
+        island.bodyCount = 0;
+    }
+    m_island_bodies.resize(bodyOffset);
+    for (uint32_t b = 0; b < bodyCount; ++b) {
+        if (m_body_island[b] == UINT32_MAX)
+            continue;
+        ContactIsland& island = m_islands[m_body_island[b]];
+        m_island_bodies[island.bodyBegin + island.bodyCount++] = b;
+    }
+
+    // Counting sort of the rows by island
+    uint32_t offset = 0;
+    for (ContactIsland& island: m_islands) {
+        island.begin = offset;
+        offset += island.count;
+        island.count = 0;
+    }
+    m_sorted.resize(m_contacts.size());
+    for (size_t i = 0; i < m_contacts.size(); ++i) {
+        ContactIsland& island = m_islands[m_row_island[i]];
+        m_sorted[island.begin + island.count++] = m_contacts[i];
+    }
+    m_contacts.swap(m_sorted);
+
+    std::stable_sort(m_islands.begin(), m_islands.end(),
+                     [](const ContactIsland& a, const ContactIsland& b) {
+                         return a.count > b.count;
+                     });
+}
+
+void SolverRowsSoA::resize(const size_t n)
+{
+    slotA.resize(n);
+    slotB.resize(n);
+    invMassA.resize(n);
+    invMassB.resize(n);
+    nx.resize(n);
+    ny.resize(n);
+    normalMass.resize(n);
+    bias.resize(n);
+    friction.resize(n);
+    Pn.resize(n);
+    Pt.resize(n);
+    error.resize(n);
+    vx.resize(2 * n);
+    vy.resize(2 * n);
+    slotBody.resize(2 * n);
+}
+
+// Greedy colouring with one 64 bit colour mask per body. A row takes the
+// lowest colour that neither of its dynamic bodies uses yet. Static and
+// kinematic bodies are only read, they do not constrain the colouring.
+void ContactSolver::color_island(ContactIsland& island)
+{
+    constexpr uint32_t MAX_COLORS = 64;
+    uint32_t counts[MAX_COLORS + 1] = {};
+
+    SolverContact* rows = m_contacts.data() + island.begin;
+    m_row_color.resize(island.count);
+
+    for (uint32_t k = 0; k < island.count; ++k) {
+        const SolverContact& c = rows[k];
+        uint64_t used = 0;
+        if (c.invMassA > 0.0f) used |= m_body_colors[c.indexA];
+        if (c.invMassB > 0.0f) used |= m_body_colors[c.indexB];
+
+        const uint32_t color = (used == ~uint64_t{0})
+                                   ? MAX_COLORS
+                                   : static_cast<uint32_t>(std::countr_zero(~used));
+        if (color < MAX_COLORS) {
+            const uint64_t bit = uint64_t{1} << color;
+            if (c.invMassA > 0.0f) m_body_colors[c.indexA] |= bit;
+            if (c.invMassB > 0.0f) m_body_colors[c.indexB] |= bit;
+        }
+        m_row_color[k] = color;
+        ++counts[color];
+    }
+
+    for (uint32_t k = 0; k < island.count; ++k) {
+        m_body_colors[rows[k].indexA] = 0;
+        m_body_colors[rows[k].indexB] = 0;
+    }
+
+    // Counting sort by colour, one batch per used colour
+    uint32_t offsets[MAX_COLORS + 1];
+    uint32_t offset = 0;
+    island.batchBegin = static_cast<uint32_t>(m_batches.size());
+    for (uint32_t color = 0; color <= MAX_COLORS; ++color) {
+        offsets[color] = offset;
+        if (counts[color] == 0)
+            continue;
+        m_batches.push_back({island.begin + offset, counts[color], color == MAX_COLORS});
+        offset += counts[color];
+    }
+    island.batchCount = static_cast<uint32_t>(m_batches.size()) - island.batchBegin;
+
+    SolverContact* sorted = m_sorted.data() + island.begin;
+    for (uint32_t k = 0; k < island.count; ++k)
+        sorted[offsets[m_row_color[k]]++] = rows[k];
+    std::copy(sorted, sorted + island.count, rows);
+
+    // Every row side takes at most one slot, so 2 * count is enough
+    const uint32_t slotBegin = 2 * island.begin;
+    uint32_t slot = slotBegin;
+    for (uint32_t k = island.bodyBegin; k < island.bodyBegin + island.bodyCount; ++k) {
+        m_body_slot[m_island_bodies[k]] = slot;
+        m_soa.slotBody[slot++] = m_island_bodies[k];
+    }
+    auto slot_of = [&](const uint32_t body, const float invMass) {
+        if (invMass > 0.0f)
+            return m_body_slot[body];
+        m_soa.slotBody[slot] = body;
+        return slot++;
+    };
+
+    for (uint32_t k = island.begin; k < island.begin + island.count; ++k) {
+        const SolverContact& c = m_contacts[k];
+        m_soa.slotA[k] = slot_of(c.indexA, c.invMassA);
+        m_soa.slotB[k] = slot_of(c.indexB, c.invMassB);
+        m_soa.invMassA[k] = c.invMassA;
+        m_soa.invMassB[k] = c.invMassB;
+        m_soa.nx[k] = c.normal.x;
+        m_soa.ny[k] = c.normal.y;
+        m_soa.normalMass[k] = c.normalMass;
+        m_soa.bias[k] = c.bias;
+        m_soa.friction[k] = c.friction;
+        m_soa.Pn[k] = c.Pn;
+        m_soa.Pt[k] = c.Pt;
+    }
+    island.slotCount = slot - slotBegin;
+}
+
+// W rows of one colour starting at row i. The lanes read and write
+// velocity slots, rows of a batch never share one, so the scatter needs
+// no test for static sides. W = 1 is the plain sequential solver, used
+// for the tail and for the serial batch.
+template <int W>
+static void solve_block(SolverRowsSoA& s, const uint32_t i)
+{
+    float vax[W], vay[W], vbx[W], vby[W];
+    for (int l = 0; l < W; ++l) {
+        vax[l] = s.vx[s.slotA[i + l]]; vay[l] = s.vy[s.slotA[i + l]];
+        vbx[l] = s.vx[s.slotB[i + l]]; vby[l] = s.vy[s.slotB[i + l]];
+    }
+
+    for (int l = 0; l < W; ++l) {
+        const uint32_t r = i + l;
+        const float nx = s.nx[r];
+        const float ny = s.ny[r];
+        const float invA = s.invMassA[r];
+        const float invB = s.invMassB[r];
+
+        // --- NORMAL ---
+        const float vn = (vax[l] - vbx[l]) * nx + (vay[l] - vby[l]) * ny;
+        const float Pn0 = s.Pn[r];
+        const float Pn = std::max(Pn0 + s.normalMass[r] * (s.bias[r] - vn), 0.0f);
+        const float dPn = Pn - Pn0;
+        s.Pn[r] = Pn;
+        vax[l] += nx * dPn * invA; vay[l] += ny * dPn * invA;
+        vbx[l] -= nx * dPn * invB; vby[l] -= ny * dPn * invB;
+
+        // --- TANGENT ---
+        const float tx = -ny;
+        const float ty = nx;
+        const float vt = (vax[l] - vbx[l]) * tx + (vay[l] - vby[l]) * ty;
+        const float maxPt = s.friction[r] * Pn;
+        const float Pt0 = s.Pt[r];
+        const float Pt = std::clamp(Pt0 - s.normalMass[r] * vt, -maxPt, maxPt);
+        const float dPt = Pt - Pt0;
+        s.Pt[r] = Pt;
+        vax[l] += tx * dPt * invA; vay[l] += ty * dPt * invA;
+        vbx[l] -= tx * dPt * invB; vby[l] -= ty * dPt * invB;
+
+        s.error[r] = velocity_error_sq(dPn, dPt, invA + invB);
+    }
+
+    for (int l = 0; l < W; ++l) {
+        s.vx[s.slotA[i + l]] = vax[l]; s.vy[s.slotA[i + l]] = vay[l];
+        s.vx[s.slotB[i + l]] = vbx[l]; s.vy[s.slotB[i + l]] = vby[l];
+    }
+}
+
+#if defined(__AVX2__)
+// SSE and AVX2 registers behind one set of names, so the kernel below
+// is written once for 4 and 8 lanes.
+struct Lanes4 {
+    using V = __m128;
+    static constexpr int WIDTH = 4;
+    static V load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, const V v) { _mm_storeu_ps(p, v); }
+    static V gather(const float* base, const uint32_t* slots)
+    {
+        return _mm_i32gather_ps(base, _mm_loadu_si128(reinterpret_cast<const __m128i*>(slots)), 4);
+    }
+    static V set1(const float x) { return _mm_set1_ps(x); }
+    static V add(const V a, const V b) { return _mm_add_ps(a, b); }
+    static V sub(const V a, const V b) { return _mm_sub_ps(a, b); }
+    static V mul(const V a, const V b) { return _mm_mul_ps(a, b); }
+    static V min(const V a, const V b) { return _mm_min_ps(a, b); }
+    static V max(const V a, const V b) { return _mm_max_ps(a, b); }
+    static V bit_xor(const V a, const V b) { return _mm_xor_ps(a, b); }
+};
+
+struct Lanes8 {
+    using V = __m256;
+    static constexpr int WIDTH = 8;
+    static V load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, const V v) { _mm256_storeu_ps(p, v); }
+    static V gather(const float* base, const uint32_t* slots)
+    {
+        return _mm256_i32gather_ps(base, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(slots)), 4);
+    }
+    static V set1(const float x) { return _mm256_set1_ps(x); }
+    static V add(const V a, const V b) { return _mm256_add_ps(a, b); }
+    static V sub(const V a, const V b) { return _mm256_sub_ps(a, b); }
+    static V mul(const V a, const V b) { return _mm256_mul_ps(a, b); }
+    static V min(const V a, const V b) { return _mm256_min_ps(a, b); }
+    static V max(const V a, const V b) { return _mm256_max_ps(a, b); }
+    static V bit_xor(const V a, const V b) { return _mm256_xor_ps(a, b); }
+};
+
+// solve_block written out with intrinsics, operation by operation in
+// the same order. max(0, x) and max(lo, min(hi, x)) pick the same
+// operand as std::max(x, 0) and std::clamp for zeros and NaN, and the
+// negations only flip the sign bit, so a build with and without
+// ENGINE_AVX2 gives the same bits. There is no scatter in AVX2, the
+// slots are written back one by one.
+template <typename L>
+static void solve_block_avx2(SolverRowsSoA& s, const uint32_t i)
+{
+    using V = typename L::V;
+    constexpr int W = L::WIDTH;
+    const V zero = L::set1(0.0f);
+    const V sign = L::set1(-0.0f);
+
+    V vax = L::gather(s.vx.data(), s.slotA.data() + i);
+    V vay = L::gather(s.vy.data(), s.slotA.data() + i);
+    V vbx = L::gather(s.vx.data(), s.slotB.data() + i);
+    V vby = L::gather(s.vy.data(), s.slotB.data() + i);
+    const V nx = L::load(s.nx.data() + i);
+    const V ny = L::load(s.ny.data() + i);
+    const V invA = L::load(s.invMassA.data() + i);
+    const V invB = L::load(s.invMassB.data() + i);
+    const V normalMass = L::load(s.normalMass.data() + i);
+
+    // --- NORMAL ---
+    const V vn = L::add(L::mul(L::sub(vax, vbx), nx), L::mul(L::sub(vay, vby), ny));
+    const V Pn0 = L::load(s.Pn.data() + i);
+    const V Pn = L::max(zero, L::add(Pn0, L::mul(normalMass, L::sub(L::load(s.bias.data() + i), vn))));
+    const V dPn = L::sub(Pn, Pn0);
+    L::store(s.Pn.data() + i, Pn);
+    vax = L::add(vax, L::mul(L::mul(nx, dPn), invA));
+    vay = L::add(vay, L::mul(L::mul(ny, dPn), invA));
+    vbx = L::sub(vbx, L::mul(L::mul(nx, dPn), invB));
+    vby = L::sub(vby, L::mul(L::mul(ny, dPn), invB));
+
+    // --- TANGENT ---
+    const V tx = L::bit_xor(ny, sign);
+    const V ty = nx;
+    const V vt = L::add(L::mul(L::sub(vax, vbx), tx), L::mul(L::sub(vay, vby), ty));
+    const V maxPt = L::mul(L::load(s.friction.data() + i), Pn);
+    const V Pt0 = L::load(s.Pt.data() + i);
+    const V Pt = L::max(L::bit_xor(maxPt, sign),
+                        L::min(maxPt, L::sub(Pt0, L::mul(normalMass, vt))));
+    const V dPt = L::sub(Pt, Pt0);
+    L::store(s.Pt.data() + i, Pt);
+    vax = L::add(vax, L::mul(L::mul(tx, dPt), invA));
+    vay = L::add(vay, L::mul(L::mul(ty, dPt), invA));
+    vbx = L::sub(vbx, L::mul(L::mul(tx, dPt), invB));
+    vby = L::sub(vby, L::mul(L::mul(ty, dPt), invB));
+
+    const V sum = L::add(invA, invB);
+    const V error = L::mul(L::mul(L::add(L::mul(dPn, dPn), L::mul(dPt, dPt)), sum), sum);
+    L::store(s.error.data() + i, error);
+
+    alignas(32) float lanes[4][W];
+    L::store(lanes[0], vax);
+    L::store(lanes[1], vay);
+    L::store(lanes[2], vbx);
+    L::store(lanes[3], vby);
+    for (int l = 0; l < W; ++l) {
+        s.vx[s.slotA[i + l]] = lanes[0][l]; s.vy[s.slotA[i + l]] = lanes[1][l];
+        s.vx[s.slotB[i + l]] = lanes[2][l]; s.vy[s.slotB[i + l]] = lanes[3][l];
+    }
+}
+#endif
+
+template <int W>
+static void solve_lanes(SolverRowsSoA& s, const uint32_t begin, const uint32_t end)
+{
+    uint32_t i = begin;
+    for (; i + W <= end; i += W) {
+#if defined(__AVX2__)
+        if constexpr (W == 4) {
+            solve_block_avx2<Lanes4>(s, i);
+        } else if constexpr (W == 8) {
+            solve_block_avx2<Lanes8>(s, i);
+        } else if constexpr (W == 16) {
+            solve_block_avx2<Lanes8>(s, i);
+            solve_block_avx2<Lanes8>(s, i + 8);
+        } else {
+            solve_block<W>(s, i);
+        }
+#else
+        solve_block<W>(s, i);
+#endif
+    }
+    for (; i < end; ++i)
+        solve_block<1>(s, i);
+}
+
+static void solve_batch_range(const int lanes, SolverRowsSoA& s,
+                              const uint32_t begin, const uint32_t end)
+{
+    switch (lanes) {
+        case 4:  solve_lanes<4>(s, begin, end); break;
+        case 16: solve_lanes<16>(s, begin, end); break;
+        default: solve_lanes<8>(s, begin, end); break;
+    }
+}
+
+// Chunks are a multiple of the widest lane count
+static uint32_t batch_chunk_rows(const SolverSettings& settings)
+{
+    return (static_cast<uint32_t>(std::max(settings.batchChunkRows, 16)) + 15u) & ~15u;
+}
+
+// fn(begin, end, serial) over the rows of a coloured island, batch after
+// batch. Rows of a batch share no dynamic body, so a batch split into
+// chunks across the pool gives the same result as one pass in row order.
+template <typename Fn>
+void ContactSolver::for_each_batch_range(const ContactIsland& island,
+                                         const SolverSettings& settings,
+                                         ThreadPool* pool, Fn&& fn) const
+{
+    const uint32_t chunk = batch_chunk_rows(settings);
+    for (uint32_t bi = island.batchBegin; bi < island.batchBegin + island.batchCount; ++bi) {
+        const ColorBatch& batch = m_batches[bi];
+        const uint32_t end = batch.begin + batch.count;
+
+        if (pool && !batch.serial && batch.count > chunk) {
+            const uint32_t tasks = (batch.count + chunk - 1) / chunk;
+            pool->parallel_for(tasks, [&](const uint32_t t) {
+                const uint32_t b = batch.begin + t * chunk;
+                fn(b, std::min(b + chunk, end), false);
+            });
+            continue;
+        }
+
+        fn(batch.begin, end, batch.serial);
+    }
+}
+
+// Returns the number of iterations run. The island's velocities are
+// gathered into the slots once and written back at the end. Lanes write
+// their row errors to the SoA, they are summed up per iteration in row
+// order.
+int ContactSolver::solve_colored(std::vector<Body>& bodies,
+                                 const ContactIsland& island,
+                                 const SolverSettings& settings,
+                                 ThreadPool* pool, IterationError* errors)
+{
+    SolverContact* first = m_contacts.data() + island.begin;
+    SolverContact* last = first + island.count;
+    warm_start_range(bodies, first, last);
+
+    const uint32_t slotBegin = 2 * island.begin;
+    for (uint32_t k = slotBegin; k < slotBegin + island.slotCount; ++k) {
+        const glm::vec2 v = bodies[m_soa.slotBody[k]].velocity;
+        m_soa.vx[k] = v.x;
+        m_soa.vy[k] = v.y;
+    }
+
+    const float toleranceSq = settings.velocityTolerance * settings.velocityTolerance;
+    int it = 0;
+    while (it < settings.velocityIterations) {
+        for_each_batch_range(island, settings, pool,
+                             [&](const uint32_t begin, const uint32_t end, const bool serial) {
+            if (serial)
+                solve_lanes<1>(m_soa, begin, end);
+            else
+                solve_batch_range(settings.simdLanes, m_soa, begin, end);
+        });
+
+        IterationError& error = errors[it++];
+        error = IterationError{};
+        for (uint32_t k = island.begin; k < island.begin + island.count; ++k)
+            add_error(error, m_soa.error[k]);
+        if (error.maxSq < toleranceSq)
+            break;
+    }
+
+    // Dynamic bodies come first, the other slots are only read
+    for (uint32_t k = slotBegin; k < slotBegin + island.bodyCount; ++k)
+        bodies[m_soa.slotBody[k]].velocity = {m_soa.vx[k], m_soa.vy[k]};
+
+    for (uint32_t k = island.begin; k < island.begin + island.count; ++k) {
+        m_contacts[k].Pn = m_soa.Pn[k];
+        m_contacts[k].Pt = m_soa.Pt[k];
+    }
+    return it;
+}
+
+template <typename Fn>
+void ContactSolver::for_each_island(const SolverSettings& settings,
+                                    ThreadPool* pool, Fn&& fn) const
+{
+    const auto count = static_cast<uint32_t>(m_islands.size());
+    if (pool && count > 1 &&
+        m_contacts.size() >= static_cast<size_t>(settings.parallelMinContacts)) {
+        pool->parallel_for(count, [&](const uint32_t i) { fn(m_islands[i]); });
+        return;
+    }
+    for (const ContactIsland& island: m_islands)
+        fn(island);
+}
+
+// Every island owns its slice of the error table, so islands running on
+// different threads never write to the same place.
+IterationError* ContactSolver::begin_stats(const int iterations)
+{
+    m_island_errors.assign(m_islands.size() * static_cast<size_t>(iterations), IterationError{});
+    m_island_iterations.assign(m_islands.size(), 0);
+    return m_island_errors.data();
+}
+
+// Islands are reduced in a fixed order, the numbers do not depend on how
+// the islands were spread over threads.
+void ContactSolver::finish_stats(const int iterations)
+{
+    m_stats.rows = static_cast<uint32_t>(m_contacts.size());
+    m_stats.islands = static_cast<uint32_t>(m_islands.size());
+    m_stats.iterations = 0;
+    m_stats.islandsConverged = 0;
+    for (const int n: m_island_iterations) {
+        m_stats.iterations = std::max(m_stats.iterations, n);
+        if (n < iterations)
+            ++m_stats.islandsConverged;
+    }
+
+    const auto ran = static_cast<size_t>(m_stats.iterations);
+    m_stats.maxVelocityError.assign(ran, 0.0f);
+    m_stats.rmsVelocityError.assign(ran, 0.0f);
+    for (size_t i = 0; i < m_islands.size(); ++i) {
+        const int n = m_island_iterations[i];
+        if (n == 0)
+            continue;
+        const IterationError* errors = m_island_errors.data() + i * static_cast<size_t>(iterations);
+        for (size_t it = 0; it < ran; ++it) {
+            const IterationError& e = errors[std::min(it, static_cast<size_t>(n - 1))];
+            m_stats.maxVelocityError[it] = std::max(m_stats.maxVelocityError[it], e.maxSq);
+            m_stats.rmsVelocityError[it] += e.sumSq;
+        }
+    }
+    const float invRows = m_contacts.empty() ? 0.0f : 1.0f / static_cast<float>(m_contacts.size());
+    for (size_t it = 0; it < ran; ++it) {
+        m_stats.maxVelocityError[it] = std::sqrt(m_stats.maxVelocityError[it]);
+        m_stats.rmsVelocityError[it] = std::sqrt(m_stats.rmsVelocityError[it] * invRows);
+    }
+
+    m_stats.normalImpulse = 0.0f;
+    m_stats.tangentImpulse = 0.0f;
+    for (const SolverContact& c: m_contacts) {
+        m_stats.normalImpulse += c.Pn;
+        m_stats.tangentImpulse += std::abs(c.Pt);
+    }
+}
+
+void ContactSolver::solve(std::vector<Body>& bodies,
+                          const SolverSettings& settings, ThreadPool* pool)
+{
+    const int iterations = std::max(settings.velocityIterations, 0);
+    const float toleranceSq = settings.velocityTolerance * settings.velocityTolerance;
+    IterationError* table = begin_stats(iterations);
+
+    for_each_island(settings, pool, [&](const ContactIsland& island) {
+        const auto islandIndex = static_cast<size_t>(&island - m_islands.data());
+        IterationError* errors = table + islandIndex * static_cast<size_t>(iterations);
+
+        if (island.batchCount > 0) {
+            m_island_iterations[islandIndex] = solve_colored(bodies, island, settings, pool, errors);
+            return;
+        }
+
+        SolverContact* first = m_contacts.data() + island.begin;
+        SolverContact* last = first + island.count;
+
+        warm_start_range(bodies, first, last);
+        int it = 0;
+        while (it < iterations) {
+            errors[it] = solve_velocity_range(bodies, first, last);
+            if (errors[it++].maxSq < toleranceSq)
+                break;
+        }
+        m_island_iterations[islandIndex] = it;
+    });
+
+    finish_stats(iterations);
+}
+
+// Soft contact constraint as a damped spring (Box2D v3 style)
+struct Softness {
+    float biasRate;
+    float massScale;
+    float impulseScale;
+};
+
+static Softness make_soft(const float hertz, const float zeta, const float h)
+{
+    if (hertz <= 0.0f)
+        return {0.0f, 1.0f, 0.0f};
+
+    const float omega = 2.0f * 3.14159265f * hertz;
+    const float a1 = 2.0f * zeta + h * omega;
+    const float a2 = h * omega * a1;
+    const float a3 = 1.0f / (1.0f + a2);
+    return {omega / a1, a2 * a3, a3};
+}
+
+// One soft iteration. useBias = false is the relax pass: it removes the
+// velocity the spring added so bodies do not fly apart after overlap.
+//
+// Bodies were integrated over the whole step before the contacts were
+// found, so the tracked position runs ahead of a substepped integration
+// by v0 * remaining. Taking that back gives the separation a substepped
+// integrator would see at this point of the step.
+// rowErrors, if given, receives the squared error of every row.
+static IterationError solve_soft_range(std::vector<Body>& bodies,
+                                       SolverContact* first, SolverContact* last,
+                                       const Softness& soft, const float invH,
+                                       const float remaining,
+                                       const float maxPushout, const bool useBias,
+                                       float* rowErrors = nullptr)
+{
+    IterationError error;
+    for (SolverContact* it = first; it != last; ++it) {
+        SolverContact& c = *it;
+        const Body& A = bodies[c.indexA];
+        const Body& B = bodies[c.indexB];
+
+        // Current separation, negative while overlapping
+        const glm::vec2 d = (A.position - c.originA) - (B.position - c.originB);
+        const float s = glm::dot(d, c.normal) - c.penetration
+                        - c.normalVelocity0 * remaining;
+
+        float bias = 0.0f;
+        float massScale = 1.0f;
+        float impulseScale = 0.0f;
+        if (s > 0.0f) {
+            // Speculative: allow closing until touching
+            bias = s * invH;
+        } else if (useBias) {
+            bias = std::max(soft.biasRate * s, -maxPushout);
+            massScale = soft.massScale;
+            impulseScale = soft.impulseScale;
+        }
+
+        // --- NORMAL ---
+        const float vn = glm::dot(A.velocity - B.velocity, c.normal);
+        float dPn = -c.normalMass * massScale * (vn + bias) - impulseScale * c.Pn;
+        const float Pn0 = c.Pn;
+        c.Pn = std::max(Pn0 + dPn, 0.0f);
+        dPn = c.Pn - Pn0;
+        apply_impulse(bodies, c, c.normal * dPn);
+
+        // --- TANGENT ---
+        const float vt = glm::dot(A.velocity - B.velocity, c.tangent);
+        float dPt = -c.tangentMass * vt;
+        const float maxPt = c.friction * c.Pn;
+        const float Pt0 = c.Pt;
+        c.Pt = std::clamp(Pt0 + dPt, -maxPt, maxPt);
+        dPt = c.Pt - Pt0;
+        apply_impulse(bodies, c, c.tangent * dPt);
+
+        const float errorSq = velocity_error_sq(dPn, dPt, c.invMassA + c.invMassB);
+        add_error(error, errorSq);
+        if (rowErrors)
+            rowErrors[it - first] = errorSq;
+    }
+    return error;
+}
+
+// Positions were already advanced with the pre-solve velocity for the
+// whole step, each substep adds the part that the contacts changed.
+static void integrate_substep(std::vector<Body>& bodies,
+                              const std::vector<glm::vec2>& velocity0,
+                              const uint32_t* first, const uint32_t* last,
+                              const float h)
+{
+    for (const uint32_t* b = first; b != last; ++b) {
+        Body& body = bodies[*b];
+        body.position += (body.velocity - velocity0[*b]) * h;
+    }
+}
+
+// Coloured islands run their soft rows batch by batch on the bodies, the
+// lane kernel only knows the rigid rows. Restitution and the position
+// update stay on the island's thread.
+void ContactSolver::solve_soft(std::vector<Body>& bodies,
+                               const SolverSettings& settings,
+                               const float dt, ThreadPool* pool)
+{
+    const int substeps = std::max(settings.substeps, 1);
+    const float h = dt / static_cast<float>(substeps);
+    const float invH = 1.0f / h;
+    const float hertz = std::min(settings.contactHertz, 0.25f * invH);
+    const Softness soft = make_soft(hertz, settings.contactDampingRatio, h);
+    IterationError* table = begin_stats(substeps);
+
+    // Substeps advance the positions, there is no early exit here
+    for_each_island(settings, pool, [&](const ContactIsland& island) {
+        const auto islandIndex = static_cast<size_t>(&island - m_islands.data());
+        IterationError* errors = table + islandIndex * static_cast<size_t>(substeps);
+        SolverContact* first = m_contacts.data() + island.begin;
+        SolverContact* last = first + island.count;
+        const uint32_t* bodyFirst = m_island_bodies.data() + island.bodyBegin;
+        const uint32_t* bodyLast = bodyFirst + island.bodyCount;
+
+        auto pass = [&](const float remaining, const bool useBias) {
+            if (island.batchCount == 0)
+                return solve_soft_range(bodies, first, last, soft, invH, remaining,
+                                        settings.maxPushoutVelocity, useBias);
+
+            for_each_batch_range(island, settings, pool,
+                                 [&](const uint32_t begin, const uint32_t end, bool) {
+                solve_soft_range(bodies, m_contacts.data() + begin, m_contacts.data() + end,
+                                 soft, invH, remaining, settings.maxPushoutVelocity, useBias,
+                                 m_soa.error.data() + begin);
+            });
+            IterationError error;
+            for (uint32_t k = island.begin; k < island.begin + island.count; ++k)
+                add_error(error, m_soa.error[k]);
+            return error;
+        };
+
+        warm_start_range(bodies, first, last);
+
+        for (int i = 0; i < substeps; ++i) {
+            const float remaining = dt - static_cast<float>(i) * h;
+            errors[i] = pass(remaining, true);
+            integrate_substep(bodies, m_velocity0, bodyFirst, bodyLast, h);
+            pass(remaining - h, false);
+        }
+
+        // Restitution once at the end, from the approach speed at prepare
+        for (SolverContact* c = first; c != last; ++c) {
+            if (c->bias <= 0.0f || c->Pn <= 0.0f)
+                continue;
+            const float vn = glm::dot(bodies[c->indexA].velocity - bodies[c->indexB].velocity,
+                                      c->normal);
+            const float Pn0 = c->Pn;
+            c->Pn = std::max(Pn0 + c->normalMass * (c->bias - vn), 0.0f);
+            apply_impulse(bodies, *c, c->normal * (c->Pn - Pn0));
+        }
+        m_island_iterations[islandIndex] = substeps;
+    });
+
+    finish_stats(substeps);
+}
+
+// Sequential impulses on the pseudo velocities. Every row asks for a
+// relative normal pseudo velocity that removes its overlap in one step
+// (capped by maxLinearCorrection), shared between both bodies by their
+// inverse mass. The accumulated impulse of a row stays >= 0, so the
+// second point of a manifold and the rows of a stack do not add up to
+// more than the overlap.
+static void solve_pseudo_range(std::vector<Body>& bodies, const SolverContact* contacts,
+                               float* pseudoImpulse, const uint32_t begin, const uint32_t end,
+                               const float dt, const float maxCorrection)
+{
+    for (uint32_t i = begin; i < end; ++i) {
+        const SolverContact& c = contacts[i];
+        const float overlap = std::min(c.penetration, maxCorrection);
+        if (overlap <= 0.0f)
+            continue;
+
+        Body& A = bodies[c.indexA];
+        Body& B = bodies[c.indexB];
+        const float vn = glm::dot(A.pseudoVelocity - B.pseudoVelocity, c.normal);
+        float& P = pseudoImpulse[i];
+        const float P0 = P;
+        P = std::max(P0 + c.normalMass * (overlap / dt - vn), 0.0f);
+        const glm::vec2 impulse = c.normal * (P - P0);
+        if (c.invMassA > 0.0f)
+            A.pseudoVelocity += impulse * c.invMassA;
+        if (c.invMassB > 0.0f)
+            B.pseudoVelocity -= impulse * c.invMassB;
+    }
+}
+
+void ContactSolver::solve_split_impulse(std::vector<Body>& bodies,
+                                        const float dt,
+                                        const SolverSettings& settings,
+                                        ThreadPool* pool)
+{
+    const int iterations = std::max(settings.positionIterations, 1);
+    m_pseudo_impulse.assign(m_contacts.size(), 0.0f);
+
+    for_each_island(settings, pool, [&](const ContactIsland& island) {
+        for (int it = 0; it < iterations; ++it) {
+            if (island.batchCount == 0) {
+                solve_pseudo_range(bodies, m_contacts.data(), m_pseudo_impulse.data(),
+                                   island.begin, island.begin + island.count,
+                                   dt, settings.maxLinearCorrection);
+                continue;
+            }
+            for_each_batch_range(island, settings, pool,
+                                 [&](const uint32_t begin, const uint32_t end, bool) {
+                solve_pseudo_range(bodies, m_contacts.data(), m_pseudo_impulse.data(),
+                                   begin, end, dt, settings.maxLinearCorrection);
+            });
+        }
+    });
+}
+
+// Non-linear Gauss-Seidel (Box2D v2 style position solver). The overlap is
+// taken from the current positions, so every row sees the corrections of
+// the rows before it. No Baumgarte factor: a row removes all of its
+// overlap beyond the slop at once, only capped by maxCorrection.
+// Returns the smallest separation seen, negative while overlapping.
+// rowSeparation, if given, receives the separation of every row.
+static float solve_position_range(std::vector<Body>& bodies,
+                                  const SolverContact* first, const SolverContact* last,
+                                  const float slop, const float maxCorrection,
+                                  float* rowSeparation = nullptr)
+{
+    float minSeparation = 0.0f;
+    for (const SolverContact* c = first; c != last; ++c) {
+        Body& A = bodies[c->indexA];
+        Body& B = bodies[c->indexB];
+
+        const glm::vec2 d = (A.position - c->originA) - (B.position - c->originB);
+        const float separation = glm::dot(d, c->normal) - c->penetration;
+        minSeparation = std::min(minSeparation, separation);
+        if (rowSeparation)
+            rowSeparation[c - first] = separation;
+
+        const float C = std::clamp(separation + slop, -maxCorrection, 0.0f);
+        const float P = -c->normalMass * C;
+        if (c->invMassA > 0.0f)
+            A.position += c->normal * (P * c->invMassA);
+        if (c->invMassB > 0.0f)
+            B.position -= c->normal * (P * c->invMassB);
+    }
+    return minSeparation;
+}
+
+void ContactSolver::solve_positions(std::vector<Body>& bodies,
+                                    const SolverSettings& settings,
+                                    ThreadPool* pool)
+{
+    const int iterations = std::max(settings.positionIterations, 0);
+    // Same stop rule as Box2D: a little more overlap than the slop is fine
+    const float stopSeparation = -3.0f * settings.linearSlop;
+    m_island_iterations.assign(m_islands.size(), 0);
+
+    for_each_island(settings, pool, [&](const ContactIsland& island) {
+        const auto islandIndex = static_cast<size_t>(&island - m_islands.data());
+        const SolverContact* first = m_contacts.data() + island.begin;
+        const SolverContact* last = first + island.count;
+
+        auto pass = [&] {
+            if (island.batchCount == 0)
+                return solve_position_range(bodies, first, last, settings.linearSlop,
+                                            settings.maxLinearCorrection);
+
+            for_each_batch_range(island, settings, pool,
+                                 [&](const uint32_t begin, const uint32_t end, bool) {
+                solve_position_range(bodies, m_contacts.data() + begin, m_contacts.data() + end,
+                                     settings.linearSlop, settings.maxLinearCorrection,
+                                     m_soa.error.data() + begin);
+            });
+            float minSeparation = 0.0f;
+            for (uint32_t k = island.begin; k < island.begin + island.count; ++k)
+                minSeparation = std::min(minSeparation, m_soa.error[k]);
+            return minSeparation;
+        };
+
+        int it = 0;
+        while (it < iterations) {
+            ++it;
+            if (pass() >= stopSeparation)
+                break;
+        }
+        m_island_iterations[islandIndex] = it;
+    });
+
+    m_stats.positionIterations = 0;
+    for (const int n: m_island_iterations)
+        m_stats.positionIterations = std::max(m_stats.positionIterations, n);
+}
+
+// Separation is tracked from the positions at prepare time, like the
+// soft solver does while substepping.
+void ContactSolver::measure_penetration(const std::vector<Body>& bodies)
+{
+    float maxPen = 0.0f;
+    float sumSq = 0.0f;
+    for (const SolverContact& c: m_contacts) {
+        const glm::vec2 d = (bodies[c.indexA].position - c.originA)
+                          - (bodies[c.indexB].position - c.originB);
+        const float pen = std::max(c.penetration - glm::dot(d, c.normal), 0.0f);
+        maxPen = std::max(maxPen, pen);
+        sumSq += pen * pen;
+    }
+    m_stats.maxPenetration = maxPen;
+    m_stats.rmsPenetration = m_contacts.empty()
+        ? 0.0f : std::sqrt(sumSq / static_cast<float>(m_contacts.size()));
+}
+
+void ContactSolver::warm_start(std::vector<Body>& bodies) const
+{
+    warm_start_range(bodies, m_contacts.data(), m_contacts.data() + m_contacts.size());
+}
+
+void ContactSolver::solve_velocities(std::vector<Body>& bodies)
+{
+    solve_velocity_range(bodies, m_contacts.data(), m_contacts.data() + m_contacts.size());
+}
+
+void ContactSolver::store_impulses(std::vector<ContactManifold>& manifolds) const
+{
+    for (const SolverContact& c: m_contacts) {
+        ContactPoint& cp = manifolds[c.manifold].points[c.point];
+        cp.Pn = c.Pn;
+        cp.Pt = c.Pt;
+    }
+}
@@ -0,0 +1,266 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#ifndef ENGINELOOP_CONTACT_SOLVER_H
+#define ENGINELOOP_CONTACT_SOLVER_H
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "body.h"
+#include "contact_manifold.h"
+
+class ThreadPool;
+
+enum class SolverMode {
+    // velocityIterations full iterations, then split impulse position fix
+    SplitImpulse,
+    // fixed_step split into substeps, one soft iteration plus one relax
+    // iteration each; positions follow the solved velocities
+    SoftStep
+};
+
+// Position correction after the velocity solve in SolverMode::SplitImpulse
+enum class PositionSolver {
+    // pseudo velocities solved like impulses over all rows, moving both
+    // bodies by their inverse mass; positions follow in integrate_pseudo
+    SplitImpulse,
+    // positionIterations passes over all rows moving both bodies,
+    // overlap recomputed from the current positions every time
+    NonLinearGaussSeidel
+};
+
+struct SolverSettings {
+    SolverMode mode = SolverMode::SplitImpulse;
+    int velocityIterations = 8;
+    // An island stops iterating once no row changed the relative velocity
+    // by more than this (m/s) in one iteration. 0 runs every iteration.
+    float velocityTolerance = 1e-4f;
+    float friction = 0.5f;
+    // Closing speeds below this do not bounce, resting contacts stay quiet.
+    float restitutionThreshold = 1.0f;
+    // Below this many rows islands are solved on the calling thread,
+    // handing them to the pool would cost more than it saves.
+    int parallelMinContacts = 64;
+    // Islands with at least this many rows are graph coloured and solved
+    // batch by batch, a fixed number of independent rows at a time,
+    // instead of one row after the other.
+    int coloringMinContacts = 256;
+    // Rows per pass of the batched velocity kernel: 4, 8 or 16. With
+    // ENGINE_AVX2 these are SSE/AVX2 gathers, otherwise a portable lane
+    // loop with the same bits. See the contacts/pile bench entries.
+    int simdLanes = 8;
+    // Rows per task when a batch is split across the pool.
+    int batchChunkRows = 512;
+
+    // --- SplitImpulse mode: position correction ---
+    PositionSolver positionSolver = PositionSolver::SplitImpulse;
+    // Passes of either position solver.
+    int positionIterations = 4;
+    // Overlap that is left alone, keeps resting contacts touching.
+    float linearSlop = 0.005f;
+    // Largest push a row may apply in one position iteration.
+    float maxLinearCorrection = 0.2f;
+
+    // --- SoftStep only ---
+    int substeps = 4;
+    // Stiffness and damping ratio of the contact spring. The stiffness
+    // is capped at a quarter of the substep rate to stay stable.
+    float contactHertz = 30.0f;
+    float contactDampingRatio = 10.0f;
+    // Upper bound of the velocity used to push overlapping bodies apart.
+    float maxPushoutVelocity = 3.0f;
+};
+
+// One contact point turned into a normal row and a tangent row.
+// Everything that does not change between iterations is computed once
+// in prepare(), the iterations only read it back.
+struct SolverContact {
+    uint32_t indexA;        // index into the body array
+    uint32_t indexB;
+    float invMassA;         // 0 for static and kinematic bodies
+    float invMassB;
+    glm::vec2 normal;       // points from B towards A
+    glm::vec2 tangent;
+    float normalMass;       // 1 / (invMassA + invMassB)
+    float tangentMass;
+    float bias;             // restitution target velocity
+    float penetration;      // overlap at prepare time
+    float normalVelocity0;  // relative normal velocity at prepare time
+    glm::vec2 originA;      // body positions at prepare time, used to
+    glm::vec2 originB;      // track the overlap while substepping
+    float friction;
+    float Pn;               // accumulated normal impulse
+    float Pt;               // accumulated tangent impulse
+    uint32_t manifold;      // write-back location of the impulses
+    uint32_t point;
+};
+
+// Connected component of dynamic bodies linked by contacts.
+// Its rows are stored contiguously in the solver array.
+struct ContactIsland {
+    uint32_t begin;
+    uint32_t count;
+    uint32_t bodyBegin = 0;     // dynamic bodies of the island
+    uint32_t bodyCount = 0;
+    uint32_t batchBegin = 0;    // colour batches, only for large islands
+    uint32_t batchCount = 0;
+    uint32_t slotCount = 0;     // velocity slots from 2 * begin on
+};
+
+// Rows of one colour: no two of them share a dynamic body, so all of them
+// can be solved at the same time. Rows that did not fit into the colour
+// budget end up in a serial batch.
+struct ColorBatch {
+    uint32_t begin;
+    uint32_t count;
+    bool serial;
+};
+
+// Structure of arrays copy of the rows of coloured islands,
+// indexed like the solver array. The velocity kernel works on slots
+// instead of bodies: an island gathers the velocities of its dynamic
+// bodies into vx/vy, followed by one private slot per static or
+// kinematic row side, so no two rows of a batch share a slot.
+struct SolverRowsSoA {
+    std::vector<uint32_t> slotA;
+    std::vector<uint32_t> slotB;
+    std::vector<float> invMassA;
+    std::vector<float> invMassB;
+    std::vector<float> nx;
+    std::vector<float> ny;
+    std::vector<float> normalMass;
+    std::vector<float> bias;
+    std::vector<float> friction;
+    std::vector<float> Pn;
+    std::vector<float> Pt;
+    // Per row result of the last pass: squared velocity change, or the
+    // separation in the position solver
+    std::vector<float> error;
+
+    std::vector<float> vx;      // 2 slots per row
+    std::vector<float> vy;
+    std::vector<uint32_t> slotBody;
+
+    void resize(size_t n);
+};
+
+// Squared velocity errors of one iteration over a range of rows.
+struct IterationError {
+    float maxSq = 0.0f;
+    float sumSq = 0.0f;
+};
+
+// What the solver did in the last step. Velocity errors are the change
+// of relative velocity a row received in an iteration, i.e. how far it
+// was from being satisfied before that iteration. An island that stopped
+// early keeps contributing its last error to the later iterations.
+struct SolverStats {
+    uint32_t rows = 0;
+    uint32_t islands = 0;
+    int iterations = 0;             // most iterations run by any island
+    uint32_t islandsConverged = 0;  // islands stopped by velocityTolerance
+    int positionIterations = 0;     // most NGS iterations run by any island
+    std::vector<float> maxVelocityError;    // per iteration (per substep
+    std::vector<float> rmsVelocityError;    // in SolverMode::SoftStep)
+    float normalImpulse = 0.0f;     // sum of Pn over all rows
+    float tangentImpulse = 0.0f;    // sum of |Pt|
+    // Overlap left after position correction, see measure_penetration()
+    float maxPenetration = 0.0f;
+    float rmsPenetration = 0.0f;
+};
+
+// Sequential impulse solver over a compact array of contact rows.
+// Usage per step: prepare -> solve (or warm_start + solve_velocities
+// by hand) -> store_impulses.
+//
+// prepare() also splits the rows into islands. Islands share no dynamic
+// body, so solve() can run them on different threads and still give
+// the same result as a single serial pass.
+class ContactSolver {
+public:
+    void prepare(const std::vector<Body>& bodies,
+                 const std::vector<ContactManifold>& manifolds,
+                 const SolverSettings& settings,
+                 float restitution);
+
+    // Warm start plus settings.velocityIterations, island by island.
+    void solve(std::vector<Body>& bodies, const SolverSettings& settings,
+               ThreadPool* pool);
+
+    // SolverMode::SoftStep: substeps of soft contact iterations, body
+    // positions are moved by the velocity change of every substep.
+    // Replaces both solve() and the split impulse pass.
+    void solve_soft(std::vector<Body>& bodies, const SolverSettings& settings,
+                    float dt, ThreadPool* pool);
+
+    // Pseudo velocities that push both bodies of every row apart by its
+    // overlap, positionIterations passes per island.
+    void solve_split_impulse(std::vector<Body>& bodies, float dt,
+                             const SolverSettings& settings, ThreadPool* pool);
+
+    // PositionSolver::NonLinearGaussSeidel: moves body positions directly
+    // until the overlap of every row is within linearSlop or the
+    // iteration budget is used up.
+    void solve_positions(std::vector<Body>& bodies, const SolverSettings& settings,
+                         ThreadPool* pool);
+
+    void warm_start(std::vector<Body>& bodies) const;
+
+    void solve_velocities(std::vector<Body>& bodies);
+
+    void store_impulses(std::vector<ContactManifold>& manifolds) const;
+
+    // Overlap of every row after the bodies were moved by the position
+    // correction (split impulse or substeps), written to stats().
+    void measure_penetration(const std::vector<Body>& bodies);
+
+    [[nodiscard]] const SolverStats& stats() const { return m_stats; }
+
+    [[nodiscard]] const std::vector<SolverContact>& contacts() const { return m_contacts; }
+
+    // Largest island first.
+    [[nodiscard]] const std::vector<ContactIsland>& islands() const { return m_islands; }
+
+    [[nodiscard]] const std::vector<ColorBatch>& batches() const { return m_batches; }
+
+private:
+    void build_islands(uint32_t bodyCount);
+    void color_island(ContactIsland& island);
+    int solve_colored(std::vector<Body>& bodies, const ContactIsland& island,
+                      const SolverSettings& settings, ThreadPool* pool,
+                      IterationError* errors);
+    IterationError* begin_stats(int iterations);
+    void finish_stats(int iterations);
+
+    template <typename Fn>
+    void for_each_island(const SolverSettings& settings, ThreadPool* pool, Fn&& fn) const;
+    template <typename Fn>
+    void for_each_batch_range(const ContactIsland& island, const SolverSettings& settings,
+                              ThreadPool* pool, Fn&& fn) const;
+
+    std::vector<SolverContact> m_contacts;
+    std::vector<ContactIsland> m_islands;
+    std::vector<uint32_t> m_island_bodies;
+    std::vector<glm::vec2> m_velocity0;     // body velocities at prepare time
+    std::vector<ColorBatch> m_batches;
+    SolverRowsSoA m_soa;
+    SolverStats m_stats;
+    std::vector<IterationError> m_island_errors;    // islands x iterations
+    std::vector<int> m_island_iterations;
+    std::vector<float> m_pseudo_impulse;    // per row, split impulse pass
+    std::unordered_map<BodyID, uint32_t> m_body_index;
+
+    // Scratch for island building, kept to avoid per step allocations
+    std::vector<uint32_t> m_parent;
+    std::vector<uint32_t> m_island_of_root;
+    std::vector<uint32_t> m_row_island;
+    std::vector<uint32_t> m_body_island;
+    std::vector<SolverContact> m_sorted;
+    std::vector<uint64_t> m_body_colors;
+    std::vector<uint32_t> m_body_slot;
+    std::vector<uint32_t> m_row_color;
+};
+
+#endif //ENGINELOOP_CONTACT_SOLVER_H
@@ -6,6 +6,8 @@
 
 #include "physics_world.h"
 #include "boid_flock.h"
+#include "interpolation.h"
+#include "simulation_thread.h"
 #include <glm/glm.hpp>
 #include <cmath>
 #include <iomanip>
@@ -177,12 +179,15 @@ void debug_draw_body(
     }
 }
 
-static void draw_boid_shape(SDL_Renderer*, const Boid&, int, int, float);
+static void draw_boid_shape(SDL_Renderer*, const Boid&, glm::vec2, int, int, float);
 
-void draw_frame(
+// Positions are the interpolated ones, one per body / boid
+static void draw_scene(
     SDL_Renderer* renderer,
-    PhysicsWorld& world,
-    const Flock* flock,
+    const std::vector<Body>& bodies,
+    const std::vector<glm::vec2>& bodyPositions,
+    const std::vector<Boid>* boids,
+    const std::vector<glm::vec2>& boidPositions,
     SDL_Texture* playerTex)
 {
     SDL_RenderSetLogicalSize(renderer, 0, 0);
@@ -217,7 +222,9 @@ void draw_frame(
     const float ppm = screen_w / VISIBLE_WORLD_WIDTH;
 
     // ---- Bodies ----
-    for (const Body& body : world.getBodies()) {
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        Body body = bodies[i];
+        body.position = bodyPositions[i];
         debug_draw_body(renderer, body, screen_w, screen_h, ppm);
         // Draw cat texture on top for player body (id 5)
         if (body.id == 5 && playerTex) {
@@ -241,23 +248,65 @@ void draw_frame(
     }
 
     // ---- Boids ----
-    if (flock) {
-        for (const Boid& b : flock->getBoids())
-            draw_boid_shape(renderer, b, screen_w, screen_h, ppm);
+    if (boids) {
+        for (size_t i = 0; i < boids->size(); ++i)
+            draw_boid_shape(renderer, (*boids)[i], boidPositions[i], screen_w, screen_h, ppm);
     }
 
     SDL_RenderPresent(renderer);
 }
 
+void draw_frame(
+    SDL_Renderer* renderer,
+    PhysicsWorld& world,
+    const Flock* flock,
+    SDL_Texture* playerTex)
+{
+    // Scratch reused from frame to frame, drawing is single threaded
+    static std::vector<glm::vec2> bodyPositions;
+    static std::vector<glm::vec2> boidPositions;
+
+    const float alpha = world.alpha();
+    world.interpolated_positions(alpha, bodyPositions);
+    if (flock)
+        flock->interpolated_positions(alpha, boidPositions);
+
+    draw_scene(renderer, world.getBodies(), bodyPositions,
+               flock ? &flock->getBoids() : nullptr, boidPositions, playerTex);
+}
+
+void draw_frame(
+    SDL_Renderer* renderer,
+    const RenderSnapshot& snapshot,
+    SDL_Texture* playerTex)
+{
+    static std::vector<glm::vec2> bodyPositions;
+    static std::vector<glm::vec2> boidPositions;
+
+    const float alpha = render_alpha(snapshot, engine::now());
+    bodyPositions.resize(snapshot.bodies.size());
+    for (size_t i = 0; i < snapshot.bodies.size(); ++i)
+        bodyPositions[i] = snapshot.bodies[i].position;
+    interpolate(snapshot.prevBodyPositions, bodyPositions, alpha, bodyPositions);
+    boidPositions.resize(snapshot.boids.size());
+    for (size_t i = 0; i < snapshot.boids.size(); ++i)
+        boidPositions[i] = snapshot.boids[i].body.position;
+    interpolate(snapshot.prevBoidPositions, boidPositions, alpha, boidPositions);
+
+    draw_scene(renderer, snapshot.bodies, bodyPositions,
+               &snapshot.boids, boidPositions, playerTex);
+}
+
 // Draw a single boid as a triangle pointing in its velocity direction
 static void draw_boid_shape(
     SDL_Renderer* renderer,
     const Boid& boid,
+    glm::vec2 position,
     int screen_w, int screen_h,
     float ppm)
 {
-    float px = boid.body.position.x;
-    float py = boid.body.position.y;
+    float px = position.x;
+    float py = position.y;
 
     glm::vec2 fwd{1.0f, 0.0f};
     float spd = glm::length(boid.body.velocity);
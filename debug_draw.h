@@ -11,6 +11,7 @@
 #include "body.h"
 
 class Flock;
+struct RenderSnapshot;
 
 void draw_frame(
     SDL_Renderer* renderer,
@@ -19,6 +20,13 @@ void draw_frame(
     SDL_Texture* playerTex = nullptr
 );
 
+// Same picture from a snapshot published by SimulationThread
+void draw_frame(
+    SDL_Renderer* renderer,
+    const RenderSnapshot& snapshot,
+    SDL_Texture* playerTex = nullptr
+);
+
 void debug_draw_body(
     SDL_Renderer* renderer,
     const Body& body,
@@ -0,0 +1,23 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#include "determinism.h"
+
+void set_deterministic_fp_env()
+{
+    // FE_DFL_ENV also resets the SSE control word, which holds the
+    // flush to zero / denormals are zero bits on x86
+    std::fesetenv(FE_DFL_ENV);
+}
+
+DeterministicFpScope::DeterministicFpScope()
+{
+    std::fegetenv(&m_saved);
+    set_deterministic_fp_env();
+}
+
+DeterministicFpScope::~DeterministicFpScope()
+{
+    std::fesetenv(&m_saved);
+}
@@ -0,0 +1,105 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#ifndef ENGINELOOP_DETERMINISM_H
+#define ENGINELOOP_DETERMINISM_H
+#include <bit>
+#include <cfenv>
+#include <cstdint>
+
+#include "body.h"
+#include "glm/vec2.hpp"
+
+// Incremental 64 bit hash of simulation state for lockstep checks.
+// Floats are hashed by their bit pattern, so two peers agree only when
+// their states are bit identical. Seeding it with the hash of the last
+// step chains the steps: once two peers diverge they never agree again.
+// One multiply per word, cheap enough to run every step.
+class StateHash {
+public:
+    explicit StateHash(uint64_t seed = 0) : m_h(seed ^ 0x9e3779b97f4a7c15ull) {}
+
+    void add(const uint32_t w)
+    {
+        m_h = (m_h ^ w) * 0xff51afd7ed558ccdull;
+        m_h ^= m_h >> 32;
+    }
+    void add(const uint64_t w)
+    {
+        add(static_cast<uint32_t>(w));
+        add(static_cast<uint32_t>(w >> 32));
+    }
+    void add(const float f) { add(std::bit_cast<uint32_t>(f)); }
+    void add(const glm::vec2& v) { add(v.x); add(v.y); }
+
+    [[nodiscard]] uint64_t value() const
+    {
+        uint64_t h = m_h;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+private:
+    uint64_t m_h;
+};
+
+// Every field a later step reads
+inline void hash_body(StateHash& h, const Body& b)
+{
+    h.add(b.id);
+    h.add(static_cast<uint32_t>(b.type) | (b.onGround ? 0x100u : 0u));
+    h.add(b.position);
+    h.add(b.velocity);
+    h.add(b.acceleration);
+    h.add(b.pseudoVelocity);
+    h.add(b.invMass);
+    h.add(b.halfWidth);
+    h.add(b.halfHeight);
+    h.add(static_cast<uint32_t>(b.shape.type));
+    h.add(b.shape.index);
+}
+
+// Shape parameters the bodies refer to through Shape::index. Polygon
+// normals are derived from the vertices and left out.
+inline void hash_shapes(StateHash& h, const ShapeStore& shapes)
+{
+    h.add(static_cast<uint32_t>(shapes.circles.size()));
+    for (const CircleShape& c: shapes.circles)
+        h.add(c.radius);
+    h.add(static_cast<uint32_t>(shapes.capsules.size()));
+    for (const CapsuleShape& c: shapes.capsules) {
+        h.add(c.halfSegment);
+        h.add(c.radius);
+    }
+    h.add(static_cast<uint32_t>(shapes.polygons.size()));
+    for (const PolygonShape& p: shapes.polygons) {
+        h.add(p.count);
+        for (uint32_t i = 0; i < p.count && i < MAX_POLYGON_VERTICES; ++i)
+            h.add(p.vertices[i]);
+    }
+}
+
+// Puts the calling thread into the default floating point environment:
+// round to nearest, exceptions masked, denormals neither flushed nor
+// treated as zero. Libraries (audio, graphics drivers) sometimes change
+// it behind our back; two peers only compute the same bits when both
+// run in the same environment.
+void set_deterministic_fp_env();
+
+// Default environment for a scope, the previous one restored afterwards.
+class DeterministicFpScope {
+public:
+    DeterministicFpScope();
+    ~DeterministicFpScope();
+
+    DeterministicFpScope(const DeterministicFpScope&) = delete;
+    DeterministicFpScope& operator=(const DeterministicFpScope&) = delete;
+
+private:
+    std::fenv_t m_saved{};
+};
+
+#endif //ENGINELOOP_DETERMINISM_H
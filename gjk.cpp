@@ -0,0 +1,386 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#include "gjk.h"
+
+#include <algorithm>
+#include <cmath>
+
+static float dot(const glm::vec2 a, const glm::vec2 b) { return a.x * b.x + a.y * b.y; }
+static float cross(const glm::vec2 a, const glm::vec2 b) { return a.x * b.y - a.y * b.x; }
+
+int GjkProxy::support(const glm::vec2 d) const
+{
+    int best = 0;
+    float bestDot = dot(vertices[0], d);
+    for (int i = 1; i < count; ++i) {
+        const float v = dot(vertices[i], d);
+        if (v > bestDot) {
+            best = i;
+            bestDot = v;
+        }
+    }
+    return best;
+}
+
+GjkProxy make_proxy(const Body& b, const ShapeStore& shapes)
+{
+    GjkProxy p;
+    switch (b.shape.type) {
+        case Type::circle:
+            p.count = 1;
+            p.vertices[0] = b.position;
+            p.radius = shapes.circles[b.shape.index].radius;
+            break;
+        case Type::capsule: {
+            const CapsuleShape& cap = shapes.capsules[b.shape.index];
+            p.count = 2;
+            p.vertices[0] = b.position - cap.halfSegment;
+            p.vertices[1] = b.position + cap.halfSegment;
+            p.radius = cap.radius;
+            break;
+        }
+        case Type::polygon: {
+            const PolygonShape& poly = shapes.polygons[b.shape.index];
+            p.count = static_cast<int>(poly.count);
+            for (int i = 0; i < p.count; ++i) {
+                p.vertices[i] = b.position + poly.vertices[i];
+                p.normals[i] = poly.normals[i];
+            }
+            break;
+        }
+        default: {
+            // Counter clockwise from the lower left corner
+            const float hw = b.halfWidth;
+            const float hh = b.halfHeight;
+            p.count = 4;
+            p.vertices[0] = b.position + glm::vec2{-hw, -hh};
+            p.vertices[1] = b.position + glm::vec2{ hw, -hh};
+            p.vertices[2] = b.position + glm::vec2{ hw,  hh};
+            p.vertices[3] = b.position + glm::vec2{-hw,  hh};
+            p.normals[0] = {0.0f, -1.0f};
+            p.normals[1] = {1.0f, 0.0f};
+            p.normals[2] = {0.0f, 1.0f};
+            p.normals[3] = {-1.0f, 0.0f};
+            break;
+        }
+    }
+    return p;
+}
+
+namespace {
+
+struct SimplexVertex {
+    glm::vec2 wA;
+    glm::vec2 wB;
+    glm::vec2 w;    // wB - wA, a point of the Minkowski difference
+    float a;        // barycentric weight of the closest point
+    int indexA;
+    int indexB;
+};
+
+struct Simplex {
+    SimplexVertex v[3];
+    int count;
+
+    void solve2()
+    {
+        const glm::vec2 w1 = v[0].w;
+        const glm::vec2 w2 = v[1].w;
+        const glm::vec2 e12 = w2 - w1;
+
+        const float d12_2 = -dot(w1, e12);
+        if (d12_2 <= 0.0f) {
+            v[0].a = 1.0f;
+            count = 1;
+            return;
+        }
+        const float d12_1 = dot(w2, e12);
+        if (d12_1 <= 0.0f) {
+            v[1].a = 1.0f;
+            count = 1;
+            v[0] = v[1];
+            return;
+        }
+        const float inv = 1.0f / (d12_1 + d12_2);
+        v[0].a = d12_1 * inv;
+        v[1].a = d12_2 * inv;
+        count = 2;
+    }
+
+    // Voronoi regions of the triangle, in the order Box2D tests them
+    void solve3()
+    {
+        const glm::vec2 w1 = v[0].w;
+        const glm::vec2 w2 = v[1].w;
+        const glm::vec2 w3 = v[2].w;
+
+        const glm::vec2 e12 = w2 - w1;
+        const float d12_1 = dot(w2, e12);
+        const float d12_2 = -dot(w1, e12);
+
+        const glm::vec2 e13 = w3 - w1;
+        const float d13_1 = dot(w3, e13);
+        const float d13_2 = -dot(w1, e13);
+
+        const glm::vec2 e23 = w3 - w2;
+        const float d23_1 = dot(w3, e23);
+        const float d23_2 = -dot(w2, e23);
+
+        const float n123 = cross(e12, e13);
+        const float d123_1 = n123 * cross(w2, w3);
+        const float d123_2 = n123 * cross(w3, w1);
+        const float d123_3 = n123 * cross(w1, w2);
+
+        if (d12_2 <= 0.0f && d13_2 <= 0.0f) {
+            v[0].a = 1.0f;
+            count = 1;
+            return;
+        }
+        if (d12_1 > 0.0f && d12_2 > 0.0f && d123_3 <= 0.0f) {
+            const float inv = 1.0f / (d12_1 + d12_2);
+            v[0].a = d12_1 * inv;
+            v[1].a = d12_2 * inv;
+            count = 2;
+            return;
+        }
+        if (d13_1 > 0.0f && d13_2 > 0.0f && d123_2 <= 0.0f) {
+            const float inv = 1.0f / (d13_1 + d13_2);
+            v[0].a = d13_1 * inv;
+            v[2].a = d13_2 * inv;
+            count = 2;
+            v[1] = v[2];
+            return;
+        }
+        if (d12_1 <= 0.0f && d23_2 <= 0.0f) {
+            v[1].a = 1.0f;
+            count = 1;
+            v[0] = v[1];
+            return;
+        }
+        if (d13_1 <= 0.0f && d23_1 <= 0.0f) {
+            v[2].a = 1.0f;
+            count = 1;
+            v[0] = v[2];
+            return;
+        }
+        if (d23_1 > 0.0f && d23_2 > 0.0f && d123_1 <= 0.0f) {
+            const float inv = 1.0f / (d23_1 + d23_2);
+            v[1].a = d23_1 * inv;
+            v[2].a = d23_2 * inv;
+            count = 2;
+            v[0] = v[2];
+            return;
+        }
+        const float inv = 1.0f / (d123_1 + d123_2 + d123_3);
+        v[0].a = d123_1 * inv;
+        v[1].a = d123_2 * inv;
+        v[2].a = d123_3 * inv;
+        count = 3;
+    }
+
+    [[nodiscard]] glm::vec2 search_direction() const
+    {
+        if (count == 1)
+            return -v[0].w;
+        const glm::vec2 e12 = v[1].w - v[0].w;
+        if (cross(e12, -v[0].w) > 0.0f)
+            return {-e12.y, e12.x};     // origin left of e12
+        return {e12.y, -e12.x};
+    }
+};
+
+SimplexVertex make_vertex(const GjkProxy& a, const GjkProxy& b, const int ia, const int ib)
+{
+    SimplexVertex v;
+    v.indexA = ia;
+    v.indexB = ib;
+    v.wA = a.vertices[ia];
+    v.wB = b.vertices[ib];
+    v.w = v.wB - v.wA;
+    v.a = 1.0f;
+    return v;
+}
+
+} // namespace
+
+GjkOutput gjk_distance(const GjkProxy& a, const GjkProxy& b, SimplexCache& cache)
+{
+    Simplex s;
+    s.count = 0;
+    for (int i = 0; i < cache.count; ++i) {
+        if (cache.indexA[i] >= a.count || cache.indexB[i] >= b.count)
+            break;
+        s.v[s.count++] = make_vertex(a, b, cache.indexA[i], cache.indexB[i]);
+    }
+    if (s.count != cache.count || s.count == 0) {
+        s.v[0] = make_vertex(a, b, 0, 0);
+        s.count = 1;
+    }
+
+    constexpr int maxIterations = 20;
+    int iterations = 0;
+    while (iterations < maxIterations) {
+        int saveA[3];
+        int saveB[3];
+        const int saveCount = s.count;
+        for (int i = 0; i < saveCount; ++i) {
+            saveA[i] = s.v[i].indexA;
+            saveB[i] = s.v[i].indexB;
+        }
+
+        if (s.count == 2)
+            s.solve2();
+        else if (s.count == 3)
+            s.solve3();
+
+        // Origin inside the triangle: overlap
+        if (s.count == 3)
+            break;
+
+        const glm::vec2 d = s.search_direction();
+        // Origin on the simplex, touching
+        if (dot(d, d) < 1e-12f)
+            break;
+
+        SimplexVertex& v = s.v[s.count];
+        v = make_vertex(a, b, a.support(-d), b.support(d));
+        ++iterations;
+
+        // No new vertex, the simplex is as close as it gets
+        bool duplicate = false;
+        for (int i = 0; i < saveCount; ++i) {
+            if (v.indexA == saveA[i] && v.indexB == saveB[i]) {
+                duplicate = true;
+                break;
+            }
+        }
+        if (duplicate)
+            break;
+        ++s.count;
+    }
+
+    GjkOutput out{};
+    out.iterations = iterations;
+    out.count = s.count;
+    for (int i = 0; i < s.count; ++i) {
+        out.w[i] = s.v[i].w;
+        out.wA[i] = s.v[i].wA;
+        out.wB[i] = s.v[i].wB;
+    }
+
+    switch (s.count) {
+        case 1:
+            out.pointA = s.v[0].wA;
+            out.pointB = s.v[0].wB;
+            break;
+        case 2:
+            out.pointA = s.v[0].wA * s.v[0].a + s.v[1].wA * s.v[1].a;
+            out.pointB = s.v[0].wB * s.v[0].a + s.v[1].wB * s.v[1].a;
+            break;
+        default:
+            out.pointA = s.v[0].wA * s.v[0].a + s.v[1].wA * s.v[1].a + s.v[2].wA * s.v[2].a;
+            out.pointB = out.pointA;
+            break;
+    }
+    const glm::vec2 d = out.pointB - out.pointA;
+    out.distance = std::sqrt(dot(d, d));
+    out.overlap = s.count == 3;
+
+    cache.count = static_cast<uint8_t>(s.count);
+    for (int i = 0; i < s.count; ++i) {
+        cache.indexA[i] = static_cast<uint8_t>(s.v[i].indexA);
+        cache.indexB[i] = static_cast<uint8_t>(s.v[i].indexB);
+    }
+    return out;
+}
+
+bool epa_penetration(const GjkProxy& a, const GjkProxy& b, const GjkOutput& gjk,
+                     EpaOutput& out)
+{
+    if (gjk.count < 3)
+        return false;
+
+    struct Vertex {
+        glm::vec2 w;
+        glm::vec2 wB;
+    };
+    constexpr int maxVertices = 2 * MAX_POLYGON_VERTICES + 3;
+    Vertex poly[maxVertices];
+    int n = 3;
+    for (int i = 0; i < 3; ++i)
+        poly[i] = {gjk.w[i], gjk.wB[i]};
+    // Counter clockwise, so edge normals (e.y, -e.x) point outwards
+    if (cross(poly[1].w - poly[0].w, poly[2].w - poly[0].w) < 0.0f)
+        std::swap(poly[1], poly[2]);
+
+    constexpr float tolerance = 1e-4f;
+    for (;;) {
+        int edge = -1;
+        float edgeDist = INFINITY;
+        glm::vec2 edgeNormal{0.0f, 0.0f};
+        for (int i = 0; i < n; ++i) {
+            const glm::vec2 e = poly[(i + 1) % n].w - poly[i].w;
+            const float len = std::sqrt(dot(e, e));
+            if (len <= 1e-9f)
+                continue;
+            const glm::vec2 normal{e.y / len, -e.x / len};
+            const float dist = dot(normal, poly[i].w);
+            if (dist < edgeDist) {
+                edge = i;
+                edgeDist = dist;
+                edgeNormal = normal;
+            }
+        }
+        if (edge < 0)
+            return false;
+
+        const int ia = a.support(-edgeNormal);
+        const int ib = b.support(edgeNormal);
+        const glm::vec2 w = b.vertices[ib] - a.vertices[ia];
+
+        if (dot(w, edgeNormal) - edgeDist < tolerance || n == maxVertices) {
+            // Closest point of the edge to the origin, mapped back onto b
+            const Vertex& p0 = poly[edge];
+            const Vertex& p1 = poly[(edge + 1) % n];
+            const glm::vec2 e = p1.w - p0.w;
+            const float t = std::clamp(dot(edgeNormal * edgeDist - p0.w, e) / dot(e, e), 0.0f, 1.0f);
+            out.normal = edgeNormal;
+            out.depth = std::max(edgeDist, 0.0f);
+            out.pointB = p0.wB + (p1.wB - p0.wB) * t;
+            return true;
+        }
+
+        for (int i = n; i > edge + 1; --i)
+            poly[i] = poly[i - 1];
+        poly[edge + 1] = {w, b.vertices[ib]};
+        ++n;
+    }
+}
+
+static uint64_t pair_key(const BodyID a, const BodyID b)
+{
+    return (static_cast<uint64_t>(a) << 32) | b;
+}
+
+SimplexCache& SimplexCacheTable::get(const BodyID a, const BodyID b)
+{
+    Slot& slot = m_slots[pair_key(a, b)];
+    slot.used = true;
+    return slot.cache;
+}
+
+void SimplexCacheTable::end_step()
+{
+    std::erase_if(m_slots, [](const auto& kv) { return !kv.second.used; });
+    for (auto& [key, slot]: m_slots)
+        slot.used = false;
+}
+
+void SimplexCacheTable::restore(const std::span<const SimplexCacheEntry> entries)
+{
+    m_slots.clear();
+    for (const SimplexCacheEntry& e: entries)
+        m_slots[e.key] = Slot{e.cache, false};
+}
@@ -0,0 +1,94 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#ifndef ENGINELOOP_GJK_H
+#define ENGINELOOP_GJK_H
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+
+#include "body.h"
+
+// Convex core of a shape in world space plus a rounding radius.
+// Boxes and polygons have radius 0, a circle is one vertex, a capsule two.
+struct GjkProxy {
+    glm::vec2 vertices[MAX_POLYGON_VERTICES];
+    glm::vec2 normals[MAX_POLYGON_VERTICES];    // edge i runs from vertex i to i + 1
+    int count = 0;
+    float radius = 0.0f;
+
+    [[nodiscard]] int support(glm::vec2 d) const;
+};
+
+GjkProxy make_proxy(const Body& b, const ShapeStore& shapes);
+
+// Vertex pairs of the last simplex of a pair. Fed back into the next
+// gjk_distance call, a pair that barely moved starts on its answer.
+struct SimplexCache {
+    uint8_t count = 0;
+    uint8_t indexA[3] = {};
+    uint8_t indexB[3] = {};
+};
+
+struct GjkOutput {
+    glm::vec2 pointA;   // closest points of the cores
+    glm::vec2 pointB;
+    float distance;     // 0 when the cores overlap
+    int iterations;
+    bool overlap;       // origin enclosed by the simplex
+    // Final simplex, used to start EPA
+    glm::vec2 w[3];
+    glm::vec2 wA[3];
+    glm::vec2 wB[3];
+    int count;
+};
+
+// Distance between the cores, radii not applied (Box2D b2Distance without
+// rotation). Reads and updates cache.
+GjkOutput gjk_distance(const GjkProxy& a, const GjkProxy& b, SimplexCache& cache);
+
+struct EpaOutput {
+    glm::vec2 normal;   // direction to move a out of b
+    float depth;        // core overlap along normal
+    glm::vec2 pointB;   // deepest point on the surface of b
+};
+
+// Penetration of overlapping cores by expanding the GJK simplex.
+// False when the simplex is degenerate (cores only touching).
+bool epa_penetration(const GjkProxy& a, const GjkProxy& b, const GjkOutput& gjk,
+                     EpaOutput& out);
+
+struct SimplexCacheEntry {
+    uint64_t key;
+    SimplexCache cache;
+};
+
+// Simplex caches of pairs that went through GJK, keyed by the ordered
+// (A, B) ids. Pairs not looked up during a step are dropped at its end.
+class SimplexCacheTable {
+public:
+    SimplexCache& get(BodyID a, BodyID b);
+    void end_step();
+
+    // Flat view of the table between steps, for snapshots
+    template <typename Fn>
+    void for_each(Fn&& fn) const
+    {
+        for (const auto& [key, slot]: m_slots)
+            fn(SimplexCacheEntry{key, slot.cache});
+    }
+
+    void restore(std::span<const SimplexCacheEntry> entries);
+
+    [[nodiscard]] size_t size() const { return m_slots.size(); }
+
+private:
+    struct Slot {
+        SimplexCache cache;
+        bool used = false;
+    };
+    std::unordered_map<uint64_t, Slot> m_slots;
+};
+
+#endif //ENGINELOOP_GJK_H
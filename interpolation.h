@@ -0,0 +1,48 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#ifndef ENGINELOOP_INTERPOLATION_H
+#define ENGINELOOP_INTERPOLATION_H
+#include <algorithm>
+#include <span>
+
+#include "glm/vec2.hpp"
+
+// Blend between the previous and the current fixed step. Rendering draws
+// the state alpha = accumulator / fixed_dt of the way from one to the
+// other, so it stays smooth when it runs at another rate than physics.
+inline float interpolate(const float prev, const float curr, const float alpha)
+{
+    return prev + (curr - prev) * alpha;
+}
+
+inline glm::vec2 interpolate(const glm::vec2& prev,
+                             const glm::vec2& curr,
+                             const float alpha)
+{
+    return glm::vec2{
+        interpolate(prev.x, curr.x, alpha),
+        interpolate(prev.y, curr.y, alpha)
+    };
+}
+
+// Whole position buffer in a single flat pass over the arrays instead of
+// one call per body. out may be curr itself. Entries without a previous
+// position (added since the last step) are taken from curr unchanged.
+inline void interpolate(std::span<const glm::vec2> prev,
+                        std::span<const glm::vec2> curr,
+                        const float alpha,
+                        std::span<glm::vec2> out)
+{
+    const size_t n = std::min(prev.size(), curr.size());
+    for (size_t i = 0; i < n; ++i) {
+        out[i].x = interpolate(prev[i].x, curr[i].x, alpha);
+        out[i].y = interpolate(prev[i].y, curr[i].y, alpha);
+    }
+    if (out.data() != curr.data())
+        std::copy(curr.begin() + static_cast<std::ptrdiff_t>(n), curr.end(),
+                  out.begin() + static_cast<std::ptrdiff_t>(n));
+}
+
+#endif //ENGINELOOP_INTERPOLATION_H
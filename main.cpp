@@ -1,6 +1,7 @@
 #include <iostream>
 #include <thread>
 #include <random>
+#include <string_view>
 #include "engine_time.h"
 #include "physics_world.h"
 #include "render_console.h"
@@ -8,6 +9,7 @@
 #include "render_2d.h"
 #include "boid_flock.h"
 #include "boid.h"
+#include "simulation_thread.h"
 
 std::mt19937 rng{std::random_device{}()};
 std::uniform_int_distribution jitter_ms(-5, 5);
@@ -16,8 +18,14 @@ float collision_global_time;
 float collision_position;
 bool prev_hit;
 
-int main()
+int main(int argc, char** argv)
 {
+    // --sim-thread: physics runs on its own thread, rendering reads snapshots
+    bool sim_thread = false;
+    for (int i = 1; i < argc; ++i)
+        if (std::string_view(argv[i]) == "--sim-thread")
+            sim_thread = true;
+
     constexpr float physics_dt = 1.0f / 60.0f; // 60 Hz physics
     PhysicsWorld world(physics_dt);
 
@@ -140,6 +148,17 @@ int main()
 //        std::this_thread::sleep_for(std::chrono::milliseconds(base_ms + jitter));
 //    }
 
+    if (sim_thread) {
+        SimulationThread simulation(world);
+        simulation.start();
+        while (renderer.isRunning()) {
+            renderer.handleEvents();
+            renderer.render(simulation.latest());
+        }
+        simulation.stop();
+        return 0;
+    }
+
     while (renderer.isRunning()) {
         renderer.handleEvents();
 
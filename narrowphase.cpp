@@ -0,0 +1,548 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#include "narrowphase.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Feature id of a clipped box contact point:
+//   bit 0: reference axis (0 = x, 1 = y)
+//   bit 1: normal sign    (0 = positive, 1 = negative)
+//   bit 2: end of the overlap interval (0 = low, 1 = high)
+//   bit 3: box whose side edge bounds that end (0 = a, 1 = b)
+static uint32_t box_feature(const uint32_t axis, const bool negative,
+                            const uint32_t end, const uint32_t owner)
+{
+    return axis | (negative ? 2u : 0u) | (end << 2) | (owner << 3);
+}
+
+bool collide_boxes(const Body& a, const Body& b, const float margin, ContactManifold& out)
+{
+    const glm::vec2 d = a.position - b.position;
+    const float overlapX = (a.halfWidth + b.halfWidth) - std::abs(d.x);
+    const float overlapY = (a.halfHeight + b.halfHeight) - std::abs(d.y);
+
+    if (overlapX < -margin || overlapY < -margin)
+        return false;
+
+    // Minimum penetration axis. Ties go to y, so boxes in a stack do not
+    // flip to a side normal because of round off.
+    constexpr float axisTolerance = 1e-4f;
+    const uint32_t axis = (overlapY <= overlapX + axisTolerance) ? 1u : 0u;
+
+    // Tangent direction is the other axis
+    const uint32_t t = 1u - axis;
+    const float halfA = (t == 0) ? a.halfWidth : a.halfHeight;
+    const float halfB = (t == 0) ? b.halfWidth : b.halfHeight;
+
+    // Clip: overlap of the two faces along the tangent axis
+    const float aLo = a.position[t] - halfA;
+    const float aHi = a.position[t] + halfA;
+    const float bLo = b.position[t] - halfB;
+    const float bHi = b.position[t] + halfB;
+    const float lo = std::max(aLo, bLo);
+    const float hi = std::min(aHi, bHi);
+
+    const bool negative = d[axis] < 0.0f;
+    const float sign = negative ? -1.0f : 1.0f;
+    const float halfNormalB = (axis == 0) ? b.halfWidth : b.halfHeight;
+    const float face = b.position[axis] + sign * halfNormalB;
+    const float penetration = std::max((axis == 0) ? overlapX : overlapY, 0.0f);
+
+    glm::vec2 normal{0.0f, 0.0f};
+    normal[axis] = sign;
+
+    out.bodyA = a.id;
+    out.bodyB = b.id;
+    out.pointCount = 0;
+
+    auto add_point = [&](const float along, const uint32_t end, const uint32_t owner) {
+        ContactPoint& cp = out.points[out.pointCount++];
+        cp.position[axis] = face;
+        cp.position[t] = along;
+        cp.normal = normal;
+        cp.penetration = penetration;
+        cp.Pn = 0.0f;
+        cp.Pt = 0.0f;
+        cp.feature = box_feature(axis, negative, end, owner);
+    };
+
+    add_point(lo, 0, aLo >= bLo ? 0u : 1u);
+    // Corner touching corner gives a single point
+    if (hi - lo > margin)
+        add_point(hi, 1, aHi <= bHi ? 0u : 1u);
+
+    return true;
+}
+
+// Rounded shapes reduce to two discs: the closest points of their cores
+// (centre, point on a segment) with the radii around them.
+static bool disc_contact(const glm::vec2 pa, const float ra,
+                         const glm::vec2 pb, const float rb,
+                         const float margin, const uint32_t feature,
+                         ContactPoint& cp)
+{
+    const glm::vec2 d = pa - pb;
+    const float dist = std::sqrt(d.x * d.x + d.y * d.y);
+    const float separation = dist - ra - rb;
+    if (separation > margin)
+        return false;
+
+    // Concentric discs: any direction works, up keeps stacks stable
+    cp.normal = dist > 1e-6f ? d / dist : glm::vec2{0.0f, 1.0f};
+    cp.position = pb + cp.normal * rb;
+    cp.penetration = std::max(-separation, 0.0f);
+    cp.Pn = 0.0f;
+    cp.Pt = 0.0f;
+    cp.feature = feature;
+    return true;
+}
+
+// Disc at c with radius r against an axis aligned box.
+static bool disc_box_contact(const glm::vec2 c, const float r, const Body& box,
+                             const float margin, const uint32_t feature,
+                             ContactPoint& cp)
+{
+    const glm::vec2 lo = box.position - glm::vec2{box.halfWidth, box.halfHeight};
+    const glm::vec2 hi = box.position + glm::vec2{box.halfWidth, box.halfHeight};
+    const glm::vec2 q{std::clamp(c.x, lo.x, hi.x), std::clamp(c.y, lo.y, hi.y)};
+
+    if (q.x != c.x || q.y != c.y)
+        return disc_contact(c, r, q, 0.0f, margin, feature, cp);
+
+    // Centre inside the box: leave through the nearest face
+    const glm::vec2 d = c - box.position;
+    const float depthX = box.halfWidth - std::abs(d.x);
+    const float depthY = box.halfHeight - std::abs(d.y);
+    const uint32_t axis = depthY <= depthX ? 1u : 0u;
+    const float sign = d[axis] < 0.0f ? -1.0f : 1.0f;
+
+    cp.normal = {0.0f, 0.0f};
+    cp.normal[axis] = sign;
+    cp.position = c;
+    cp.position[axis] = box.position[axis] + sign * (axis == 0 ? box.halfWidth : box.halfHeight);
+    cp.penetration = (axis == 0 ? depthX : depthY) + r;
+    cp.Pn = 0.0f;
+    cp.Pt = 0.0f;
+    cp.feature = feature;
+    return true;
+}
+
+static glm::vec2 closest_on_segment(const glm::vec2 p0, const glm::vec2 p1, const glm::vec2 q)
+{
+    const glm::vec2 e = p1 - p0;
+    const float ee = e.x * e.x + e.y * e.y;
+    if (ee <= 1e-12f)
+        return p0;
+    const glm::vec2 w = q - p0;
+    const float t = std::clamp((w.x * e.x + w.y * e.y) / ee, 0.0f, 1.0f);
+    return p0 + e * t;
+}
+
+static void begin_manifold(const Body& a, const Body& b, ContactManifold& out)
+{
+    out.bodyA = a.id;
+    out.bodyB = b.id;
+    out.pointCount = 0;
+}
+
+bool collide_circles(const Body& a, const Body& b, const ShapeStore& shapes,
+                     const float margin, ContactManifold& out)
+{
+    begin_manifold(a, b, out);
+    const float ra = shapes.circles[a.shape.index].radius;
+    const float rb = shapes.circles[b.shape.index].radius;
+    if (!disc_contact(a.position, ra, b.position, rb, margin, 0, out.points[0]))
+        return false;
+    out.pointCount = 1;
+    return true;
+}
+
+bool collide_circle_box(const Body& a, const Body& b, const ShapeStore& shapes,
+                        const float margin, ContactManifold& out)
+{
+    begin_manifold(a, b, out);
+    const float r = shapes.circles[a.shape.index].radius;
+    if (!disc_box_contact(a.position, r, b, margin, 0, out.points[0]))
+        return false;
+    out.pointCount = 1;
+    return true;
+}
+
+bool collide_capsule_circle(const Body& a, const Body& b, const ShapeStore& shapes,
+                            const float margin, ContactManifold& out)
+{
+    begin_manifold(a, b, out);
+    const CapsuleShape& cap = shapes.capsules[a.shape.index];
+    const float rb = shapes.circles[b.shape.index].radius;
+    const glm::vec2 p = closest_on_segment(a.position - cap.halfSegment,
+                                           a.position + cap.halfSegment, b.position);
+    if (!disc_contact(p, cap.radius, b.position, rb, margin, 0, out.points[0]))
+        return false;
+    out.pointCount = 1;
+    return true;
+}
+
+bool collide_capsule_box(const Body& a, const Body& b, const ShapeStore& shapes,
+                         const float margin, ContactManifold& out)
+{
+    begin_manifold(a, b, out);
+    const CapsuleShape& cap = shapes.capsules[a.shape.index];
+    const glm::vec2 p0 = a.position - cap.halfSegment;
+    const glm::vec2 p1 = a.position + cap.halfSegment;
+
+    // Ends first: a capsule lying on a box gets one point per end
+    if (disc_box_contact(p0, cap.radius, b, margin, 0, out.points[out.pointCount]))
+        ++out.pointCount;
+    if (disc_box_contact(p1, cap.radius, b, margin, 1, out.points[out.pointCount]))
+        ++out.pointCount;
+    if (out.pointCount > 0)
+        return true;
+
+    // Distance from the segment to the box is convex along the segment,
+    // its minimum is at an end or at the projection of a box corner.
+    const glm::vec2 corners[4] = {
+        b.position + glm::vec2{-b.halfWidth, -b.halfHeight},
+        b.position + glm::vec2{ b.halfWidth, -b.halfHeight},
+        b.position + glm::vec2{ b.halfWidth,  b.halfHeight},
+        b.position + glm::vec2{-b.halfWidth,  b.halfHeight},
+    };
+    glm::vec2 best = p0;
+    float bestDist2 = INFINITY;
+    for (const glm::vec2& corner: corners) {
+        const glm::vec2 p = closest_on_segment(p0, p1, corner);
+        const glm::vec2 q{std::clamp(p.x, corners[0].x, corners[2].x),
+                          std::clamp(p.y, corners[0].y, corners[2].y)};
+        const glm::vec2 d = p - q;
+        const float dist2 = d.x * d.x + d.y * d.y;
+        if (dist2 < bestDist2) {
+            bestDist2 = dist2;
+            best = p;
+        }
+    }
+    if (!disc_box_contact(best, cap.radius, b, margin, 2, out.points[0]))
+        return false;
+    out.pointCount = 1;
+    return true;
+}
+
+// Closest points of two segments (Ericson, Real-Time Collision Detection 5.1.9)
+static void closest_between_segments(const glm::vec2 p0, const glm::vec2 p1,
+                                     const glm::vec2 q0, const glm::vec2 q1,
+                                     glm::vec2& onP, glm::vec2& onQ)
+{
+    const glm::vec2 d1 = p1 - p0;
+    const glm::vec2 d2 = q1 - q0;
+    const glm::vec2 r = p0 - q0;
+    const float a = d1.x * d1.x + d1.y * d1.y;
+    const float e = d2.x * d2.x + d2.y * d2.y;
+    const float f = d2.x * r.x + d2.y * r.y;
+    constexpr float eps = 1e-12f;
+
+    float s = 0.0f;
+    float t = 0.0f;
+    if (a <= eps && e <= eps) {
+        // both degenerate
+    } else if (a <= eps) {
+        t = std::clamp(f / e, 0.0f, 1.0f);
+    } else {
+        const float c = d1.x * r.x + d1.y * r.y;
+        if (e <= eps) {
+            s = std::clamp(-c / a, 0.0f, 1.0f);
+        } else {
+            const float b = d1.x * d2.x + d1.y * d2.y;
+            const float denom = a * e - b * b;
+            s = denom > eps ? std::clamp((b * f - c * e) / denom, 0.0f, 1.0f) : 0.0f;
+            t = (b * s + f) / e;
+            if (t < 0.0f) {
+                t = 0.0f;
+                s = std::clamp(-c / a, 0.0f, 1.0f);
+            } else if (t > 1.0f) {
+                t = 1.0f;
+                s = std::clamp((b - c) / a, 0.0f, 1.0f);
+            }
+        }
+    }
+    onP = p0 + d1 * s;
+    onQ = q0 + d2 * t;
+}
+
+bool collide_capsules(const Body& a, const Body& b, const ShapeStore& shapes,
+                      const float margin, ContactManifold& out)
+{
+    begin_manifold(a, b, out);
+    const CapsuleShape& ca = shapes.capsules[a.shape.index];
+    const CapsuleShape& cb = shapes.capsules[b.shape.index];
+    glm::vec2 pa, pb;
+    closest_between_segments(a.position - ca.halfSegment, a.position + ca.halfSegment,
+                             b.position - cb.halfSegment, b.position + cb.halfSegment,
+                             pa, pb);
+    if (!disc_contact(pa, ca.radius, pb, cb.radius, margin, 0, out.points[0]))
+        return false;
+    out.pointCount = 1;
+    return true;
+}
+
+// Clips segment [v0, v1] to the side dot(normal, x) <= offset
+// (Box2D b2ClipSegmentToLine). Points keep their feature, a point made by
+// the cut takes clipFeature.
+struct ClipVertex {
+    glm::vec2 v;
+    uint32_t feature;
+};
+
+static int clip_segment(ClipVertex out[2], const ClipVertex in[2],
+                        const glm::vec2 normal, const float offset,
+                        const uint32_t clipFeature)
+{
+    int count = 0;
+    const float d0 = normal.x * in[0].v.x + normal.y * in[0].v.y - offset;
+    const float d1 = normal.x * in[1].v.x + normal.y * in[1].v.y - offset;
+    if (d0 <= 0.0f)
+        out[count++] = in[0];
+    if (d1 <= 0.0f)
+        out[count++] = in[1];
+    if (d0 * d1 < 0.0f) {
+        const float t = d0 / (d0 - d1);
+        out[count++] = {in[0].v + (in[1].v - in[0].v) * t, clipFeature};
+    }
+    return count;
+}
+
+static float dot2(const glm::vec2 a, const glm::vec2 b) { return a.x * b.x + a.y * b.y; }
+
+// Two point manifold of two shapes with edges around normal n (b to a).
+// The reference face is the face best aligned with n, on b or on a.
+static int clip_faces(const GjkProxy& a, const GjkProxy& b, const glm::vec2 n,
+                      const float margin, ContactPoint points[2])
+{
+    int faceB = 0;
+    for (int i = 1; i < b.count; ++i)
+        if (dot2(b.normals[i], n) > dot2(b.normals[faceB], n))
+            faceB = i;
+    int faceA = 0;
+    for (int i = 1; i < a.count; ++i)
+        if (dot2(a.normals[i], n) < dot2(a.normals[faceA], n))
+            faceA = i;
+
+    // Prefer b so that resting contacts keep the same reference face
+    constexpr float relativeTolerance = 1e-3f;
+    const bool flip = -dot2(a.normals[faceA], n) > dot2(b.normals[faceB], n) + relativeTolerance;
+    const GjkProxy& ref = flip ? a : b;
+    const GjkProxy& inc = flip ? b : a;
+    const int refFace = flip ? faceA : faceB;
+    const glm::vec2 refNormal = ref.normals[refFace];
+
+    int incFace = 0;
+    for (int i = 1; i < inc.count; ++i)
+        if (dot2(inc.normals[i], refNormal) < dot2(inc.normals[incFace], refNormal))
+            incFace = i;
+
+    const glm::vec2 r1 = ref.vertices[refFace];
+    const glm::vec2 r2 = ref.vertices[(refFace + 1) % ref.count];
+    const glm::vec2 e = r2 - r1;
+    const glm::vec2 tangent = e / std::sqrt(dot2(e, e));
+
+    const ClipVertex incident[2] = {
+        {inc.vertices[incFace], 0u},
+        {inc.vertices[(incFace + 1) % inc.count], 1u},
+    };
+    ClipVertex clip1[2];
+    ClipVertex clip2[2];
+    if (clip_segment(clip1, incident, -tangent, -dot2(tangent, r1), 2u) < 2)
+        return 0;
+    if (clip_segment(clip2, clip1, tangent, dot2(tangent, r2), 3u) < 2)
+        return 0;
+
+    int count = 0;
+    for (const ClipVertex& cv: clip2) {
+        const float separation = dot2(cv.v - r1, refNormal) - a.radius - b.radius;
+        if (separation > margin)
+            continue;
+        ContactPoint& cp = points[count++];
+        cp.normal = flip ? -refNormal : refNormal;
+        cp.position = cv.v - refNormal * dot2(cv.v - r1, refNormal);
+        cp.penetration = std::max(-separation, 0.0f);
+        cp.Pn = 0.0f;
+        cp.Pt = 0.0f;
+        cp.feature = static_cast<uint32_t>(refFace) | (static_cast<uint32_t>(incFace) << 4) |
+                     (cv.feature << 8) | (flip ? 1u << 10 : 0u);
+    }
+    return count;
+}
+
+bool collide_convex(const Body& a, const Body& b, const ShapeStore& shapes,
+                    const float margin, ContactManifold& out, SimplexCache& cache)
+{
+    begin_manifold(a, b, out);
+    const GjkProxy pa = make_proxy(a, shapes);
+    const GjkProxy pb = make_proxy(b, shapes);
+
+    const GjkOutput gjk = gjk_distance(pa, pb, cache);
+    if (gjk.distance - pa.radius - pb.radius > margin)
+        return false;
+
+    glm::vec2 normal;
+    glm::vec2 pointB;
+    float separation;
+    if (gjk.distance > 1e-6f) {
+        normal = (gjk.pointA - gjk.pointB) / gjk.distance;
+        pointB = gjk.pointB;
+        separation = gjk.distance - pa.radius - pb.radius;
+    } else {
+        EpaOutput epa;
+        if (!epa_penetration(pa, pb, gjk, epa)) {
+            // Cores only touching: fall back to the centre line
+            const glm::vec2 d = a.position - b.position;
+            const float len = std::sqrt(dot2(d, d));
+            epa.normal = len > 1e-6f ? d / len : glm::vec2{0.0f, 1.0f};
+            epa.depth = 0.0f;
+            epa.pointB = gjk.pointB;
+        }
+        normal = epa.normal;
+        pointB = epa.pointB;
+        separation = -epa.depth - pa.radius - pb.radius;
+    }
+
+    if (pa.count > 2 && pb.count > 2) {
+        out.pointCount = clip_faces(pa, pb, normal, margin, out.points);
+        if (out.pointCount > 0)
+            return true;
+    }
+
+    ContactPoint& cp = out.points[0];
+    cp.normal = normal;
+    cp.position = pointB + normal * pb.radius;
+    cp.penetration = std::max(-separation, 0.0f);
+    cp.Pn = 0.0f;
+    cp.Pt = 0.0f;
+    cp.feature = 0;
+    out.pointCount = 1;
+    return true;
+}
+
+// --- Dispatch table ---
+
+// Pair function for shape A of body a and shape B of body b. Each pair is
+// implemented once, the mirrored order swaps the bodies and flips the
+// normal. Combinations with a plane have no narrowphase.
+template <Type A, Type B>
+static bool collide_shapes(const Body& a, const Body& b, const ShapeStore& shapes,
+                           const float margin, ContactManifold& out,
+                           SimplexCacheTable* simplices)
+{
+    if constexpr (A == Type::plane || B == Type::plane) {
+        return false;
+    } else if constexpr (A == Type::polygon || B == Type::polygon) {
+        // GJK works on any pair of cores, no mirrored entry needed
+        if (!simplices) {
+            SimplexCache cold;
+            return collide_convex(a, b, shapes, margin, out, cold);
+        }
+        return collide_convex(a, b, shapes, margin, out, simplices->get(a.id, b.id));
+    } else if constexpr (A == Type::box && B == Type::box) {
+        return collide_boxes(a, b, margin, out);
+    } else if constexpr (A == Type::circle && B == Type::circle) {
+        return collide_circles(a, b, shapes, margin, out);
+    } else if constexpr (A == Type::circle && B == Type::box) {
+        return collide_circle_box(a, b, shapes, margin, out);
+    } else if constexpr (A == Type::capsule && B == Type::circle) {
+        return collide_capsule_circle(a, b, shapes, margin, out);
+    } else if constexpr (A == Type::capsule && B == Type::box) {
+        return collide_capsule_box(a, b, shapes, margin, out);
+    } else if constexpr (A == Type::capsule && B == Type::capsule) {
+        return collide_capsules(a, b, shapes, margin, out);
+    } else {
+        if (!collide_shapes<B, A>(b, a, shapes, margin, out, simplices))
+            return false;
+        std::swap(out.bodyA, out.bodyB);
+        for (int i = 0; i < out.pointCount; ++i)
+            out.points[i].normal = -out.points[i].normal;
+        return true;
+    }
+}
+
+using PairFn = bool (*)(const Body&, const Body&, const ShapeStore&, float,
+                        ContactManifold&, SimplexCacheTable*);
+using BucketFn = void (*)(const std::vector<Body>&, const ShapeStore&,
+                          const std::vector<std::pair<uint32_t, uint32_t>>&,
+                          float, std::vector<ContactManifold>&, SimplexCacheTable*);
+
+template <Type A, Type B>
+static void collide_bucket(const std::vector<Body>& bodies, const ShapeStore& shapes,
+                           const std::vector<std::pair<uint32_t, uint32_t>>& pairs,
+                           const float margin, std::vector<ContactManifold>& out,
+                           SimplexCacheTable* simplices)
+{
+    for (const auto& [i, j]: pairs) {
+        ContactManifold m;
+        if (collide_shapes<A, B>(bodies[i], bodies[j], shapes, margin, m, simplices))
+            out.push_back(m);
+    }
+}
+
+constexpr size_t combination(const Type a, const Type b)
+{
+    return static_cast<size_t>(a) * SHAPE_TYPE_COUNT + static_cast<size_t>(b);
+}
+
+template <size_t... I>
+constexpr std::array<PairFn, sizeof...(I)> make_pair_table(std::index_sequence<I...>)
+{
+    return {&collide_shapes<static_cast<Type>(I / SHAPE_TYPE_COUNT),
+                            static_cast<Type>(I % SHAPE_TYPE_COUNT)>...};
+}
+
+template <size_t... I>
+constexpr std::array<BucketFn, sizeof...(I)> make_bucket_table(std::index_sequence<I...>)
+{
+    return {&collide_bucket<static_cast<Type>(I / SHAPE_TYPE_COUNT),
+                            static_cast<Type>(I % SHAPE_TYPE_COUNT)>...};
+}
+
+static constexpr auto s_pair_table =
+    make_pair_table(std::make_index_sequence<SHAPE_TYPE_COUNT * SHAPE_TYPE_COUNT>{});
+static constexpr auto s_bucket_table =
+    make_bucket_table(std::make_index_sequence<SHAPE_TYPE_COUNT * SHAPE_TYPE_COUNT>{});
+
+bool collide(const Body& a, const Body& b, const ShapeStore& shapes,
+             const float margin, ContactManifold& out, SimplexCacheTable* simplices)
+{
+    return s_pair_table[combination(a.shape.type, b.shape.type)](a, b, shapes, margin, out, simplices);
+}
+
+void ShapePairBuckets::add(const std::vector<Body>& bodies, const uint32_t a, const uint32_t b)
+{
+    pairs[combination(bodies[a].shape.type, bodies[b].shape.type)].emplace_back(a, b);
+}
+
+void ShapePairBuckets::clear()
+{
+    for (auto& bucket: pairs)
+        bucket.clear();
+}
+
+void collide_buckets(const std::vector<Body>& bodies, const ShapeStore& shapes,
+                     const ShapePairBuckets& buckets, const float margin,
+                     std::vector<ContactManifold>& out, SimplexCacheTable* simplices)
+{
+    for (size_t k = 0; k < buckets.pairs.size(); ++k) {
+        if (!buckets.pairs[k].empty())
+            s_bucket_table[k](bodies, shapes, buckets.pairs[k], margin, out, simplices);
+    }
+}
+
+void carry_impulses(const ContactManifold& from, ContactManifold& to)
+{
+    for (int i = 0; i < to.pointCount; ++i) {
+        for (int j = 0; j < from.pointCount; ++j) {
+            if (to.points[i].feature != from.points[j].feature)
+                continue;
+            to.points[i].Pn = from.points[j].Pn;
+            to.points[i].Pt = from.points[j].Pt;
+            break;
+        }
+    }
+}
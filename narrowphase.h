@@ -0,0 +1,88 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#ifndef ENGINELOOP_NARROWPHASE_H
+#define ENGINELOOP_NARROWPHASE_H
+#include <array>
+#include <utility>
+#include <vector>
+
+#include "body.h"
+#include "contact_manifold.h"
+#include "gjk.h"
+
+// Box with a usable extent. Boxes without halfWidth / halfHeight are
+// points and go through the CCD wall contact path instead.
+inline bool has_box_extent(const Body& b)
+{
+    return b.shape.type == Type::box && b.halfWidth > 0.0f && b.halfHeight > 0.0f;
+}
+
+// Shapes the narrowphase table handles. Planes stay with solveY.
+inline bool uses_narrowphase(const Body& b)
+{
+    return has_box_extent(b) || b.shape.type == Type::circle ||
+           b.shape.type == Type::capsule || b.shape.type == Type::polygon;
+}
+
+// All collide functions report contacts closer than margin, with the
+// normal pointing from b to a and the penetration clamped at zero.
+
+// Separating axis test for two axis aligned boxes (bodies do not rotate).
+// The normal is the axis of minimum penetration and points from b to a.
+// The two points are the ends of the overlap of the touching faces,
+// placed on the face of b. Boxes closer than margin are reported as
+// touching with zero penetration.
+bool collide_boxes(const Body& a, const Body& b, float margin, ContactManifold& out);
+
+bool collide_circles(const Body& a, const Body& b, const ShapeStore& shapes,
+                     float margin, ContactManifold& out);
+
+bool collide_circle_box(const Body& a, const Body& b, const ShapeStore& shapes,
+                        float margin, ContactManifold& out);
+
+bool collide_capsule_circle(const Body& a, const Body& b, const ShapeStore& shapes,
+                            float margin, ContactManifold& out);
+
+// One point per capsule end resting on the box, the closest point of the
+// segment when neither end touches.
+bool collide_capsule_box(const Body& a, const Body& b, const ShapeStore& shapes,
+                         float margin, ContactManifold& out);
+
+bool collide_capsules(const Body& a, const Body& b, const ShapeStore& shapes,
+                      float margin, ContactManifold& out);
+
+// Pairs with a polygon: GJK distance between the cores, EPA when they
+// overlap. When both sides have edges (polygon or box), the incident edge
+// is clipped against the reference face for up to two points, otherwise
+// one point. The simplex of the pair is read from and written to cache.
+bool collide_convex(const Body& a, const Body& b, const ShapeStore& shapes,
+                    float margin, ContactManifold& out, SimplexCache& cache);
+
+// Any two narrowphase shapes, through the dispatch table. Polygon pairs
+// keep their GJK simplex in simplices when given.
+bool collide(const Body& a, const Body& b, const ShapeStore& shapes,
+             float margin, ContactManifold& out, SimplexCacheTable* simplices = nullptr);
+
+// Candidate pairs (body indices, A first) sorted into one bucket per
+// (shape of A, shape of B). Each bucket is run by its own instance of the
+// pair loop, so the shape switch happens once per bucket, not per pair.
+struct ShapePairBuckets {
+    std::array<std::vector<std::pair<uint32_t, uint32_t>>,
+               SHAPE_TYPE_COUNT * SHAPE_TYPE_COUNT> pairs;
+
+    void add(const std::vector<Body>& bodies, uint32_t a, uint32_t b);
+    void clear();
+};
+
+// Appends the manifolds of all buckets to out, bucket by bucket.
+void collide_buckets(const std::vector<Body>& bodies, const ShapeStore& shapes,
+                     const ShapePairBuckets& buckets, float margin,
+                     std::vector<ContactManifold>& out, SimplexCacheTable* simplices = nullptr);
+
+// Copies accumulated impulses from an older manifold of the same pair to
+// the points of a new one with the same feature id.
+void carry_impulses(const ContactManifold& from, ContactManifold& to);
+
+#endif //ENGINELOOP_NARROWPHASE_H
@@ -10,14 +10,18 @@
 #include <complex>
 #include <iostream>
 #include <limits>
+#include <optional>
 #include <vector>
 #include <ranges>
 
 #include "glm/glm.hpp"
 
 #include "Integrator.h"
+#include "interpolation.h"
 #include "contact_manifold.h"
 #include "boid_flock.h"
+#include "narrowphase.h"
+#include "snapshot.h"
 
 PhysicsWorld::PhysicsWorld(const float fixed_dt_seconds)
     : m_fixed_dt(fixed_dt_seconds)
@@ -125,23 +129,278 @@ void PhysicsWorld::update(const float frame_dt_seconds)
  //   update_kinematics(frame_dt_seconds);
     m_accumulator += frame_dt_seconds;
 
+    const UpdateSettings& s = m_update_settings;
+    const bool timed = s.timeBudget > engine::duration::zero();
+    const engine::time_point start = timed ? engine::now() : engine::time_point{};
+
+    int steps = 0;
+    bool behind = false;
     while (m_accumulator >= m_fixed_dt) {
+        if ((s.maxSubsteps > 0 && steps >= s.maxSubsteps) ||
+            (timed && steps > 0 && engine::now() - start >= s.timeBudget)) {
+            behind = true;
+            break;
+        }
         fixed_step(m_fixed_dt);
         m_accumulator -= m_fixed_dt;
-        ++m_steps;
+        ++steps;
+    }
+
+    if (!behind)
+        return;
+
+    ++m_fell_behind;
+    float keep;
+    if (s.overrun == OverrunPolicy::SlowDown)
+        keep = static_cast<float>(steps) * m_fixed_dt;
+    else
+        keep = std::fmod(m_accumulator, m_fixed_dt);
+    if (m_accumulator > keep) {
+        m_dropped_time += m_accumulator - keep;
+        m_accumulator = keep;
     }
 }
 
 void PhysicsWorld::fixed_step(float dt)
 {
+    if (m_deterministic) {
+        const DeterministicFpScope fp;
+        step_world(dt, true);
+        if (m_flock)
+            m_flock->step(dt);
+        chain_state_hash();
+        ++m_steps;
+        notify_step_listeners();
+        return;
+    }
+    step_world(dt, true);
+    if (m_flock)
+        m_flock->step(dt);
+    ++m_steps;
+    notify_step_listeners();
+}
+
+// Everything that is the same for all n steps is done once: the FP
+// environment, the flock lookup and buffer sizing.
+// The accumulator is not touched, step_n is not tied to wall time.
+void PhysicsWorld::step_n(const std::uint32_t n, const bool observe_every_step)
+{
+    if (n == 0)
+        return;
+
+    std::optional<DeterministicFpScope> fp;
+    if (m_deterministic)
+        fp.emplace();
+
+    m_prev_positions.reserve(bodies.size());
+    m_pairs.reserve(bodies.size() * 4);
+
+    Flock* const flock = m_flock;
+    const float dt = m_fixed_dt;
+    for (std::uint32_t i = 0; i < n; ++i) {
+        const bool observe = observe_every_step || i + 1 == n;
+        step_world(dt, observe);
+        if (flock)
+            flock->step(dt);
+        if (m_deterministic)
+            chain_state_hash();
+        ++m_steps;
+        if (observe)
+            notify_step_listeners();
+    }
+}
+
+void PhysicsWorld::step_once(const bool observe)
+{
+    std::optional<DeterministicFpScope> fp;
+    if (m_deterministic)
+        fp.emplace();
+
+    step_world(m_fixed_dt, observe);
+    if (m_flock)
+        m_flock->step(m_fixed_dt);
+    if (m_deterministic)
+        chain_state_hash();
+    ++m_steps;
+    if (observe)
+        notify_step_listeners();
+}
+
+void PhysicsWorld::add_step_listener(StepListener* listener)
+{
+    if (std::ranges::find(m_listeners, listener) == m_listeners.end())
+        m_listeners.push_back(listener);
+}
+
+void PhysicsWorld::remove_step_listener(StepListener* listener)
+{
+    std::erase(m_listeners, listener);
+}
+
+void PhysicsWorld::notify_step_listeners()
+{
+    for (StepListener* listener: m_listeners)
+        listener->on_step(*this);
+}
+
+void PhysicsWorld::chain_state_hash()
+{
+    StateHash h(m_state_hash);
+    hash_state(h);
+    m_state_hash = h.value();
+}
+
+void PhysicsWorld::hash_state(StateHash& h) const
+{
+    h.add(static_cast<uint32_t>(bodies.size()));
+    for (const Body& b: bodies)
+        hash_body(h, b);
+    hash_shapes(h, m_shapes);
+
+    h.add(static_cast<uint32_t>(manifolds.size()));
+    for (const ContactManifold& m: manifolds) {
+        h.add(m.bodyA);
+        h.add(m.bodyB);
+        for (int i = 0; i < m.pointCount; ++i) {
+            h.add(m.points[i].Pn);
+            h.add(m.points[i].Pt);
+            h.add(m.points[i].feature);
+        }
+    }
+
+    if (m_flock)
+        m_flock->hash_state(h);
+}
+
+namespace {
+enum WorldSection : uint32_t {
+    WORLD_STATE = 1,
+    WORLD_SOLVER_SETTINGS,
+    WORLD_UPDATE_SETTINGS,
+    WORLD_BODIES,
+    WORLD_PREV_POSITIONS,
+    WORLD_CIRCLES,
+    WORLD_CAPSULES,
+    WORLD_POLYGONS,
+    WORLD_MANIFOLDS,
+    WORLD_SIMPLICES
+};
+
+struct WorldState {
+    float fixedDt;
+    float accumulator;
+    std::uint64_t steps;
+    std::uint64_t fellBehind;
+    double droppedTime;
+    std::uint64_t stateHash;
+    std::uint64_t cacheCapacity;
+    std::uint32_t deterministic;
+    std::uint32_t reserved;
+};
+}
+
+// The broadphase keeps nothing between steps and emits its pairs in body
+// order, so it needs no section. The contact cache after a step only
+// holds the manifolds of that step and is rebuilt from them on load.
+void PhysicsWorld::save_snapshot(std::vector<std::byte>& out) const
+{
+    const WorldState state{m_fixed_dt, m_accumulator, m_steps, m_fell_behind,
+                           m_dropped_time, m_state_hash, m_contact_cache.capacity(),
+                           m_deterministic ? 1u : 0u, 0};
+
+    SnapshotWriter w(out, SnapshotKind::World);
+    w.write_value(WORLD_STATE, state);
+    w.write_value(WORLD_SOLVER_SETTINGS, m_solver_settings);
+    w.write_value(WORLD_UPDATE_SETTINGS, m_update_settings);
+    w.write(WORLD_BODIES, std::span(bodies));
+    w.write(WORLD_PREV_POSITIONS, std::span(m_prev_positions));
+    w.write(WORLD_CIRCLES, std::span(m_shapes.circles));
+    w.write(WORLD_CAPSULES, std::span(m_shapes.capsules));
+    w.write(WORLD_POLYGONS, std::span(m_shapes.polygons));
+    w.write(WORLD_MANIFOLDS, std::span(manifolds));
+    w.begin<SimplexCacheEntry>(WORLD_SIMPLICES, m_simplices.size());
+    m_simplices.for_each([&](const SimplexCacheEntry& e) { w.add(e); });
+    w.end();
+    w.finish();
+}
+
+bool PhysicsWorld::accepts_snapshot(const std::span<const std::byte> in) const
+{
+    const SnapshotReader r(in, SnapshotKind::World);
+    if (!r.has<WorldState>(WORLD_STATE, true) ||
+        !r.has<SolverSettings>(WORLD_SOLVER_SETTINGS, true) ||
+        !r.has<UpdateSettings>(WORLD_UPDATE_SETTINGS, true) ||
+        !r.has<Body>(WORLD_BODIES) ||
+        !r.has<glm::vec2>(WORLD_PREV_POSITIONS) ||
+        !r.has<CircleShape>(WORLD_CIRCLES) ||
+        !r.has<CapsuleShape>(WORLD_CAPSULES) ||
+        !r.has<PolygonShape>(WORLD_POLYGONS) ||
+        !r.has<ContactManifold>(WORLD_MANIFOLDS) ||
+        !r.has<SimplexCacheEntry>(WORLD_SIMPLICES))
+        return false;
+
+    WorldState state;
+    r.read_value(WORLD_STATE, state);
+    return state.fixedDt == m_fixed_dt;
+}
+
+bool PhysicsWorld::load_snapshot(const std::span<const std::byte> in)
+{
+    if (!accepts_snapshot(in))
+        return false;
+
+    const SnapshotReader r(in, SnapshotKind::World);
+    WorldState state;
+    r.read_value(WORLD_STATE, state);
+    r.read_value(WORLD_SOLVER_SETTINGS, m_solver_settings);
+    r.read_value(WORLD_UPDATE_SETTINGS, m_update_settings);
+    r.read(WORLD_BODIES, bodies);
+    r.read(WORLD_PREV_POSITIONS, m_prev_positions);
+    r.read(WORLD_CIRCLES, m_shapes.circles);
+    r.read(WORLD_CAPSULES, m_shapes.capsules);
+    r.read(WORLD_POLYGONS, m_shapes.polygons);
+    r.read(WORLD_MANIFOLDS, manifolds);
+
+    std::vector<SimplexCacheEntry> simplices;
+    r.read(WORLD_SIMPLICES, simplices);
+    m_simplices.restore(simplices);
+    m_contact_cache.restore(manifolds, state.cacheCapacity);
+
+    m_accumulator = state.accumulator;
+    m_steps = state.steps;
+    m_fell_behind = state.fellBehind;
+    m_dropped_time = state.droppedTime;
+    m_state_hash = state.stateHash;
+    m_deterministic = state.deterministic != 0;
+    return true;
+}
+
+// observe: also produce what only observers read (previous positions
+// for interpolation, leftover penetration in the solver stats)
+void PhysicsWorld::step_world(const float dt, const bool observe)
+{
+    if (observe) {
+        m_prev_positions.resize(bodies.size());
+        for (size_t i = 0; i < bodies.size(); ++i)
+            m_prev_positions[i] = bodies[i].position;
+    }
+
     integrate(bodies,dt);
     step_bodies_with_ccd(dt, manifolds);
-    solve_contacts(dt, 0.0);
-    solve_split_impulse(dt);
-    integrate_pseudo(dt);
 
-    if (m_flock)
-        m_flock->step(dt);
+    if (m_solver_settings.mode == SolverMode::SoftStep) {
+        solve_contacts_substepped(dt, 0.0);
+    } else {
+        solve_contacts(dt, 0.0);
+        if (m_solver_settings.positionSolver == PositionSolver::NonLinearGaussSeidel) {
+            solve_positions();
+        } else {
+            solve_split_impulse(dt);
+            integrate_pseudo(dt);
+        }
+    }
+    if (observe)
+        contact_solver.measure_penetration(bodies);
 }
 
 static TOIResult compute_toi_1d(const float x0, const float v0, const float a,
@@ -201,16 +460,89 @@ static TOIResult compute_toi_1d(const float x0, const float v0, const float a,
     return r;
 }
 
+// Narrowphase pairs are only checked once per step, a pair that moves
+// further than its smaller extent in one step can pass through. Such a
+// pair is swept as two boxes (the shape bounds) over the whole step: from
+// the start, recovered from the integrated velocity, to the end, which for
+// dynamic bodies includes the second integration in solveY. On a hit along
+// an axis where the motion is that large both bodies are put where they
+// were at the time of impact and the approach speed along that axis is
+// taken out, like check_ccd does, so the narrowphase sees them touching.
+static bool sweep_fast_pair(Body& a, Body& b, const float dt)
+{
+    if (a.type != BodyType::Dynamic && b.type != BodyType::Dynamic)
+        return false;
+
+    auto step_end = [dt](const Body& body) {
+        return body.type == BodyType::Dynamic
+            ? body.position + (body.velocity + body.acceleration * dt) * dt
+            : body.position;
+    };
+    const glm::vec2 startA = a.position - a.velocity * dt;
+    const glm::vec2 startB = b.position - b.velocity * dt;
+    const glm::vec2 moveA = step_end(a) - startA;
+    const glm::vec2 moveB = step_end(b) - startB;
+
+    const glm::vec2 d = moveA - moveB;
+    const glm::vec2 thin{std::min(a.halfWidth, b.halfWidth), std::min(a.halfHeight, b.halfHeight)};
+    if (std::abs(d.x) <= thin.x && std::abs(d.y) <= thin.y)
+        return false;
+
+    const glm::vec2 ext{a.halfWidth + b.halfWidth, a.halfHeight + b.halfHeight};
+    const glm::vec2 r0 = startA - startB;
+    if (std::abs(r0.x) < ext.x && std::abs(r0.y) < ext.y)
+        return false;   // overlapping already, the narrowphase has it
+
+    // Slab test of the relative path against the summed boxes
+    float tEnter = 0.0f;
+    float tExit = 1.0f;
+    int axis = -1;
+    for (int k = 0; k < 2; ++k) {
+        if (std::abs(d[k]) < PhysicsWorld::eps) {
+            if (std::abs(r0[k]) >= ext[k])
+                return false;
+            continue;
+        }
+        const float t1 = (-ext[k] - r0[k]) / d[k];
+        const float t2 = (ext[k] - r0[k]) / d[k];
+        if (std::min(t1, t2) > tEnter) {
+            tEnter = std::min(t1, t2);
+            axis = k;
+        }
+        tExit = std::min(tExit, std::max(t1, t2));
+    }
+    if (axis < 0 || tEnter > tExit || std::abs(d[axis]) <= thin[axis])
+        return false;
+
+    a.position = startA + moveA * tEnter;
+    b.position = startB + moveB * tEnter;
+
+    // Perfectly inelastic along the axis, a non-dynamic body keeps its speed
+    float& va = a.velocity[axis];
+    float& vb = b.velocity[axis];
+    const float invA = a.type == BodyType::Dynamic ? a.invMass : 0.0f;
+    const float invB = b.type == BodyType::Dynamic ? b.invMass : 0.0f;
+    if (invA + invB > 0.0f) {
+        const float common = (invB * va + invA * vb) / (invA + invB);
+        va = common;
+        vb = common;
+    }
+    return true;
+}
+
 void PhysicsWorld::step_bodies_with_ccd(
     const float dt, std::vector<ContactManifold> &contact_manifolds)
 {
+    // Solved impulses go back to the cache, they warm start this step
+    m_contact_cache.begin_step(contact_manifolds);
     contact_manifolds.clear();
+    m_swept.assign(bodies.size(), 0);
 
     // Broadphase: build grid and get candidate pairs
     broadphase.build(bodies);
-    auto pairs = broadphase.computePairs();
+    broadphase.computePairs(m_pairs);
 
-    for (auto [i, j] : pairs) {
+    for (auto [i, j] : m_pairs) {
         Body& a = bodies[i];
         Body& b = bodies[j];
 
@@ -224,6 +556,24 @@ void PhysicsWorld::step_bodies_with_ccd(
         if (b.type == BodyType::Static && b.shape.type == Type::plane)
             continue;
 
+        // Shapes with an extent go to the narrowphase table, grouped by
+        // shape combination and collided after the loop. A body put back
+        // to a time of impact is not swept again, its start position can
+        // no longer be recovered from the velocity.
+        if (uses_narrowphase(a) && uses_narrowphase(b)) {
+            if (!m_swept[i] && !m_swept[j] && sweep_fast_pair(a, b, dt))
+                m_swept[i] = m_swept[j] = 1;
+
+            // A is the body that moves (dynamic before kinematic before
+            // static), the normal points towards it
+            const bool swapRoles = a.type == BodyType::Static ||
+                (a.type == BodyType::Kinematic && b.type == BodyType::Dynamic);
+            const auto ia = static_cast<uint32_t>(i);
+            const auto ib = static_cast<uint32_t>(j);
+            m_shape_pairs.add(bodies, swapRoles ? ib : ia, swapRoles ? ia : ib);
+            continue;
+        }
+
         // Determine roles: moving body vs wall
         // For dynamic-dynamic, check both directions
         if (a.type == BodyType::Dynamic && b.type == BodyType::Dynamic) {
@@ -270,6 +620,15 @@ void PhysicsWorld::step_bodies_with_ccd(
         }
     }
 
+    m_narrow_manifolds.clear();
+    collide_buckets(bodies, m_shapes, m_shape_pairs, slop, m_narrow_manifolds, &m_simplices);
+    m_shape_pairs.clear();
+    m_simplices.end_step();
+    for (const ContactManifold& m: m_narrow_manifolds)
+        merge_manifold(contact_manifolds, m);
+
+    m_contact_cache.end_step();
+
     // Solve Y for all dynamic bodies (platform collision)
     for (Body& body : bodies) {
         if (body.type == BodyType::Dynamic)
@@ -348,6 +707,14 @@ std::uint64_t PhysicsWorld::step_count() const noexcept { return m_steps; }
 
 float PhysicsWorld::accumulator() const { return m_accumulator; }
 
+void PhysicsWorld::interpolated_positions(const float alpha, std::vector<glm::vec2>& out) const
+{
+    out.resize(bodies.size());
+    for (size_t i = 0; i < bodies.size(); ++i)
+        out[i] = bodies[i].position;
+    interpolate(m_prev_positions, out, alpha, out);
+}
+
 const std::vector<ContactManifold> &PhysicsWorld::getManifolds() const
 {
     return manifolds;
@@ -355,6 +722,70 @@ const std::vector<ContactManifold> &PhysicsWorld::getManifolds() const
 
 std::vector<Body> &PhysicsWorld::getBodies() { return bodies; }
 
+bool PhysicsWorld::add_circle(Body b, const float radius)
+{
+    b.shape.type = Type::circle;
+    b.shape.index = static_cast<uint32_t>(m_shapes.circles.size());
+    b.halfWidth = radius;
+    b.halfHeight = radius;
+    if (!(radius > 0.0f) || !fits_broadphase_cell(b))
+        return false;
+    m_shapes.circles.push_back({radius});
+    bodies.push_back(b);
+    return true;
+}
+
+bool PhysicsWorld::add_polygon(Body b, const std::span<const glm::vec2> vertices)
+{
+    if (vertices.size() < 3 || vertices.size() > MAX_POLYGON_VERTICES)
+        return false;
+
+    PolygonShape poly{};
+    poly.count = static_cast<uint32_t>(vertices.size());
+    float area = 0.0f;
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const glm::vec2 p = vertices[i];
+        const glm::vec2 q = vertices[(i + 1) % vertices.size()];
+        area += p.x * q.y - p.y * q.x;
+    }
+    // Clockwise input is turned around
+    for (uint32_t i = 0; i < poly.count; ++i)
+        poly.vertices[i] = area >= 0.0f ? vertices[i] : vertices[poly.count - 1 - i];
+
+    b.halfWidth = 0.0f;
+    b.halfHeight = 0.0f;
+    for (uint32_t i = 0; i < poly.count; ++i) {
+        const glm::vec2 e = poly.vertices[(i + 1) % poly.count] - poly.vertices[i];
+        const float len = std::sqrt(e.x * e.x + e.y * e.y);
+        if (len <= 0.0f)
+            return false;
+        poly.normals[i] = glm::vec2{e.y, -e.x} / len;
+        b.halfWidth = std::max(b.halfWidth, std::abs(poly.vertices[i].x));
+        b.halfHeight = std::max(b.halfHeight, std::abs(poly.vertices[i].y));
+    }
+    if (!fits_broadphase_cell(b))
+        return false;
+
+    b.shape.type = Type::polygon;
+    b.shape.index = static_cast<uint32_t>(m_shapes.polygons.size());
+    m_shapes.polygons.push_back(poly);
+    bodies.push_back(b);
+    return true;
+}
+
+bool PhysicsWorld::add_capsule(Body b, const glm::vec2 halfSegment, const float radius)
+{
+    b.shape.type = Type::capsule;
+    b.shape.index = static_cast<uint32_t>(m_shapes.capsules.size());
+    b.halfWidth = std::abs(halfSegment.x) + radius;
+    b.halfHeight = std::abs(halfSegment.y) + radius;
+    if (!(radius > 0.0f) || !fits_broadphase_cell(b))
+        return false;
+    m_shapes.capsules.push_back({halfSegment, radius});
+    bodies.push_back(b);
+    return true;
+}
+
 /* This engine is not an event-driven system, it is a fixed timestep simulation.
  * Discrete wall contact is the function that checks the positions to decide
  * whether contact still exists or not. This solved the secondly opened issue
@@ -391,102 +822,47 @@ bool PhysicsWorld::discrete_wall_contact(
     return true;
 }
 
+// Pairs are looked up in the contact cache instead of scanning dst, and
+// a pair seen last step starts from the impulses it ended with.
 void PhysicsWorld::merge_manifold(std::vector<ContactManifold> &dst,
                                   const ContactManifold &m)
 {
-    for (auto &e: dst) {
-        if (e.bodyA == m.bodyA && e.bodyB == m.bodyB) {
-            ContactManifold merged = m;
-
-            // --- carry accumulated impulses ---
-            if (e.pointCount > 0 && merged.pointCount > 0) {
-                merged.points[0].Pn = e.points[0].Pn;
-                merged.points[0].Pt = e.points[0].Pt;
-            }
-
-            e = merged;
-            return;
-        }
-    }
-    dst.push_back(m);
+    m_contact_cache.merge(dst, m);
 }
 
+// Sequential impulses: rows are prepared once per step, warm started with
+// the impulses carried by the manifolds, then iterated. Every iteration
+// refines the accumulated impulses of all contacts, which is what lets
+// a stack propagate support from the ground up to the top body.
+// Independent islands go to the thread pool when one is attached.
 void PhysicsWorld::solve_contacts(float dt, float restitution)
 {
     (void)dt;
-    (void)restitution;
-    for (ContactManifold &m: manifolds) {
-        if (m.pointCount == 0)
-            continue;
-
-        Body *A = nullptr;
-        Body *B = nullptr;
-
-        for (auto &b: bodies) {
-            if (b.id == m.bodyA)
-                A = &b;
-            if (b.id == m.bodyB)
-                B = &b;
-        }
-        if (!A || !B)
-            continue;
-
-        ContactPoint &cp = m.points[0];
-        const glm::vec2 n = cp.normal;
-        glm::vec2 t = {-n.y, n.x};
-
-        // --- RELATIVE VELOCITY ---
-        glm::vec2 vrel = A->velocity;
-
-        float vn = glm::dot(vrel, n);
-        if (vn >= 0.0)
-            continue;
-
-        float dPn = -vn / A->invMass;
-        float Pn0 = cp.Pn;
-        cp.Pn = std::max(Pn0 + dPn, 0.0f);
-        dPn = cp.Pn - Pn0;
-
-        A->velocity += n * static_cast<float>(dPn * A->invMass);
-
-        float vt = glm::dot(vrel, t);
-        float dPt = -vt / A->invMass;
-        float Pt0 = cp.Pt;
+    contact_solver.prepare(bodies, manifolds, m_solver_settings, restitution);
+    contact_solver.solve(bodies, m_solver_settings, m_pool);
+    contact_solver.store_impulses(manifolds);
+}
 
-        float mu = 0.5;
-        float maxPt = mu * cp.Pn;
-        cp.Pt = std::clamp(Pt0 + dPt, -maxPt, maxPt);
-        dPt = cp.Pt - Pt0;
-    }
+// Detection and row preparation once per step, then cheap substeps of
+// soft contacts. Overlap is resolved by the contact springs, so there is
+// no split impulse pass in this mode.
+void PhysicsWorld::solve_contacts_substepped(const float dt, const float restitution)
+{
+    contact_solver.prepare(bodies, manifolds, m_solver_settings, restitution);
+    contact_solver.solve_soft(bodies, m_solver_settings, dt, m_pool);
+    contact_solver.store_impulses(manifolds);
 }
 
+// Works on the rows prepared by solve_contacts in the same step.
 void PhysicsWorld::solve_split_impulse(const float dt)
 {
-    for (const ContactManifold &m: manifolds) {
-        Body *A = nullptr;
-        Body *B = nullptr;
-
-        for (auto &b: bodies) {
-            if (b.id == m.bodyA)
-                A = &b;
-            if (b.id == m.bodyB)
-                B = &b;
-        }
-        if (!A || !B)
-            continue;
-
-        const ContactPoint &cp = m.points[0];
-        const glm::vec2 &n = cp.normal;
-
-        const float p = cp.penetration;
-        if (p <= 0.0)
-            continue;
-
-        const float lambda = p / (dt * A->invMass);
+    contact_solver.solve_split_impulse(bodies, dt, m_solver_settings, m_pool);
+}
 
-        A->pseudoVelocity.x += (lambda * A->invMass) * n.x;
-        A->pseudoVelocity.y += (lambda * A->invMass) * n.y;
-    }
+// Replaces solve_split_impulse + integrate_pseudo, same rows.
+void PhysicsWorld::solve_positions()
+{
+    contact_solver.solve_positions(bodies, m_solver_settings, m_pool);
 }
 
 // pseudo/split impulse for position correction
@@ -4,14 +4,51 @@
 
 #ifndef PHYSICS_WORLD_H
 #define PHYSICS_WORLD_H
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <span>
 #include <vector>
 
 #include "body.h"
 #include "Broadphase.h"
+#include "contact_cache.h"
 #include "contact_manifold.h"
+#include "contact_solver.h"
+#include "determinism.h"
+#include "engine_time.h"
+#include "narrowphase.h"
 
 class Flock;
+class PhysicsWorld;
+class ThreadPool;
+
+// Hook for recorders and exporters, see PhysicsWorld::add_step_listener()
+class StepListener {
+public:
+    virtual ~StepListener() = default;
+    virtual void on_step(const PhysicsWorld& world) = 0;
+};
+
+// What update() does with frame time it could not simulate
+enum class OverrunPolicy {
+    // keep only the fraction of a step, the world falls behind real time
+    DropTime,
+    // carry up to one update worth of steps into the next frame, the
+    // world runs slower for a while and catches up when frames get cheap
+    SlowDown
+};
+
+// Limits of one update() call. Without them a frame that took longer than
+// the steps it simulated makes the next frame even longer (spiral of death).
+struct UpdateSettings {
+    // Fixed steps per update(), 0 = no limit
+    int maxSubsteps = 0;
+    // Wall clock time update() may spend stepping, zero = no limit.
+    // At least one step runs per call so the world always advances.
+    engine::duration timeBudget = engine::duration::zero();
+    OverrunPolicy overrun = OverrunPolicy::DropTime;
+};
 
 class PhysicsWorld {
 public:
@@ -27,6 +64,19 @@ public:
 
     bool check_flock() const { return (m_flock != nullptr);}
 
+    [[nodiscard]] const Flock* flock() const { return m_flock; }
+
+    [[nodiscard]] float fixed_dt() const { return m_fixed_dt; }
+
+    // Optional: independent contact islands are solved on the pool.
+    void attach_thread_pool(ThreadPool* pool) { m_pool = pool; }
+
+    SolverSettings& solver_settings() { return m_solver_settings; }
+    [[nodiscard]] const SolverSettings& solver_settings() const { return m_solver_settings; }
+
+    UpdateSettings& update_settings() { return m_update_settings; }
+    [[nodiscard]] const UpdateSettings& update_settings() const { return m_update_settings; }
+
     void update_kinematics(float dt);
 
     bool collidesWithGround(const Body& b);
@@ -37,6 +87,27 @@ public:
 
     void fixed_step(float dt);
 
+    // n fixed steps of fixed_dt back to back, for catching up and
+    // offline runs. Counts in step_count(), leaves the accumulator alone.
+    // Unless observe_every_step is set, the data only observers read
+    // (previous positions, penetration stats) is produced for the last
+    // step only. Contacts, impulses and the lockstep hash are kept up to
+    // date every step, the next step depends on them.
+    void step_n(std::uint32_t n, bool observe_every_step = false);
+
+    // One step of fixed_dt, counted in step_count(). Without observe it
+    // skips the observer data like the inner steps of step_n. Rollback
+    // catch-up runs each step through here with its input in between.
+    void step_once(bool observe);
+
+    // Listeners run on the stepping thread at the end of every step that
+    // produces observer data: each fixed_step, the last step of step_n
+    // (all of them with observe_every_step) and step_once with observe.
+    // Rollback catch-up therefore reports only the corrected present.
+    void add_step_listener(StepListener* listener);
+    void remove_step_listener(StepListener* listener);
+
+    // Steps taken by fixed_step, step_n and step_once
     [[nodiscard]] std::uint64_t step_count() const noexcept;
 
     void step_bodies_with_ccd(float dt, std::vector<ContactManifold> &contact_manifolds);
@@ -49,15 +120,89 @@ public:
 
     [[nodiscard]] float accumulator() const;
 
+    // How far the unsimulated time in the accumulator reaches into the
+    // next step, 0..1. Rendering blends previous and current positions
+    // by this.
+    [[nodiscard]] float alpha() const { return std::min(m_accumulator / m_fixed_dt, 1.0f); }
+
+    // Body positions at the start of the last fixed_step, by body index
+    [[nodiscard]] const std::vector<glm::vec2>& previous_positions() const { return m_prev_positions; }
+
+    // Body positions blended alpha of the way from the previous step
+    void interpolated_positions(float alpha, std::vector<glm::vec2>& out) const;
+
+    // update() calls that hit maxSubsteps or timeBudget
+    [[nodiscard]] std::uint64_t fell_behind_count() const { return m_fell_behind; }
+
+    // Simulation time thrown away by the overrun policy, in seconds
+    [[nodiscard]] double dropped_time() const { return m_dropped_time; }
+
     void solve_contacts(float dt, float restitution);
 
+    void solve_contacts_substepped(float dt, float restitution);
+
     void solve_split_impulse(float dt);
 
+    void solve_positions();
+
     void integrate_pseudo(float dt);
 
     [[nodiscard]] const std::vector<ContactManifold>& getManifolds() const;
 
+    // Iterations, velocity errors, impulses and leftover overlap of the
+    // last fixed_step
+    [[nodiscard]] const SolverStats& solver_stats() const { return contact_solver.stats(); }
+
+    // Touching pairs kept across steps, with begin / persist / end events
+    [[nodiscard]] const ContactCache& contact_cache() const { return m_contact_cache; }
+
     std::vector<Body>& getBodies();
+    [[nodiscard]] const std::vector<Body>& getBodies() const { return bodies; }
+
+    // Append a body with a circle / capsule shape. halfWidth and halfHeight
+    // are set to the bounding box of the shape. The box may be at most
+    // Body::ALLOWED_BODY_SIZE wide and high, the broadphase cell size;
+    // false (and nothing added) for a larger shape or a radius <= 0.
+    bool add_circle(Body b, float radius);
+    bool add_capsule(Body b, glm::vec2 halfSegment, float radius);
+    // 3 to MAX_POLYGON_VERTICES convex vertices around the body position,
+    // false (and nothing added) when the count is out of range, an edge
+    // has zero length or the bounding box is over ALLOWED_BODY_SIZE.
+    bool add_polygon(Body b, std::span<const glm::vec2> vertices);
+
+    [[nodiscard]] const ShapeStore& shapes() const { return m_shapes; }
+    // For bulk loading: Body::shape.index has to stay valid
+    ShapeStore& shapes() { return m_shapes; }
+
+    // Lockstep mode: every fixed_step runs in the default floating point
+    // environment and ends by folding the world state into state_hash().
+    // Peers that feed the same input compare state_hash() every step.
+    void set_deterministic(bool on) { m_deterministic = on; }
+    [[nodiscard]] bool deterministic() const { return m_deterministic; }
+
+    // Chained hash of every step since set_deterministic(true),
+    // 0 before the first one. It does not cover an RVOSolver: the crowd
+    // is stepped by the caller, who has to chain RVOSolver::hashState()
+    // onto this value to compare it (sim_server does for hash=).
+    [[nodiscard]] std::uint64_t state_hash() const { return m_state_hash; }
+
+    // Bodies, shapes, manifold impulses and the attached flock
+    void hash_state(StateHash& h) const;
+
+    // Full state between two steps in the flat format of snapshot.h:
+    // bodies, shapes, manifolds with their impulses, the GJK simplex
+    // caches, previous positions, accumulator, counters, lockstep hash
+    // and settings. out is overwritten and keeps its capacity, so saving
+    // every step does not allocate. The attached flock saves itself.
+    void save_snapshot(std::vector<std::byte>& out) const;
+
+    // Continues from a save_snapshot() exactly as the saved world would
+    // have. false (world untouched) when in is not a world snapshot of
+    // this build or was taken with another fixed_dt.
+    bool load_snapshot(std::span<const std::byte> in);
+
+    // true when load_snapshot(in) would succeed, without loading it
+    [[nodiscard]] bool accepts_snapshot(std::span<const std::byte> in) const;
 
     bool discrete_wall_contact(
     const Body& b,
@@ -70,13 +215,34 @@ public:
 );
 
 private:
+    void step_world(float dt, bool observe);
+    void chain_state_hash();
+    void notify_step_listeners();
+
     Broadphase broadphase;
+    ContactSolver contact_solver;
+    SolverSettings m_solver_settings;
+    UpdateSettings m_update_settings;
     std::vector<ContactManifold> manifolds;
+    ContactCache m_contact_cache;
+    ShapeStore m_shapes;
+    ShapePairBuckets m_shape_pairs;
+    std::vector<std::pair<int,int>> m_pairs;    // broadphase output, reused
+    std::vector<uint8_t> m_swept;   // bodies put back to a time of impact this step
+    SimplexCacheTable m_simplices;
+    std::vector<ContactManifold> m_narrow_manifolds;
     std::vector<Body> bodies;
+    std::vector<glm::vec2> m_prev_positions;
     const float m_fixed_dt;
     float m_accumulator = 0.0;
     std::uint64_t m_steps = 0;
+    std::uint64_t m_fell_behind = 0;
+    double m_dropped_time = 0.0;
+    bool m_deterministic = false;
+    std::uint64_t m_state_hash = 0;
     Flock* m_flock = nullptr;
+    ThreadPool* m_pool = nullptr;
+    std::vector<StepListener*> m_listeners;
 };
 
 
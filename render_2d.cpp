@@ -139,4 +139,14 @@ void render_2d::render(PhysicsWorld& world, Flock& flock)
     handleEvents();
 
     draw_frame(m_renderer, world, &flock, m_playerTexture);
+}
+
+void render_2d::render(const RenderSnapshot& snapshot)
+{
+    if (!isValid())
+        return;
+
+    handleEvents();
+
+    draw_frame(m_renderer, snapshot, m_playerTexture);
 }
\ No newline at end of file
@@ -10,6 +10,7 @@
 
 class PhysicsWorld;
 class Flock;
+struct RenderSnapshot;
 
 class render_2d {
 public:
@@ -23,6 +24,7 @@ public:
     void handleEvents();
     void render(PhysicsWorld& world);
     void render(PhysicsWorld& world, Flock& flock);
+    void render(const RenderSnapshot& snapshot);
 
     void loadTexture(const std::string& path);
     SDL_Texture* playerTexture() const { return m_playerTexture; }
@@ -10,20 +10,6 @@
 
 #include "contact.h"
 
-float interpolate(float prev, float curr, float alpha) {
-    return prev + (curr - prev) * alpha;
-}
-
-glm::vec2 interpolate(const glm::vec2& prev,
-                 const glm::vec2& curr,
-                 float alpha)
-{
-    return glm::vec2{
-        interpolate(prev.x, curr.x, alpha),
-        interpolate(prev.y, curr.y, alpha)
-    };
-}
-
 
 void render_console(float x, float wall_x) {
     constexpr int width = 60;
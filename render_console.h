@@ -8,6 +8,7 @@
 #include <string>
 
 #include "contact_manifold.h"
+#include "interpolation.h"
 #include "glm/vec2.hpp"
 
 struct ScreenPoint {
@@ -15,11 +16,7 @@ struct ScreenPoint {
     int y;
 };
 
-float interpolate(float prev, float curr, float alpha);
 void render_console(float x, float wall_x);
-glm::vec2 interpolate(const glm::vec2& prev,
-                 const glm::vec2& curr,
-                 float alpha);
 void render_console_2d(const glm::vec2& pos,
                        float wall_x,
                        int width,
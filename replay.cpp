@@ -0,0 +1,364 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#include "replay.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+struct ReplayHeader {
+    std::uint32_t magic;
+    std::uint16_t version;
+    std::uint16_t reserved;
+    float fixedDt;
+    float quantum;
+};
+
+static void put_varint(std::vector<std::uint8_t>& out, std::uint64_t v)
+{
+    while (v >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(v));
+}
+
+// Small magnitudes of either sign become small unsigned numbers
+static void put_zigzag(std::vector<std::uint8_t>& out, const std::int64_t v)
+{
+    put_varint(out, (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63));
+}
+
+static bool get_varint(const std::uint8_t*& p, const std::uint8_t* end, std::uint64_t& out)
+{
+    out = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        const std::uint8_t byte = *p++;
+        out |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+static bool get_zigzag(const std::uint8_t*& p, const std::uint8_t* end, std::int64_t& out)
+{
+    std::uint64_t v;
+    if (!get_varint(p, end, v))
+        return false;
+    out = static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+    return true;
+}
+
+// Positions that are not finite or absurdly far out are recorded at the
+// origin rather than overflowing the integer
+static std::int64_t quantise(const float v, const double inv_quantum)
+{
+    const double q = std::nearbyint(static_cast<double>(v) * inv_quantum);
+    if (!std::isfinite(q) || std::abs(q) > 4.0e18)
+        return 0;
+    return static_cast<std::int64_t>(q);
+}
+
+// ============================================================
+// ReplayRecorder
+// ============================================================
+
+ReplayRecorder::~ReplayRecorder()
+{
+    close();
+}
+
+bool ReplayRecorder::open(const std::string& path, const float fixed_dt,
+                          const ReplaySettings& settings)
+{
+    if (m_ring || settings.quantum <= 0.0f)
+        return false;
+
+    auto out = std::make_unique<std::ofstream>(path, std::ios::binary | std::ios::trunc);
+    if (!*out)
+        return false;
+
+    const ReplayHeader header{REPLAY_MAGIC, REPLAY_VERSION, 0, fixed_dt, settings.quantum};
+    out->write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!*out)
+        return false;
+
+    m_settings = settings;
+    m_ring = std::make_unique<GrowingSpscRing<std::uint8_t>>(settings.ringBytes);
+    m_bytes.store(sizeof(header), std::memory_order_relaxed);
+    m_ids.clear();
+    m_quantised.clear();
+    m_last_step = 0;
+    m_last_key = 0;
+    m_need_key = true;
+    m_frames = 0;
+    m_keyframes = 0;
+    m_dropped = 0;
+    m_stop.store(false, std::memory_order_relaxed);
+    m_writer = std::thread(&ReplayRecorder::writer_loop, this, std::move(out));
+    return true;
+}
+
+void ReplayRecorder::close()
+{
+    if (!m_ring)
+        return;
+    m_stop.store(true, std::memory_order_release);
+    m_writer.join();
+    m_ring.reset();
+}
+
+// The stop flag is read before the ring, so every frame pushed before
+// close() is on disk when the loop ends
+void ReplayRecorder::writer_loop(std::unique_ptr<std::ostream> out)
+{
+    std::vector<std::uint8_t> chunk(1 << 16);
+    for (;;) {
+        const bool stopping = m_stop.load(std::memory_order_acquire);
+        const size_t n = m_ring->pop(chunk.data(), chunk.size());
+        if (n > 0) {
+            out->write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(n));
+            m_bytes.fetch_add(n, std::memory_order_relaxed);
+            continue;
+        }
+        if (stopping)
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    out->flush();
+}
+
+void ReplayRecorder::on_step(const PhysicsWorld& world)
+{
+    record(world.step_count(), world.getBodies());
+}
+
+void ReplayRecorder::record(const std::uint64_t step, const std::vector<Body>& bodies)
+{
+    if (!m_ring)
+        return;
+
+    bool key = m_need_key || bodies.size() != m_ids.size() || step <= m_last_step ||
+               step - m_last_key >= m_settings.keyframeInterval;
+    for (size_t i = 0; !key && i < bodies.size(); ++i)
+        key = bodies[i].id != m_ids[i];
+
+    if (key)
+        encode_key(step, bodies);
+    else
+        encode_delta(step, bodies);
+
+    if (m_ring->try_push(m_frame.data(), m_frame.size())) {
+        ++m_frames;
+        if (key) {
+            ++m_keyframes;
+            m_last_key = step;
+        }
+        m_need_key = false;
+    } else {
+        // The stream now misses a delta, only a keyframe can follow
+        ++m_dropped;
+        m_need_key = true;
+    }
+    m_last_step = step;
+}
+
+static size_t varint_size(std::uint64_t v)
+{
+    size_t n = 1;
+    for (; v >= 0x80; v >>= 7)
+        ++n;
+    return n;
+}
+
+// Frame header and entry count in front of the encoded entries
+static void assemble(std::vector<std::uint8_t>& frame, const ReplayFrame kind,
+                     const std::uint64_t step, const std::uint64_t count,
+                     const std::vector<std::uint8_t>& entries)
+{
+    frame.clear();
+    frame.push_back(static_cast<std::uint8_t>(kind));
+    put_varint(frame, step);
+    put_varint(frame, varint_size(count) + entries.size());
+    put_varint(frame, count);
+    frame.insert(frame.end(), entries.begin(), entries.end());
+}
+
+void ReplayRecorder::encode_key(const std::uint64_t step, const std::vector<Body>& bodies)
+{
+    const double inv = 1.0 / m_settings.quantum;
+    m_ids.resize(bodies.size());
+    m_quantised.resize(bodies.size() * 2);
+    m_payload.clear();
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        m_ids[i] = bodies[i].id;
+        m_quantised[2 * i] = quantise(bodies[i].position.x, inv);
+        m_quantised[2 * i + 1] = quantise(bodies[i].position.y, inv);
+        put_varint(m_payload, bodies[i].id);
+        put_zigzag(m_payload, m_quantised[2 * i]);
+        put_zigzag(m_payload, m_quantised[2 * i + 1]);
+    }
+    assemble(m_frame, ReplayFrame::Key, step, bodies.size(), m_payload);
+}
+
+void ReplayRecorder::encode_delta(const std::uint64_t step, const std::vector<Body>& bodies)
+{
+    const double inv = 1.0 / m_settings.quantum;
+    m_payload.clear();
+    std::uint64_t changed = 0;
+    size_t next = 0;    // first index after the last entry
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        const std::int64_t x = quantise(bodies[i].position.x, inv);
+        const std::int64_t y = quantise(bodies[i].position.y, inv);
+        if (x == m_quantised[2 * i] && y == m_quantised[2 * i + 1])
+            continue;
+        put_varint(m_payload, i - next);
+        put_zigzag(m_payload, x - m_quantised[2 * i]);
+        put_zigzag(m_payload, y - m_quantised[2 * i + 1]);
+        m_quantised[2 * i] = x;
+        m_quantised[2 * i + 1] = y;
+        next = i + 1;
+        ++changed;
+    }
+    assemble(m_frame, ReplayFrame::Delta, step, changed, m_payload);
+}
+
+// ============================================================
+// ReplayPlayer
+// ============================================================
+
+bool ReplayPlayer::open(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+    return load(file);
+}
+
+bool ReplayPlayer::load(std::istream& in)
+{
+    m_data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    m_frames.clear();
+    m_keys.clear();
+    m_ids.clear();
+    m_quantised.clear();
+    m_positions.clear();
+    m_current = SIZE_MAX;
+    m_step = 0;
+
+    ReplayHeader header;
+    if (m_data.size() < sizeof(header))
+        return false;
+    std::memcpy(&header, m_data.data(), sizeof(header));
+    if (header.magic != REPLAY_MAGIC || header.version != REPLAY_VERSION || header.quantum <= 0.0f)
+        return false;
+    m_fixed_dt = header.fixedDt;
+    m_quantum = header.quantum;
+
+    const std::uint8_t* p = m_data.data() + sizeof(header);
+    const std::uint8_t* const end = m_data.data() + m_data.size();
+    while (p < end) {
+        const auto kind = static_cast<ReplayFrame>(*p++);
+        std::uint64_t step;
+        std::uint64_t size;
+        if ((kind != ReplayFrame::Key && kind != ReplayFrame::Delta) ||
+            !get_varint(p, end, step) || !get_varint(p, end, size) ||
+            size > static_cast<std::uint64_t>(end - p))
+            break;
+        if (kind == ReplayFrame::Key)
+            m_keys.push_back(m_frames.size());
+        m_frames.push_back({kind, step, static_cast<size_t>(p - m_data.data()), static_cast<size_t>(size)});
+        p += size;
+    }
+    return true;
+}
+
+std::uint64_t ReplayPlayer::first_step() const
+{
+    return m_frames.empty() ? 0 : m_frames.front().step;
+}
+
+std::uint64_t ReplayPlayer::last_step() const
+{
+    return m_frames.empty() ? 0 : m_frames.back().step;
+}
+
+bool ReplayPlayer::apply(const Frame& frame)
+{
+    const std::uint8_t* p = m_data.data() + frame.offset;
+    const std::uint8_t* const end = p + frame.size;
+    std::uint64_t count;
+    if (!get_varint(p, end, count))
+        return false;
+
+    if (frame.kind == ReplayFrame::Key) {
+        if (count > frame.size)
+            return false;
+        m_ids.resize(count);
+        m_quantised.resize(count * 2);
+        m_positions.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            std::uint64_t id;
+            if (!get_varint(p, end, id) || !get_zigzag(p, end, m_quantised[2 * i]) ||
+                !get_zigzag(p, end, m_quantised[2 * i + 1]))
+                return false;
+            m_ids[i] = static_cast<BodyID>(id);
+        }
+        for (size_t i = 0; i < count; ++i)
+            m_positions[i] = {static_cast<float>(static_cast<double>(m_quantised[2 * i]) * m_quantum),
+                              static_cast<float>(static_cast<double>(m_quantised[2 * i + 1]) * m_quantum)};
+    } else {
+        size_t next = 0;
+        for (std::uint64_t c = 0; c < count; ++c) {
+            std::uint64_t gap;
+            std::int64_t dx;
+            std::int64_t dy;
+            if (!get_varint(p, end, gap) || !get_zigzag(p, end, dx) || !get_zigzag(p, end, dy) ||
+                gap >= m_ids.size() - next)
+                return false;
+            const size_t i = next + gap;
+            m_quantised[2 * i] += dx;
+            m_quantised[2 * i + 1] += dy;
+            m_positions[i] = {static_cast<float>(static_cast<double>(m_quantised[2 * i]) * m_quantum),
+                              static_cast<float>(static_cast<double>(m_quantised[2 * i + 1]) * m_quantum)};
+            next = i + 1;
+        }
+    }
+    m_step = frame.step;
+    return true;
+}
+
+bool ReplayPlayer::seek(const std::uint64_t step)
+{
+    // Last keyframe at or before step
+    const auto it = std::upper_bound(m_keys.begin(), m_keys.end(), step,
+                                     [&](const std::uint64_t s, const size_t k) { return s < m_frames[k].step; });
+    if (it == m_keys.begin())
+        return false;
+
+    size_t f = *(it - 1);
+    if (!apply(m_frames[f]))
+        return false;
+    while (f + 1 < m_frames.size() && m_frames[f + 1].step <= step) {
+        if (!apply(m_frames[f + 1]))
+            return false;
+        ++f;
+    }
+    m_current = f;
+    return true;
+}
+
+bool ReplayPlayer::next()
+{
+    const size_t f = m_current == SIZE_MAX ? 0 : m_current + 1;
+    if (f >= m_frames.size() || !apply(m_frames[f]))
+        return false;
+    m_current = f;
+    return true;
+}
@@ -0,0 +1,162 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#ifndef ENGINELOOP_REPLAY_H
+#define ENGINELOOP_REPLAY_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "physics_world.h"
+#include "spsc_ring.h"
+
+// Replay stream: a header, then one frame per recorded step.
+//
+//   header   "EGRP", u16 version, u16 0, f32 fixed_dt, f32 quantum
+//   frame    u8 kind, varint step, varint payload bytes, payload
+//   key      varint count, count x (varint id, zigzag x, zigzag y)
+//   delta    varint changed, changed x (varint index gap, zigzag dx, zigzag dy)
+//
+// Positions are stored in multiples of quantum. A keyframe holds them
+// absolute, a delta only the bodies whose quantised position changed,
+// relative to the value last written for that body, so the error stays
+// below quantum / 2 however long the stream runs. Index gaps count the
+// unchanged bodies skipped since the previous entry.
+constexpr std::uint32_t REPLAY_MAGIC = 0x50524745;      // "EGRP"
+constexpr std::uint16_t REPLAY_VERSION = 1;
+
+enum class ReplayFrame : std::uint8_t {
+    Key = 1,
+    Delta = 2
+};
+
+struct ReplaySettings {
+    float quantum = 1.0f / 1024.0f;         // position resolution in metres
+    std::uint32_t keyframeInterval = 300;   // steps between keyframes, seek granularity
+    std::size_t ringBytes = 1 << 22;        // queue to the writer thread
+};
+
+// Records body positions after every step into a file. Frames are
+// encoded on the stepping thread and queued to a writer thread, which
+// owns the file. fixed_step does not wait for the disk: when the queue
+// is full the frame is dropped and the next one is written as a
+// keyframe. A frame larger than the whole queue (ringBytes too small
+// for the world) makes the queue grow, see GrowingSpscRing.
+//
+// Attach with PhysicsWorld::add_step_listener or call record() directly.
+class ReplayRecorder : public StepListener {
+public:
+    ReplayRecorder() = default;
+    ~ReplayRecorder() override;
+
+    ReplayRecorder(const ReplayRecorder&) = delete;
+    ReplayRecorder& operator=(const ReplayRecorder&) = delete;
+
+    // Writes the header and starts the writer thread. false when the
+    // file cannot be created or a recording is already open.
+    bool open(const std::string& path, float fixed_dt, const ReplaySettings& settings = {});
+
+    // Writes out everything queued, then closes the file
+    void close();
+
+    [[nodiscard]] bool is_open() const { return m_ring != nullptr; }
+
+    void on_step(const PhysicsWorld& world) override;
+
+    // A step at or before the last recorded one (a rollback correction)
+    // is written as a keyframe.
+    void record(std::uint64_t step, const std::vector<Body>& bodies);
+
+    [[nodiscard]] std::uint64_t frames() const { return m_frames; }
+    [[nodiscard]] std::uint64_t keyframes() const { return m_keyframes; }
+    [[nodiscard]] std::uint64_t dropped_frames() const { return m_dropped; }
+    // Current size of the queue to the writer, grown from ringBytes if
+    // a frame did not fit
+    [[nodiscard]] std::size_t queue_bytes() const { return m_ring ? m_ring->capacity() : 0; }
+
+    // Bytes the writer thread has written so far
+    [[nodiscard]] std::uint64_t bytes_written() const { return m_bytes.load(std::memory_order_relaxed); }
+
+private:
+    void encode_key(std::uint64_t step, const std::vector<Body>& bodies);
+    void encode_delta(std::uint64_t step, const std::vector<Body>& bodies);
+    void writer_loop(std::unique_ptr<std::ostream> out);
+
+    ReplaySettings m_settings;
+    std::unique_ptr<GrowingSpscRing<std::uint8_t>> m_ring;
+    std::thread m_writer;
+    std::atomic<bool> m_stop{false};
+    std::atomic<std::uint64_t> m_bytes{0};
+
+    // Stepping thread only
+    std::vector<std::uint8_t> m_frame;
+    std::vector<std::uint8_t> m_payload;
+    std::vector<BodyID> m_ids;                  // as of the last frame written
+    std::vector<std::int64_t> m_quantised;      // x, y per body
+    std::uint64_t m_last_step = 0;
+    std::uint64_t m_last_key = 0;
+    bool m_need_key = true;
+    std::uint64_t m_frames = 0;
+    std::uint64_t m_keyframes = 0;
+    std::uint64_t m_dropped = 0;
+};
+
+// Reads a replay into memory and plays it back. seek() starts from the
+// closest keyframe at or before the target, so a jump costs at most one
+// keyframe interval of deltas.
+class ReplayPlayer {
+public:
+    // false when the file is missing or not a replay of this version.
+    // A frame cut off at the end (recording killed mid write) is ignored.
+    bool open(const std::string& path);
+    bool load(std::istream& in);
+
+    [[nodiscard]] float fixed_dt() const { return m_fixed_dt; }
+    [[nodiscard]] std::size_t frame_count() const { return m_frames.size(); }
+    [[nodiscard]] std::size_t keyframe_count() const { return m_keys.size(); }
+    [[nodiscard]] std::uint64_t first_step() const;
+    [[nodiscard]] std::uint64_t last_step() const;
+
+    // State of the last frame recorded at or before step. false before
+    // the first keyframe.
+    bool seek(std::uint64_t step);
+
+    // Advances one frame, false at the end
+    bool next();
+
+    // Step of the current frame
+    [[nodiscard]] std::uint64_t step() const { return m_step; }
+
+    [[nodiscard]] const std::vector<BodyID>& ids() const { return m_ids; }
+    [[nodiscard]] const std::vector<glm::vec2>& positions() const { return m_positions; }
+
+private:
+    struct Frame {
+        ReplayFrame kind;
+        std::uint64_t step;
+        std::size_t offset;     // payload in m_data
+        std::size_t size;
+    };
+
+    bool apply(const Frame& frame);
+
+    std::vector<std::uint8_t> m_data;
+    std::vector<Frame> m_frames;
+    std::vector<std::size_t> m_keys;            // indices of keyframes in m_frames
+    float m_fixed_dt = 0.0f;
+    float m_quantum = 0.0f;
+
+    std::size_t m_current = SIZE_MAX;           // index into m_frames
+    std::uint64_t m_step = 0;
+    std::vector<BodyID> m_ids;
+    std::vector<std::int64_t> m_quantised;
+    std::vector<glm::vec2> m_positions;
+};
+
+#endif //ENGINELOOP_REPLAY_H
@@ -0,0 +1,78 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#include "rollback.h"
+
+#include <algorithm>
+
+#include "boid_flock.h"
+#include "physics_world.h"
+
+RollbackBuffer::RollbackBuffer(PhysicsWorld& world, Flock* flock, const std::uint32_t capacity)
+    : m_world(world), m_flock(flock), m_slots(std::max(capacity, 1u))
+{
+}
+
+void RollbackBuffer::save()
+{
+    const std::uint64_t step = m_world.step_count();
+    Slot& slot = m_slots[step % m_slots.size()];
+    m_world.save_snapshot(slot.world);
+    if (m_flock)
+        m_flock->save_snapshot(slot.flock);
+    slot.step = step;
+    slot.valid = true;
+}
+
+const RollbackBuffer::Slot* RollbackBuffer::find(const std::uint64_t step) const
+{
+    const Slot& slot = m_slots[step % m_slots.size()];
+    return slot.valid && slot.step == step ? &slot : nullptr;
+}
+
+bool RollbackBuffer::has(const std::uint64_t step) const
+{
+    return find(step) != nullptr;
+}
+
+bool RollbackBuffer::rewind(const std::uint64_t step)
+{
+    // both checked first, a bad flock slot must not leave the world
+    // rewound on its own
+    const Slot* slot = find(step);
+    if (!slot || !m_world.accepts_snapshot(slot->world) ||
+        (m_flock && !m_flock->accepts_snapshot(slot->flock)))
+        return false;
+    m_world.load_snapshot(slot->world);
+    if (m_flock)
+        m_flock->load_snapshot(slot->flock);
+
+    for (Slot& s: m_slots)
+        if (s.step > step)
+            s.valid = false;
+    return true;
+}
+
+bool RollbackBuffer::resimulate(const std::uint64_t step, const InputFn& input)
+{
+    const std::uint64_t present = m_world.step_count();
+    if (step > present || !rewind(step))
+        return false;
+
+    while (m_world.step_count() < present) {
+        if (input)
+            input(m_world.step_count(), m_world);
+        m_world.step_once(m_world.step_count() + 1 == present);
+        save();
+    }
+    return true;
+}
+
+std::size_t RollbackBuffer::memory_bytes() const
+{
+    std::size_t bytes = 0;
+    for (const Slot& s: m_slots)
+        bytes += s.world.capacity() + s.flock.capacity();
+    return bytes;
+}
@@ -0,0 +1,70 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#ifndef ENGINELOOP_ROLLBACK_H
+#define ENGINELOOP_ROLLBACK_H
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class Flock;
+class PhysicsWorld;
+
+// Snapshots of the last N steps of a world and its flock, for rollback
+// netcode. The snapshot of step K is the state after K steps, before the
+// input of step K is applied. When an input for an earlier step arrives
+// late, resimulate() rewinds to it and steps back to the present.
+//
+// Every slot keeps its own buffers, once they have grown to the size of
+// the world saving is a memcpy per array and allocates nothing.
+class RollbackBuffer {
+public:
+    // Input for one step, applied right before the world is stepped
+    // from step to step + 1
+    using InputFn = std::function<void(std::uint64_t step, PhysicsWorld& world)>;
+
+    // flock may be null. capacity steps can be rewound, at least 1.
+    RollbackBuffer(PhysicsWorld& world, Flock* flock, std::uint32_t capacity);
+
+    // Saves the current state under world.step_count(), replacing the
+    // snapshot capacity steps older
+    void save();
+
+    [[nodiscard]] bool has(std::uint64_t step) const;
+
+    // Loads the snapshot of step and forgets the ones after it, they
+    // belong to a future that is about to be simulated again. false
+    // (nothing changed) when step is not in the buffer or one of its
+    // snapshots can not be loaded.
+    bool rewind(std::uint64_t step);
+
+    // Rewinds to step, then steps back to the step count the world had
+    // before the call, calling input before every step and saving every
+    // state on the way. Observer data (previous positions, penetration
+    // stats) is produced for the last step only. false (nothing
+    // changed) when step is not in the buffer or lies in the future.
+    bool resimulate(std::uint64_t step, const InputFn& input);
+
+    [[nodiscard]] std::uint32_t capacity() const { return static_cast<std::uint32_t>(m_slots.size()); }
+
+    // Bytes held by all slots, for budgeting N
+    [[nodiscard]] std::size_t memory_bytes() const;
+
+private:
+    struct Slot {
+        std::uint64_t step = 0;
+        bool valid = false;
+        std::vector<std::byte> world;
+        std::vector<std::byte> flock;
+    };
+
+    [[nodiscard]] const Slot* find(std::uint64_t step) const;
+
+    PhysicsWorld& m_world;
+    Flock* m_flock;
+    std::vector<Slot> m_slots;
+};
+
+#endif //ENGINELOOP_ROLLBACK_H
@@ -1,5 +1,7 @@
 #include "rvo_solver.h"
 #include "Integrator.h"
+#include "interpolation.h"
+#include "snapshot.h"
 
 #include <glm/geometric.hpp>
 #include <algorithm>
@@ -135,6 +137,11 @@ uint32_t RVOSolver::addAgent(glm::vec2 pos, glm::vec2 vel, float radius,
     return a.body.id;
 }
 
+void RVOSolver::assignAgents(const std::span<const RVOAgent> src) {
+    agents.assign(src.begin(), src.end());
+    prevPositions.clear();
+}
+
 void RVOSolver::setPreferredVelocity(uint32_t agentId, glm::vec2 prefVel) {
     agents[agentId].prefVelocity = prefVel;
 }
@@ -227,6 +234,10 @@ glm::vec2 RVOSolver::computeNewVelocity(size_t idx) const {
 //   p += v * m_dt
 // ---------------------------------------------------------------------------
 void RVOSolver::step() {
+    prevPositions.resize(agents.size());
+    for (size_t i = 0; i < agents.size(); ++i)
+        prevPositions[i] = agents[i].body.position;
+
     std::vector<glm::vec2> newVelocities(agents.size());
     for (size_t i = 0; i < agents.size(); ++i)
         newVelocities[i] = computeNewVelocity(i);
@@ -237,3 +248,50 @@ void RVOSolver::step() {
         Integrator::semi_implicit_euler(b, m_dt);
     }
 }
+
+void RVOSolver::interpolatedPositions(float alpha, std::vector<glm::vec2>& out) const {
+    out.resize(agents.size());
+    for (size_t i = 0; i < agents.size(); ++i)
+        out[i] = agents[i].body.position;
+    interpolate(prevPositions, out, alpha, out);
+}
+
+void RVOSolver::hashState(StateHash& h) const {
+    h.add(static_cast<uint32_t>(agents.size()));
+    for (const RVOAgent& a : agents) {
+        hash_body(h, a.body);
+        h.add(a.radius);
+        h.add(a.maxSpeed);
+        h.add(a.neighborDist);
+        h.add(a.timeHorizon);
+        h.add(a.prefVelocity);
+    }
+}
+
+enum RVOSection : uint32_t {
+    RVO_DT = 1,
+    RVO_AGENTS,
+    RVO_PREV_POSITIONS
+};
+
+void RVOSolver::saveSnapshot(std::vector<std::byte>& out) const {
+    SnapshotWriter w(out, SnapshotKind::RVO);
+    w.write_value(RVO_DT, m_dt);
+    w.write(RVO_AGENTS, std::span(agents));
+    w.write(RVO_PREV_POSITIONS, std::span(prevPositions));
+    w.finish();
+}
+
+bool RVOSolver::loadSnapshot(const std::span<const std::byte> in) {
+    const SnapshotReader r(in, SnapshotKind::RVO);
+    if (!r.has<float>(RVO_DT, true) || !r.has<RVOAgent>(RVO_AGENTS) ||
+        !r.has<glm::vec2>(RVO_PREV_POSITIONS))
+        return false;
+    float dt;
+    r.read_value(RVO_DT, dt);
+    if (dt != m_dt)
+        return false;
+    r.read(RVO_AGENTS, agents);
+    r.read(RVO_PREV_POSITIONS, prevPositions);
+    return true;
+}
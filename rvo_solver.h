@@ -1,7 +1,10 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
+#include <span>
 #include <vector>
 #include "body.h"
+#include "determinism.h"
 
 // An ORCA half-plane constraint.
 // Feasible region: dot(v - point, left_perp(direction)) >= 0
@@ -37,14 +40,38 @@ public:
 
     void setPreferredVelocity(uint32_t agentId, glm::vec2 prefVel);
 
+    // Replaces all agents in one copy. Ids must equal the indices, as
+    // addAgent hands them out.
+    void assignAgents(std::span<const RVOAgent> src);
+
     // Compute avoidance velocities and integrate all agents using
     // Integrator::semi_implicit_euler with the stored fixed timestep.
     void step();
 
     const std::vector<RVOAgent>& getAgents() const { return agents; }
 
+    // Agent positions at the start of the last step(), by agent id
+    const std::vector<glm::vec2>& getPreviousPositions() const { return prevPositions; }
+
+    // Agent positions blended alpha of the way from the previous step.
+    // The caller owns the accumulator that drives step(), so it also
+    // provides alpha.
+    void interpolatedPositions(float alpha, std::vector<glm::vec2>& out) const;
+
+    // Agent bodies, parameters and preferred velocities. The solver is
+    // stepped by the caller, who chains it per step next to
+    // PhysicsWorld::state_hash().
+    void hashState(StateHash& h) const;
+
+    // Agents and previous positions in the flat format of snapshot.h.
+    // loadSnapshot returns false (solver untouched) on a foreign buffer
+    // or one saved with another fixed_dt.
+    void saveSnapshot(std::vector<std::byte>& out) const;
+    bool loadSnapshot(std::span<const std::byte> in);
+
 private:
     std::vector<RVOAgent> agents;
+    std::vector<glm::vec2> prevPositions;
     const float           m_dt;
 
     glm::vec2 computeNewVelocity(size_t idx) const;
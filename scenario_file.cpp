@@ -0,0 +1,211 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#include "scenario_file.h"
+
+#include <fstream>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "boid_flock.h"
+#include "physics_world.h"
+
+enum ScenarioSection : uint32_t {
+    SCENARIO_PARAMS = 1,
+    SCENARIO_SOLVER_SETTINGS,
+    SCENARIO_BODIES,
+    SCENARIO_CIRCLES,
+    SCENARIO_CAPSULES,
+    SCENARIO_POLYGONS,
+    SCENARIO_BOIDS,
+    SCENARIO_AGENTS
+};
+
+// Every body refers to an existing slot of its shape type and fits a
+// broadphase cell, and every polygon stays within its vertex array, so a
+// file written by another scene layout can not send the narrowphase out
+// of range or build a world that misses pairs.
+static bool shapes_in_range(const std::span<const Body> bodies,
+                            const std::span<const CircleShape> circles,
+                            const std::span<const CapsuleShape> capsules,
+                            const std::span<const PolygonShape> polygons)
+{
+    for (const Body& b: bodies) {
+        if (!fits_broadphase_cell(b))
+            return false;
+        const std::size_t index = b.shape.index;
+        switch (b.shape.type) {
+            case Type::box:
+            case Type::plane:
+                break;
+            case Type::circle:
+                if (index >= circles.size()) return false;
+                break;
+            case Type::capsule:
+                if (index >= capsules.size()) return false;
+                break;
+            case Type::polygon:
+                if (index >= polygons.size()) return false;
+                break;
+            default:
+                return false;
+        }
+    }
+    for (const PolygonShape& p: polygons)
+        if (p.count < 3 || p.count > MAX_POLYGON_VERTICES)
+            return false;
+    return true;
+}
+
+bool write_scenario(const std::string& path, const PhysicsWorld& world,
+                    const Flock* flock, const RVOSolver* rvo)
+{
+    const ScenarioParams params{world.fixed_dt(), world.deterministic() ? 1u : 0u};
+    const std::span<const Boid> boids = flock ? std::span(flock->getBoids()) : std::span<const Boid>{};
+    const std::span<const RVOAgent> agents = rvo ? std::span(rvo->getAgents()) : std::span<const RVOAgent>{};
+
+    std::vector<std::byte> data;
+    SnapshotWriter w(data, SnapshotKind::Scenario);
+    w.write_value(SCENARIO_PARAMS, params);
+    w.write_value(SCENARIO_SOLVER_SETTINGS, world.solver_settings());
+    w.write(SCENARIO_BODIES, std::span(world.getBodies()));
+    w.write(SCENARIO_CIRCLES, std::span(world.shapes().circles));
+    w.write(SCENARIO_CAPSULES, std::span(world.shapes().capsules));
+    w.write(SCENARIO_POLYGONS, std::span(world.shapes().polygons));
+    w.write(SCENARIO_BOIDS, boids);
+    w.write(SCENARIO_AGENTS, agents);
+    w.finish();
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(file);
+}
+
+ScenarioFile::~ScenarioFile()
+{
+    close();
+}
+
+bool ScenarioFile::open(const std::string& path)
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER size;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    m_data = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    m_file = file;
+    m_mapping = mapping;
+    if (!m_data) {
+        close();
+        return false;
+    }
+    m_size = static_cast<std::size_t>(size.QuadPart);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st{};
+    void* map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+        map = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+        return false;
+    // build() reads every array front to back exactly once
+    madvise(map, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+    m_data = static_cast<const std::byte*>(map);
+    m_size = static_cast<std::size_t>(st.st_size);
+#endif
+
+    const SnapshotReader r({m_data, m_size}, SnapshotKind::Scenario);
+    if (!r.has<ScenarioParams>(SCENARIO_PARAMS, true) ||
+        !r.has<SolverSettings>(SCENARIO_SOLVER_SETTINGS, true) ||
+        !r.has<Body>(SCENARIO_BODIES) || !r.has<CircleShape>(SCENARIO_CIRCLES) ||
+        !r.has<CapsuleShape>(SCENARIO_CAPSULES) || !r.has<PolygonShape>(SCENARIO_POLYGONS) ||
+        !r.has<Boid>(SCENARIO_BOIDS) || !r.has<RVOAgent>(SCENARIO_AGENTS)) {
+        close();
+        return false;
+    }
+
+    r.read_value(SCENARIO_PARAMS, m_params);
+    r.read_value(SCENARIO_SOLVER_SETTINGS, m_solver);
+    m_bodies = r.view<Body>(SCENARIO_BODIES);
+    m_circles = r.view<CircleShape>(SCENARIO_CIRCLES);
+    m_capsules = r.view<CapsuleShape>(SCENARIO_CAPSULES);
+    m_polygons = r.view<PolygonShape>(SCENARIO_POLYGONS);
+    m_boids = r.view<Boid>(SCENARIO_BOIDS);
+    m_agents = r.view<RVOAgent>(SCENARIO_AGENTS);
+    if (!shapes_in_range(m_bodies, m_circles, m_capsules, m_polygons)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void ScenarioFile::close()
+{
+#ifdef _WIN32
+    if (m_data)
+        UnmapViewOfFile(m_data);
+    if (m_mapping)
+        CloseHandle(m_mapping);
+    if (m_file)
+        CloseHandle(m_file);
+    m_file = nullptr;
+    m_mapping = nullptr;
+#else
+    if (m_data)
+        munmap(const_cast<std::byte*>(m_data), m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_params = {};
+    m_solver = {};
+    m_bodies = {};
+    m_circles = {};
+    m_capsules = {};
+    m_polygons = {};
+    m_boids = {};
+    m_agents = {};
+}
+
+bool ScenarioFile::build(PhysicsWorld& world, Flock& flock, RVOSolver& rvo) const
+{
+    if (!m_data)
+        return false;
+
+    world.solver_settings() = m_solver;
+    world.set_deterministic(m_params.deterministic != 0);
+    world.getBodies().assign(m_bodies.begin(), m_bodies.end());
+    ShapeStore& shapes = world.shapes();
+    shapes.circles.assign(m_circles.begin(), m_circles.end());
+    shapes.capsules.assign(m_capsules.begin(), m_capsules.end());
+    shapes.polygons.assign(m_polygons.begin(), m_polygons.end());
+
+    flock.assign_boids(m_boids);
+    world.attach_flock(&flock);
+    rvo.assignAgents(m_agents);
+    return true;
+}
@@ -0,0 +1,88 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#ifndef ENGINELOOP_SCENARIO_FILE_H
+#define ENGINELOOP_SCENARIO_FILE_H
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+#include "boid.h"
+#include "contact_solver.h"
+#include "rvo_solver.h"
+#include "shape.h"
+#include "snapshot.h"
+
+class PhysicsWorld;
+class Flock;
+
+struct ScenarioParams {
+    float fixedDt;
+    std::uint32_t deterministic;
+};
+
+// Binary scenario: a SnapshotKind::Scenario snapshot (see snapshot.h)
+// with the parameters, solver settings, bodies, shape parameters, boids
+// and RVO agents. Every array is stored in the layout the simulation
+// uses in memory, 8 byte aligned, so opening the file maps it and the
+// arrays are usable in place. build() then fills the simulation with one
+// bulk copy per array, nothing is parsed or pushed element by element.
+//
+// Like snapshots the file is tied to the struct layout of the build
+// that wrote it; open() rejects files whose record sizes differ.
+class ScenarioFile {
+public:
+    ScenarioFile() = default;
+    ~ScenarioFile();
+
+    ScenarioFile(const ScenarioFile&) = delete;
+    ScenarioFile& operator=(const ScenarioFile&) = delete;
+
+    // Maps the file read only. false when it cannot be mapped or is not
+    // a complete scenario of this build, or when a body refers to a
+    // shape slot the file does not contain.
+    bool open(const std::string& path);
+    void close();
+
+    [[nodiscard]] float fixed_dt() const { return m_params.fixedDt; }
+    [[nodiscard]] bool deterministic() const { return m_params.deterministic != 0; }
+    [[nodiscard]] const SolverSettings& solver_settings() const { return m_solver; }
+
+    // Views into the mapping, valid until close()
+    [[nodiscard]] std::span<const Body> bodies() const { return m_bodies; }
+    [[nodiscard]] std::span<const CircleShape> circles() const { return m_circles; }
+    [[nodiscard]] std::span<const CapsuleShape> capsules() const { return m_capsules; }
+    [[nodiscard]] std::span<const PolygonShape> polygons() const { return m_polygons; }
+    [[nodiscard]] std::span<const Boid> boids() const { return m_boids; }
+    [[nodiscard]] std::span<const RVOAgent> agents() const { return m_agents; }
+
+    // Fills empty simulations built with fixed_dt() and attaches the
+    // flock. false when nothing is open.
+    bool build(PhysicsWorld& world, Flock& flock, RVOSolver& rvo) const;
+
+private:
+    const std::byte* m_data = nullptr;
+    std::size_t m_size = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+
+    ScenarioParams m_params{};
+    SolverSettings m_solver;
+    std::span<const Body> m_bodies;
+    std::span<const CircleShape> m_circles;
+    std::span<const CapsuleShape> m_capsules;
+    std::span<const PolygonShape> m_polygons;
+    std::span<const Boid> m_boids;
+    std::span<const RVOAgent> m_agents;
+};
+
+// Writes world, flock and crowd as a scenario. Either of flock and rvo
+// may be null. false when the file cannot be written.
+bool write_scenario(const std::string& path, const PhysicsWorld& world,
+                    const Flock* flock, const RVOSolver* rvo);
+
+#endif //ENGINELOOP_SCENARIO_FILE_H
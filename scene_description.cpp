@@ -0,0 +1,267 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#include "scene_description.h"
+
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+#include "boid_flock.h"
+#include "physics_world.h"
+#include "rvo_solver.h"
+
+namespace {
+
+// Parameters that apply to the entries following them
+struct ParseState {
+    glm::vec2 gravity{0.0f, 0.0f};
+    float invMass = 1.0f;
+    Boid boid{};
+};
+
+bool read_type(std::istream& in, BodyType& type)
+{
+    std::string word;
+    if (!(in >> word))
+        return false;
+    if (word == "dynamic")        type = BodyType::Dynamic;
+    else if (word == "static")    type = BodyType::Static;
+    else if (word == "kinematic") type = BodyType::Kinematic;
+    else return false;
+    return true;
+}
+
+Body make_body(const SceneDescription& scene, const ParseState& state,
+               const BodyType type, const glm::vec2 position, const glm::vec2 velocity)
+{
+    Body b{};
+    b.id = static_cast<BodyID>(scene.bodies.size());
+    b.type = type;
+    b.position = position;
+    b.velocity = type == BodyType::Static ? glm::vec2{0.0f, 0.0f} : velocity;
+    b.acceleration = type == BodyType::Dynamic ? state.gravity : glm::vec2{0.0f, 0.0f};
+    b.invMass = type == BodyType::Static ? 0.0f : state.invMass;
+    b.shape.type = Type::box;
+    return b;
+}
+
+// The world refuses shapes wider or higher than a broadphase cell, so the
+// file does too and reports the line.
+bool fits_cell(const glm::vec2 halfExtents)
+{
+    return 2.0f * halfExtents.x <= Body::ALLOWED_BODY_SIZE &&
+           2.0f * halfExtents.y <= Body::ALLOWED_BODY_SIZE;
+}
+
+bool parse_line(std::istringstream& in, const std::string& key,
+                SceneDescription& scene, ParseState& state)
+{
+    BodyType type{};
+    glm::vec2 p{}, v{};
+
+    if (key == "fixed_dt")
+        return static_cast<bool>(in >> scene.fixedDt) && scene.fixedDt > 0.0f;
+    if (key == "deterministic") {
+        scene.deterministic = true;
+        return true;
+    }
+    if (key == "gravity")
+        return static_cast<bool>(in >> state.gravity.x >> state.gravity.y);
+    if (key == "mass") {
+        float mass = 0.0f;
+        if (!(in >> mass) || mass <= 0.0f)
+            return false;
+        state.invMass = 1.0f / mass;
+        return true;
+    }
+    if (key == "box") {
+        float hw = 0.0f, hh = 0.0f;
+        if (!read_type(in, type) || !(in >> p.x >> p.y >> hw >> hh >> v.x >> v.y) ||
+            !(hw > 0.0f && hh > 0.0f) || !fits_cell({hw, hh}))
+            return false;
+        SceneBody sb{};
+        sb.body = make_body(scene, state, type, p, v);
+        sb.body.halfWidth = hw;
+        sb.body.halfHeight = hh;
+        scene.bodies.push_back(sb);
+        return true;
+    }
+    if (key == "circle") {
+        SceneBody sb{};
+        if (!read_type(in, type) || !(in >> p.x >> p.y >> sb.radius >> v.x >> v.y) ||
+            !(sb.radius > 0.0f) || !fits_cell({sb.radius, sb.radius}))
+            return false;
+        sb.body = make_body(scene, state, type, p, v);
+        sb.body.shape.type = Type::circle;
+        scene.bodies.push_back(sb);
+        return true;
+    }
+    if (key == "capsule") {
+        SceneBody sb{};
+        if (!read_type(in, type) ||
+            !(in >> p.x >> p.y >> sb.halfSegment.x >> sb.halfSegment.y >> sb.radius >> v.x >> v.y) ||
+            !(sb.radius > 0.0f) || !fits_cell({std::abs(sb.halfSegment.x) + sb.radius,
+                                              std::abs(sb.halfSegment.y) + sb.radius}))
+            return false;
+        sb.body = make_body(scene, state, type, p, v);
+        sb.body.shape.type = Type::capsule;
+        scene.bodies.push_back(sb);
+        return true;
+    }
+    if (key == "polygon") {
+        SceneBody sb{};
+        int n = 0;
+        if (!read_type(in, type) || !(in >> p.x >> p.y >> v.x >> v.y >> n) ||
+            n < 3 || n > MAX_POLYGON_VERTICES)
+            return false;
+        sb.vertices.resize(static_cast<size_t>(n));
+        for (glm::vec2& vertex: sb.vertices)
+            if (!(in >> vertex.x >> vertex.y) || !fits_cell({std::abs(vertex.x), std::abs(vertex.y)}))
+                return false;
+        sb.body = make_body(scene, state, type, p, v);
+        sb.body.shape.type = Type::polygon;
+        scene.bodies.push_back(sb);
+        return true;
+    }
+    if (key == "plane") {
+        if (!(in >> p.x >> p.y))
+            return false;
+        SceneBody sb{};
+        sb.body = make_body(scene, state, BodyType::Static, p, v);
+        sb.body.shape.type = Type::plane;
+        scene.bodies.push_back(sb);
+        return true;
+    }
+    if (key == "boid_params") {
+        Boid& b = state.boid;
+        return static_cast<bool>(in >> b.perception >> b.max_speed >> b.max_force
+                                    >> b.w_separation >> b.w_alignment >> b.w_cohesion);
+    }
+    if (key == "boid") {
+        if (!(in >> p.x >> p.y >> v.x >> v.y))
+            return false;
+        Boid b = state.boid;
+        b.body = Body{};
+        b.body.id = static_cast<BodyID>(scene.boids.size());
+        b.body.type = BodyType::Dynamic;
+        b.body.position = p;
+        b.body.velocity = v;
+        b.body.invMass = 1.0f;
+        scene.boids.push_back(b);
+        return true;
+    }
+    if (key == "boids") {
+        int count = 0;
+        unsigned seed = 0;
+        if (!(in >> count >> seed) || count < 0)
+            return false;
+        std::mt19937 rng{seed};
+        std::uniform_real_distribution<float> rx(-Flock::WORLD_HALF_W, Flock::WORLD_HALF_W);
+        std::uniform_real_distribution<float> ry(-Flock::WORLD_HALF_H, Flock::WORLD_HALF_H);
+        std::uniform_real_distribution<float> rv(-2.0f, 2.0f);
+        for (int i = 0; i < count; ++i) {
+            Boid b = state.boid;
+            b.body = Body{};
+            b.body.id = static_cast<BodyID>(scene.boids.size());
+            b.body.type = BodyType::Dynamic;
+            b.body.position = {rx(rng), ry(rng)};
+            b.body.velocity = {rv(rng), rv(rng)};
+            b.body.invMass = 1.0f;
+            scene.boids.push_back(b);
+        }
+        return true;
+    }
+    if (key == "agent") {
+        SceneAgent a{};
+        if (!(in >> a.position.x >> a.position.y >> a.velocity.x >> a.velocity.y
+                 >> a.radius >> a.maxSpeed >> a.prefVelocity.x >> a.prefVelocity.y))
+            return false;
+        scene.agents.push_back(a);
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+bool parse_scene(std::istream& in, SceneDescription& out, std::string* error)
+{
+    out = SceneDescription{};
+    ParseState state;
+    state.boid.perception = 2.5f;
+    state.boid.max_speed = 9.0f;
+    state.boid.max_force = 2.5f;
+    state.boid.w_separation = 1.5f;
+    state.boid.w_alignment = 1.0f;
+    state.boid.w_cohesion = 1.0f;
+
+    std::string line;
+    int number = 0;
+    while (std::getline(in, line)) {
+        ++number;
+        if (const size_t hash = line.find('#'); hash != std::string::npos)
+            line.erase(hash);
+        std::istringstream words(line);
+        std::string key;
+        if (!(words >> key))
+            continue;
+
+        std::string rest;
+        if (!parse_line(words, key, out, state) || (words >> rest)) {
+            if (error)
+                *error = "line " + std::to_string(number) + ": cannot read '" + key + "' entry";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool load_scene(const std::string& path, SceneDescription& out, std::string* error)
+{
+    std::ifstream file(path);
+    if (!file) {
+        if (error)
+            *error = "cannot open " + path;
+        return false;
+    }
+    return parse_scene(file, out, error);
+}
+
+bool build_scene(const SceneDescription& scene, PhysicsWorld& world,
+                 Flock& flock, RVOSolver& rvo)
+{
+    world.set_deterministic(scene.deterministic);
+
+    for (const SceneBody& sb: scene.bodies) {
+        switch (sb.body.shape.type) {
+            case Type::circle:
+                if (!world.add_circle(sb.body, sb.radius))
+                    return false;
+                break;
+            case Type::capsule:
+                if (!world.add_capsule(sb.body, sb.halfSegment, sb.radius))
+                    return false;
+                break;
+            case Type::polygon:
+                if (!world.add_polygon(sb.body, sb.vertices))
+                    return false;
+                break;
+            default:
+                world.getBodies().push_back(sb.body);
+                break;
+        }
+    }
+
+    for (const Boid& b: scene.boids)
+        flock.add_boid(b);
+    world.attach_flock(&flock);
+
+    for (const SceneAgent& a: scene.agents) {
+        const uint32_t id = rvo.addAgent(a.position, a.velocity, a.radius, a.maxSpeed);
+        rvo.setPreferredVelocity(id, a.prefVelocity);
+    }
+    return true;
+}
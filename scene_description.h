@@ -0,0 +1,72 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#ifndef ENGINELOOP_SCENE_DESCRIPTION_H
+#define ENGINELOOP_SCENE_DESCRIPTION_H
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "body.h"
+#include "boid.h"
+
+class PhysicsWorld;
+class Flock;
+class RVOSolver;
+
+// Body plus the shape parameters PhysicsWorld::add_* takes
+struct SceneBody {
+    Body body;
+    float radius = 0.0f;                // circle, capsule
+    glm::vec2 halfSegment{0.0f, 0.0f};  // capsule
+    std::vector<glm::vec2> vertices;    // polygon
+};
+
+struct SceneAgent {
+    glm::vec2 position;
+    glm::vec2 velocity;
+    glm::vec2 prefVelocity;
+    float radius;
+    float maxSpeed;
+};
+
+// Everything needed to set up a world, its flock and an RVO crowd,
+// read from a line based text file:
+//
+//   # comment
+//   fixed_dt 0.0166667
+//   deterministic
+//   gravity 0 -9.8                     acceleration of later dynamic bodies
+//   mass 2                             mass of later dynamic bodies
+//   box <type> x y halfW halfH vx vy   type: dynamic | static | kinematic
+//   circle <type> x y radius vx vy
+//   capsule <type> x y hsx hsy radius vx vy
+//   polygon <type> x y vx vy n x0 y0 ... (n vertices, counter clockwise)
+//   plane x y
+//   boid_params perception max_speed max_force w_sep w_ali w_coh
+//   boid x y vx vy
+//   boids count seed                   random boids inside the flock world
+//   agent x y vx vy radius max_speed pref_vx pref_vy
+//
+// Body ids count up in file order, boid ids separately. Shapes may be at
+// most Body::ALLOWED_BODY_SIZE wide and high (one broadphase cell), so a
+// long floor is a row of boxes.
+struct SceneDescription {
+    float fixedDt = 1.0f / 60.0f;
+    bool deterministic = false;
+    std::vector<SceneBody> bodies;
+    std::vector<Boid> boids;
+    std::vector<SceneAgent> agents;
+};
+
+// false with "line N: ..." in error on the first malformed line
+bool parse_scene(std::istream& in, SceneDescription& out, std::string* error = nullptr);
+bool load_scene(const std::string& path, SceneDescription& out, std::string* error = nullptr);
+
+// Adds the scene to empty simulations built with scene.fixedDt and
+// attaches the flock. false when a shape is rejected by the world.
+bool build_scene(const SceneDescription& scene, PhysicsWorld& world,
+                 Flock& flock, RVOSolver& rvo);
+
+#endif //ENGINELOOP_SCENE_DESCRIPTION_H
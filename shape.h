@@ -4,15 +4,58 @@
 
 #ifndef SHAPE_H
 #define SHAPE_H
+#include <cstdint>
+#include <vector>
+#include "glm/vec2.hpp"
 
+// Values index the narrowphase dispatch table, keep them contiguous.
 enum class Type
 {
     box,
-    plane
+    plane,
+    circle,
+    capsule,
+    polygon
 };
 
+constexpr size_t SHAPE_TYPE_COUNT = 5;
+constexpr int MAX_POLYGON_VERTICES = 8;
+
 struct Shape
 {
     Type type;
+    // Slot of the parameters in the ShapeStore array of this type.
+    // Boxes keep their extent in Body::halfWidth / halfHeight.
+    uint32_t index = 0;
+};
+
+struct CircleShape
+{
+    float radius;
+};
+
+// Segment position +- halfSegment swept by radius. Bodies do not rotate,
+// so the segment keeps its direction.
+struct CapsuleShape
+{
+    glm::vec2 halfSegment;
+    float radius;
+};
+
+// Convex, counter clockwise, relative to the body position.
+// normals[i] is the outward normal of the edge from vertex i to i + 1.
+struct PolygonShape
+{
+    glm::vec2 vertices[MAX_POLYGON_VERTICES];
+    glm::vec2 normals[MAX_POLYGON_VERTICES];
+    uint32_t count;
+};
+
+// Shape parameters packed per type, referenced by Shape::index.
+struct ShapeStore
+{
+    std::vector<CircleShape> circles;
+    std::vector<CapsuleShape> capsules;
+    std::vector<PolygonShape> polygons;
 };
 #endif //SHAPE_H
@@ -0,0 +1,222 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+// Headless simulation server: physics, flock and RVO crowd from a scene
+// file, no window and no renderer.
+//
+//   sim_server <scene> [--steps N] [--realtime] [--metrics-every N]
+//              [--record FILE] [--save-scenario FILE]
+//              [--telemetry FILE] [--telemetry-every N]
+//
+// <scene> is a text scene (scene_description.h) or a binary scenario
+// (scenario_file.h). --save-scenario writes the loaded scene as a binary
+// scenario before stepping.
+//
+// Without --realtime the steps run as fast as possible in step_n
+// batches. --steps 0 runs until interrupted. --record writes a replay
+// of every step (see replay.h). --telemetry exports bodies, boids and
+// contact events (see telemetry.h) as CSV when FILE ends in .csv,
+// columnar binary otherwise, sampled every N steps.
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "boid_flock.h"
+#include "engine_time.h"
+#include "physics_world.h"
+#include "replay.h"
+#include "rvo_solver.h"
+#include "scenario_file.h"
+#include "scene_description.h"
+#include "telemetry.h"
+
+static volatile std::sig_atomic_t g_stop = 0;
+
+static void on_signal(int)
+{
+    g_stop = 1;
+}
+
+struct ServerOptions {
+    std::string scene;
+    std::uint64_t steps = 600;
+    bool realtime = false;
+    std::uint32_t metricsEvery = 60;
+    std::string record;
+    std::string saveScenario;
+    std::string telemetry;
+    std::uint32_t telemetryEvery = 1;
+};
+
+static bool parse_options(const int argc, char** argv, ServerOptions& out)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--realtime") {
+            out.realtime = true;
+        } else if (arg == "--steps" && i + 1 < argc) {
+            out.steps = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--metrics-every" && i + 1 < argc) {
+            out.metricsEvery = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--record" && i + 1 < argc) {
+            out.record = argv[++i];
+        } else if (arg == "--save-scenario" && i + 1 < argc) {
+            out.saveScenario = argv[++i];
+        } else if (arg == "--telemetry" && i + 1 < argc) {
+            out.telemetry = argv[++i];
+        } else if (arg == "--telemetry-every" && i + 1 < argc) {
+            out.telemetryEvery = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (out.scene.empty() && !arg.starts_with("--")) {
+            out.scene = arg;
+        } else {
+            return false;
+        }
+    }
+    return !out.scene.empty() && out.metricsEvery > 0 && out.telemetryEvery > 0;
+}
+
+static void print_metrics(const PhysicsWorld& world, const RVOSolver& rvo,
+                          const std::uint64_t steps, const double wall_seconds)
+{
+    const Flock* flock = world.flock();
+    std::cout << "step=" << world.step_count()
+              << std::fixed << std::setprecision(3)
+              << " sim_time=" << static_cast<double>(world.step_count()) * world.fixed_dt()
+              << " ms_per_step=" << (steps ? wall_seconds * 1000.0 / static_cast<double>(steps) : 0.0)
+              << " bodies=" << world.getBodies().size()
+              << " boids=" << (flock ? flock->getBoids().size() : 0)
+              << " agents=" << rvo.getAgents().size()
+              << " manifolds=" << world.getManifolds().size()
+              << std::setprecision(5)
+              << " max_penetration=" << world.solver_stats().maxPenetration
+              << " fell_behind=" << world.fell_behind_count();
+    if (world.deterministic()) {
+        // the crowd is not part of the world hash
+        StateHash h(world.state_hash());
+        rvo.hashState(h);
+        std::cout << " hash=" << std::hex << h.value() << std::dec;
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    ServerOptions options;
+    if (!parse_options(argc, argv, options)) {
+        std::cerr << "usage: sim_server <scene> [--steps N] [--realtime] [--metrics-every N]"
+                     " [--record FILE] [--save-scenario FILE]"
+                     " [--telemetry FILE] [--telemetry-every N]\n";
+        return 2;
+    }
+
+    ScenarioFile binary;
+    SceneDescription scene;
+    const bool isBinary = binary.open(options.scene);
+    if (!isBinary) {
+        std::string error;
+        if (!load_scene(options.scene, scene, &error)) {
+            std::cerr << options.scene << ": " << error << '\n';
+            return 1;
+        }
+    }
+
+    const float fixedDt = isBinary ? binary.fixed_dt() : scene.fixedDt;
+    PhysicsWorld world(fixedDt);
+    Flock flock;
+    RVOSolver rvo(fixedDt);
+    if (isBinary) {
+        binary.build(world, flock, rvo);
+        binary.close();
+    } else if (!build_scene(scene, world, flock, rvo)) {
+        std::cerr << options.scene << ": invalid shape\n";
+        return 1;
+    }
+
+    if (!options.saveScenario.empty() && !write_scenario(options.saveScenario, world, &flock, &rvo)) {
+        std::cerr << options.saveScenario << ": cannot write scenario\n";
+        return 1;
+    }
+
+    ReplayRecorder recorder;
+    const bool recording = !options.record.empty();
+    if (recording) {
+        if (!recorder.open(options.record, fixedDt)) {
+            std::cerr << options.record << ": cannot create replay\n";
+            return 1;
+        }
+        world.add_step_listener(&recorder);
+    }
+
+    TelemetryExporter telemetry;
+    const bool exporting = !options.telemetry.empty();
+    if (exporting) {
+        TelemetrySettings settings;
+        settings.format = options.telemetry.ends_with(".csv") ? TelemetryFormat::Csv
+                                                              : TelemetryFormat::Columnar;
+        settings.decimation = options.telemetryEvery;
+        if (!telemetry.open(options.telemetry, settings)) {
+            std::cerr << options.telemetry << ": cannot create telemetry file\n";
+            return 1;
+        }
+        world.add_step_listener(&telemetry);
+    }
+
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+
+    const bool forever = options.steps == 0;
+    std::uint64_t reported = 0;
+    engine::time_point window = engine::now();
+
+    auto report_if_due = [&] {
+        const std::uint64_t done = world.step_count();
+        if (done - reported < options.metricsEvery)
+            return;
+        const std::chrono::duration<double> wall = engine::now() - window;
+        print_metrics(world, rvo, done - reported, wall.count());
+        reported = done;
+        window = engine::now();
+    };
+
+    if (!options.realtime) {
+        while (!g_stop && (forever || world.step_count() < options.steps)) {
+            std::uint64_t batch = options.metricsEvery;
+            if (!forever)
+                batch = std::min<std::uint64_t>(batch, options.steps - world.step_count());
+            world.step_n(static_cast<std::uint32_t>(batch), recording || exporting);
+            for (std::uint64_t i = 0; i < batch; ++i)
+                rvo.step();
+            report_if_due();
+        }
+        return 0;
+    }
+
+    // Fixed rate: wake once per step, feed the elapsed time to update()
+    const auto tick = std::chrono::duration_cast<engine::duration>(
+        std::chrono::duration<float>(fixedDt));
+    engine::time_point last = engine::now();
+    engine::time_point next = last;
+    while (!g_stop && (forever || world.step_count() < options.steps)) {
+        next += tick;
+        std::this_thread::sleep_until(next);
+
+        const engine::time_point now = engine::now();
+        const std::chrono::duration<float> dt = now - last;
+        last = now;
+        if (now - next > tick)
+            next = now;
+
+        const std::uint64_t before = world.step_count();
+        world.update(dt.count());
+        for (std::uint64_t i = before; i < world.step_count(); ++i)
+            rvo.step();
+        report_if_due();
+    }
+    return 0;
+}
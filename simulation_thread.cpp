@@ -0,0 +1,109 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#include "simulation_thread.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "boid_flock.h"
+#include "engine_time.h"
+#include "physics_world.h"
+
+void capture_snapshot(const PhysicsWorld& world, RenderSnapshot& dst)
+{
+    dst.step = world.step_count();
+    dst.time = engine::now();
+    dst.fixedDt = world.fixed_dt();
+    dst.alpha = world.alpha();
+    const std::vector<Body>& bodies = world.getBodies();
+    dst.bodies.assign(bodies.begin(), bodies.end());
+    const std::vector<glm::vec2>& prevBodies = world.previous_positions();
+    dst.prevBodyPositions.assign(prevBodies.begin(), prevBodies.end());
+    if (const Flock* flock = world.flock()) {
+        const std::vector<Boid>& boids = flock->getBoids();
+        dst.boids.assign(boids.begin(), boids.end());
+        const std::vector<glm::vec2>& prevBoids = flock->getPreviousPositions();
+        dst.prevBoidPositions.assign(prevBoids.begin(), prevBoids.end());
+    } else {
+        dst.boids.clear();
+        dst.prevBoidPositions.clear();
+    }
+    const std::vector<ContactManifold>& manifolds = world.getManifolds();
+    dst.manifolds.assign(manifolds.begin(), manifolds.end());
+}
+
+float render_alpha(const RenderSnapshot& snapshot, const engine::time_point now)
+{
+    if (snapshot.fixedDt <= 0.0f)
+        return 1.0f;
+    const std::chrono::duration<float> since = now - snapshot.time;
+    return std::clamp(snapshot.alpha + since.count() / snapshot.fixedDt, 0.0f, 1.0f);
+}
+
+SimulationThread::SimulationThread(PhysicsWorld& world)
+    : m_world(world)
+{
+}
+
+SimulationThread::~SimulationThread()
+{
+    stop();
+}
+
+void SimulationThread::start()
+{
+    if (m_thread.joinable())
+        return;
+    publish();
+    m_running.store(true, std::memory_order_relaxed);
+    m_thread = std::thread([this] { run(); });
+}
+
+void SimulationThread::stop()
+{
+    m_running.store(false, std::memory_order_relaxed);
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+const RenderSnapshot& SimulationThread::latest()
+{
+    m_snapshots.update();
+    return m_snapshots.front();
+}
+
+void SimulationThread::publish()
+{
+    capture_snapshot(m_world, m_snapshots.back());
+    m_snapshots.publish();
+    m_published.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Wakes once per fixed_dt and hands the elapsed wall time to update(),
+// so its accumulator and overrun guard work as on the main thread.
+// After a stall the schedule restarts from now instead of bursting.
+void SimulationThread::run()
+{
+    const auto tick = std::chrono::duration_cast<engine::duration>(
+        std::chrono::duration<float>(m_world.fixed_dt()));
+
+    engine::time_point last = engine::now();
+    engine::time_point next = last;
+    while (m_running.load(std::memory_order_relaxed)) {
+        next += tick;
+        std::this_thread::sleep_until(next);
+
+        const engine::time_point now = engine::now();
+        const std::chrono::duration<float> dt = now - last;
+        last = now;
+        if (now - next > tick)
+            next = now;
+
+        const std::uint64_t before = m_world.step_count();
+        m_world.update(dt.count());
+        if (m_world.step_count() != before)
+            publish();
+    }
+}
@@ -0,0 +1,85 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#ifndef ENGINELOOP_SIMULATION_THREAD_H
+#define ENGINELOOP_SIMULATION_THREAD_H
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "body.h"
+#include "boid.h"
+#include "contact_manifold.h"
+#include "engine_time.h"
+#include "triple_buffer.h"
+
+class PhysicsWorld;
+
+// Copy of everything the renderer draws, taken after a fixed step.
+// Bodies and boids are copied whole, they hold the draw state (extent,
+// shape, onGround) next to position and velocity.
+struct RenderSnapshot {
+    std::uint64_t step = 0;         // PhysicsWorld::step_count() when taken
+    engine::time_point time{};      // wall clock time of the capture
+    float fixedDt = 0.0f;
+    float alpha = 0.0f;             // PhysicsWorld::alpha() when taken
+    std::vector<Body> bodies;
+    std::vector<Boid> boids;        // empty without an attached flock
+    std::vector<ContactManifold> manifolds;
+    // Positions at the start of the last step, for render interpolation
+    std::vector<glm::vec2> prevBodyPositions;
+    std::vector<glm::vec2> prevBoidPositions;
+};
+
+// Interpolation factor for drawing a snapshot at wall clock time now:
+// the alpha it was taken with plus the time since, clamped to 1 when the
+// next snapshot is late.
+float render_alpha(const RenderSnapshot& snapshot, engine::time_point now);
+
+// Fills dst from the world and its attached flock. Vectors are assigned,
+// so a reused snapshot stops allocating once it is large enough.
+void capture_snapshot(const PhysicsWorld& world, RenderSnapshot& dst);
+
+// Runs a PhysicsWorld (and its attached Flock) on its own thread at the
+// fixed rate of the world. After every tick that stepped the world a
+// snapshot is published through a triple buffer; the render thread reads
+// the newest one without blocking the simulation or being blocked by it.
+//
+// While the thread runs the world belongs to it: the owner must not
+// touch the world or the flock between start() and stop().
+class SimulationThread {
+public:
+    explicit SimulationThread(PhysicsWorld& world);
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    // Publishes a snapshot of the current state, then starts stepping.
+    void start();
+    // Joins the thread, the world can be used directly again afterwards.
+    void stop();
+
+    [[nodiscard]] bool running() const { return m_running.load(std::memory_order_relaxed); }
+
+    // Render thread only: the newest published snapshot. Stays valid
+    // until the next call.
+    const RenderSnapshot& latest();
+
+    // Snapshots published since construction
+    [[nodiscard]] std::uint64_t published() const { return m_published.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void publish();
+
+    PhysicsWorld& m_world;
+    TripleBuffer<RenderSnapshot> m_snapshots;
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<std::uint64_t> m_published{0};
+};
+
+#endif //ENGINELOOP_SIMULATION_THREAD_H
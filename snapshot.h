@@ -0,0 +1,214 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#ifndef ENGINELOOP_SNAPSHOT_H
+#define ENGINELOOP_SNAPSHOT_H
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+// Flat binary snapshot: a header, then sections that each hold the raw
+// bytes of one array of trivially copyable records. Saving is a memcpy
+// per section, there is no per object encoding. Every section records
+// its element size, so a snapshot written by a build with a different
+// struct layout is rejected instead of misread. Same machine / same
+// build use only: byte order and layout are the writer's.
+enum class SnapshotKind : uint16_t {
+    World = 1,
+    Flock = 2,
+    RVO = 3,
+    Scenario = 4
+};
+
+constexpr uint32_t SNAPSHOT_MAGIC = 0x534E4745;     // "EGNS"
+constexpr uint16_t SNAPSHOT_VERSION = 1;
+
+struct SnapshotHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t kind;
+    uint32_t sectionCount;
+    uint32_t reserved;
+    uint64_t size;          // whole snapshot in bytes
+};
+
+struct SnapshotSection {
+    uint32_t id;
+    uint32_t elementSize;
+    uint64_t count;
+};
+
+// Appends to a byte buffer that is cleared first. Keep the buffer around
+// between saves, it stops allocating once it is large enough.
+class SnapshotWriter {
+public:
+    SnapshotWriter(std::vector<std::byte>& out, SnapshotKind kind) : m_out(out)
+    {
+        m_out.clear();
+        const SnapshotHeader header{SNAPSHOT_MAGIC, SNAPSHOT_VERSION,
+                                    static_cast<uint16_t>(kind), 0, 0, 0};
+        append(&header, sizeof(header));
+    }
+
+    template <typename T>
+    void write(const uint32_t id, std::span<const T> items)
+    {
+        begin<T>(id, items.size());
+        append(items.data(), items.size_bytes());
+        end();
+    }
+
+    template <typename T>
+    void write_value(const uint32_t id, const T& value) { write(id, std::span<const T>(&value, 1)); }
+
+    // Section filled record by record, for state that is not kept in one
+    // array. Exactly count records have to be added before end().
+    template <typename T>
+    void begin(const uint32_t id, const uint64_t count)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const SnapshotSection section{id, static_cast<uint32_t>(sizeof(T)), count};
+        append(&section, sizeof(section));
+    }
+
+    template <typename T>
+    void add(const T& record) { append(&record, sizeof(T)); }
+
+    void end()
+    {
+        // Sections start 8 byte aligned, the data can be mapped in place
+        static constexpr std::byte pad[8]{};
+        append(pad, (8 - m_out.size() % 8) % 8);
+        ++m_sections;
+    }
+
+    // Patches section count and size into the header
+    void finish()
+    {
+        SnapshotHeader header;
+        std::memcpy(&header, m_out.data(), sizeof(header));
+        header.sectionCount = m_sections;
+        header.size = m_out.size();
+        std::memcpy(m_out.data(), &header, sizeof(header));
+    }
+
+private:
+    void append(const void* data, const size_t bytes)
+    {
+        const auto* p = static_cast<const std::byte*>(data);
+        m_out.insert(m_out.end(), p, p + bytes);
+    }
+
+    std::vector<std::byte>& m_out;
+    uint32_t m_sections = 0;
+};
+
+// Checks the header and indexes the sections on construction. Callers
+// test every section they need with has() before reading any of them,
+// so a bad snapshot leaves the target untouched.
+class SnapshotReader {
+public:
+    static constexpr size_t MAX_SECTIONS = 16;
+
+    SnapshotReader(std::span<const std::byte> in, const SnapshotKind kind)
+    {
+        SnapshotHeader header;
+        if (in.size() < sizeof(header))
+            return;
+        std::memcpy(&header, in.data(), sizeof(header));
+        if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION ||
+            header.kind != static_cast<uint16_t>(kind) || header.size != in.size() ||
+            header.sectionCount > MAX_SECTIONS)
+            return;
+
+        size_t offset = sizeof(header);
+        for (uint32_t s = 0; s < header.sectionCount; ++s) {
+            SnapshotSection section;
+            if (in.size() - offset < sizeof(section))
+                return;
+            std::memcpy(&section, in.data() + offset, sizeof(section));
+            offset += sizeof(section);
+            if (section.elementSize == 0 ||
+                section.count > (in.size() - offset) / section.elementSize)
+                return;
+            const size_t bytes = section.elementSize * section.count;
+            const size_t pad = (8 - (offset + bytes) % 8) % 8;
+            // the padding of the last section may be cut off by a bad file
+            if (pad > in.size() - offset - bytes)
+                return;
+            m_sections[s] = {section, in.data() + offset};
+            offset += bytes + pad;
+        }
+        m_count = header.sectionCount;
+        m_valid = offset == in.size();
+    }
+
+    [[nodiscard]] bool valid() const { return m_valid; }
+
+    // Section present with records of T's size (and exactly one record
+    // when single is set)
+    template <typename T>
+    [[nodiscard]] bool has(const uint32_t id, const bool single = false) const
+    {
+        const Ref* ref = find(id);
+        return ref && ref->section.elementSize == sizeof(T) &&
+               (!single || ref->section.count == 1);
+    }
+
+    template <typename T>
+    void read(const uint32_t id, std::vector<T>& out) const
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const Ref* ref = find(id);
+        out.resize(ref->section.count);
+        std::memcpy(out.data(), ref->data, ref->section.count * sizeof(T));
+    }
+
+    // The records in place, for buffers that outlive the reader (a
+    // mapped file). Empty when the section is missing, has another
+    // element size or is misaligned for T.
+    template <typename T>
+    [[nodiscard]] std::span<const T> view(const uint32_t id) const
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const Ref* ref = find(id);
+        if (!ref || ref->section.elementSize != sizeof(T) ||
+            reinterpret_cast<uintptr_t>(ref->data) % alignof(T) != 0)
+            return {};
+        return {reinterpret_cast<const T*>(ref->data), static_cast<size_t>(ref->section.count)};
+    }
+
+    template <typename T>
+    void read_value(const uint32_t id, T& out) const
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        std::memcpy(&out, find(id)->data, sizeof(T));
+    }
+
+private:
+    struct Ref {
+        SnapshotSection section{};
+        const std::byte* data = nullptr;
+    };
+
+    [[nodiscard]] const Ref* find(const uint32_t id) const
+    {
+        if (!m_valid)
+            return nullptr;
+        for (uint32_t s = 0; s < m_count; ++s)
+            if (m_sections[s].section.id == id)
+                return &m_sections[s];
+        return nullptr;
+    }
+
+    std::array<Ref, MAX_SECTIONS> m_sections{};
+    uint32_t m_count = 0;
+    bool m_valid = false;
+};
+
+#endif //ENGINELOOP_SNAPSHOT_H
@@ -0,0 +1,181 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#ifndef ENGINELOOP_SPSC_RING_H
+#define ENGINELOOP_SPSC_RING_H
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Bounded lock free queue between exactly one producer thread and one
+// consumer thread, for handing data from the simulation thread to a
+// background writer. try_push and pop never wait: try_push fails when
+// there is no room, pop returns whatever is there.
+//
+// head and tail only grow, the slot is the index masked by the power of
+// two capacity. Each side keeps a copy of the other side's index and
+// reloads it only when that copy says the ring is full (or empty), so a
+// push or pop usually touches no cache line the other thread writes.
+template <typename T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+public:
+    // capacity is rounded up to a power of two
+    explicit SpscRing(size_t capacity)
+    {
+        size_t n = 1;
+        while (n < capacity)
+            n *= 2;
+        m_items.resize(n);
+        m_mask = n - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer: all n items or none
+    bool try_push(const T* items, const size_t n)
+    {
+        if (n == 0)
+            return true;
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head + n - m_tail_cache > m_items.size()) {
+            m_tail_cache = m_tail.load(std::memory_order_acquire);
+            if (head + n - m_tail_cache > m_items.size())
+                return false;
+        }
+        copy_in(head, items, n);
+        m_head.store(head + n, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& item) { return try_push(&item, 1); }
+
+    // Consumer: up to max items, returns how many were taken
+    size_t pop(T* out, const size_t max)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (m_head_cache == tail)
+            m_head_cache = m_head.load(std::memory_order_acquire);
+        const size_t n = std::min(max, m_head_cache - tail);
+        if (n == 0)
+            return 0;
+        copy_out(tail, out, n);
+        m_tail.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    // Items waiting, exact only on a quiet ring
+    [[nodiscard]] size_t size() const
+    {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] size_t capacity() const { return m_items.size(); }
+
+private:
+    // Wrapping copies, at most two memcpy each
+    void copy_in(const size_t at, const T* items, const size_t n)
+    {
+        const size_t i = at & m_mask;
+        const size_t first = std::min(n, m_items.size() - i);
+        std::memcpy(&m_items[i], items, first * sizeof(T));
+        std::memcpy(m_items.data(), items + first, (n - first) * sizeof(T));
+    }
+
+    void copy_out(const size_t at, T* out, const size_t n) const
+    {
+        const size_t i = at & m_mask;
+        const size_t first = std::min(n, m_items.size() - i);
+        std::memcpy(out, &m_items[i], first * sizeof(T));
+        std::memcpy(out + first, m_items.data(), (n - first) * sizeof(T));
+    }
+
+    std::vector<T> m_items;
+    size_t m_mask = 0;
+
+    alignas(64) std::atomic<size_t> m_head{0};  // next write, set by the producer
+    size_t m_tail_cache = 0;                    // producer's copy of m_tail
+    alignas(64) std::atomic<size_t> m_tail{0};  // next read, set by the consumer
+    size_t m_head_cache = 0;                    // consumer's copy of m_head
+};
+
+// SpscRing for producers that must never wait, such as a recorder on the
+// stepping thread. A batch larger than the whole ring could never be
+// pushed, and waiting for the consumer to make room in pieces would hold
+// up the producer. Instead the producer moves on to a new ring with room
+// for a few such batches and stops pushing into the old one. The
+// consumer drains the old ring first and then follows, so the order of
+// the items is kept. The old ring is freed by the producer once the
+// consumer has left it. A second batch too large for the new ring before
+// that is refused like a full ring.
+template <typename T>
+class GrowingSpscRing {
+public:
+    explicit GrowingSpscRing(const size_t capacity)
+        : m_ring(std::make_unique<SpscRing<T>>(capacity)),
+          m_reading(m_ring.get())
+    {
+        m_write.store(m_ring.get(), std::memory_order_relaxed);
+        m_read.store(m_ring.get(), std::memory_order_relaxed);
+    }
+
+    GrowingSpscRing(const GrowingSpscRing&) = delete;
+    GrowingSpscRing& operator=(const GrowingSpscRing&) = delete;
+
+    // Producer: all n items or none, never waits
+    bool try_push(const T* items, const size_t n)
+    {
+        if (m_old && m_read.load(std::memory_order_acquire) == m_ring.get())
+            m_old.reset();
+        if (n > m_ring->capacity()) {
+            if (m_old)
+                return false;
+            m_old = std::move(m_ring);
+            m_ring = std::make_unique<SpscRing<T>>(std::max(2 * m_old->capacity(), 4 * n));
+            m_write.store(m_ring.get(), std::memory_order_release);
+            ++m_grows;
+        }
+        return m_ring->try_push(items, n);
+    }
+
+    // Consumer: up to max items, returns how many were taken. The ring
+    // the producer writes to is read before popping, so a switch is only
+    // made once everything pushed into the old ring has been taken.
+    size_t pop(T* out, const size_t max)
+    {
+        SpscRing<T>* next = m_write.load(std::memory_order_acquire);
+        const size_t n = m_reading->pop(out, max);
+        if (n > 0 || next == m_reading)
+            return n;
+        m_reading = next;
+        m_read.store(next, std::memory_order_release);
+        return m_reading->pop(out, max);
+    }
+
+    // Producer side: room of the ring pushed into
+    [[nodiscard]] size_t capacity() const { return m_ring->capacity(); }
+
+    // Producer side: how often a larger ring was swapped in
+    [[nodiscard]] std::uint64_t grows() const { return m_grows; }
+
+private:
+    // Producer
+    std::unique_ptr<SpscRing<T>> m_ring;
+    std::unique_ptr<SpscRing<T>> m_old;         // until the consumer left it
+    std::uint64_t m_grows = 0;
+    // Consumer
+    SpscRing<T>* m_reading;
+
+    alignas(64) std::atomic<SpscRing<T>*> m_write{nullptr};    // set by the producer
+    alignas(64) std::atomic<SpscRing<T>*> m_read{nullptr};     // set by the consumer
+};
+
+#endif //ENGINELOOP_SPSC_RING_H
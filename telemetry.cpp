@@ -0,0 +1,203 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#include "telemetry.h"
+
+#include <chrono>
+#include <fstream>
+
+#include "boid_flock.h"
+
+TelemetryExporter::~TelemetryExporter()
+{
+    close();
+}
+
+bool TelemetryExporter::open(const std::string& path, const TelemetrySettings& settings)
+{
+    if (m_ring)
+        return false;
+
+    const bool csv = settings.format == TelemetryFormat::Csv;
+    auto out = std::make_unique<std::ofstream>(path, csv ? std::ios::trunc : std::ios::binary | std::ios::trunc);
+    if (!*out)
+        return false;
+
+    m_settings = settings;
+    if (m_settings.decimation == 0)
+        m_settings.decimation = 1;
+    if (m_settings.blockRecords == 0)
+        m_settings.blockRecords = 1;
+    m_ring = std::make_unique<GrowingSpscRing<TelemetryRecord>>(m_settings.ringRecords);
+    m_records = 0;
+    m_dropped = 0;
+    m_written.store(0, std::memory_order_relaxed);
+    m_stop.store(false, std::memory_order_relaxed);
+    m_writer = std::thread(&TelemetryExporter::writer_loop, this, std::move(out));
+    return true;
+}
+
+void TelemetryExporter::close()
+{
+    if (!m_ring)
+        return;
+    m_stop.store(true, std::memory_order_release);
+    m_writer.join();
+    m_ring.reset();
+}
+
+void TelemetryExporter::on_step(const PhysicsWorld& world)
+{
+    if (!m_ring)
+        return;
+
+    const std::uint64_t step = world.step_count();
+    m_batch.clear();
+
+    if (step % m_settings.decimation == 0) {
+        if (m_settings.bodies) {
+            for (const Body& b: world.getBodies()) {
+                if (m_settings.dynamicBodiesOnly && b.type == BodyType::Static)
+                    continue;
+                m_batch.push_back({step, TelemetryKind::Body, b.id, 0, b.position, b.velocity});
+            }
+        }
+        const Flock* flock = world.flock();
+        if (m_settings.boids && flock) {
+            for (const Boid& b: flock->getBoids())
+                m_batch.push_back({step, TelemetryKind::Boid, b.body.id, 0, b.body.position, b.body.velocity});
+        }
+    }
+
+    if (m_settings.contacts) {
+        const ContactCache& cache = world.contact_cache();
+        for (const ContactPair& p: cache.begun())
+            m_batch.push_back({step, TelemetryKind::ContactBegin, p.bodyA, p.bodyB, {}, {}});
+        for (const ContactPair& p: cache.ended())
+            m_batch.push_back({step, TelemetryKind::ContactEnd, p.bodyA, p.bodyB, {}, {}});
+    }
+
+    if (m_batch.empty())
+        return;
+    if (m_ring->try_push(m_batch.data(), m_batch.size())) {
+        m_records += m_batch.size();
+    } else {
+        ++m_dropped;
+    }
+}
+
+static const char* kind_name(const TelemetryKind kind)
+{
+    switch (kind) {
+        case TelemetryKind::Body: return "body";
+        case TelemetryKind::Boid: return "boid";
+        case TelemetryKind::ContactBegin: return "begin";
+        case TelemetryKind::ContactEnd: return "end";
+    }
+    return "?";
+}
+
+// Rows of one block, column by column
+struct TelemetryColumns {
+    std::vector<std::uint64_t> step;
+    std::vector<std::uint8_t> kind;
+    std::vector<std::uint32_t> id;
+    std::vector<std::uint32_t> other;
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> vx;
+    std::vector<float> vy;
+
+    void add(const TelemetryRecord& r)
+    {
+        step.push_back(r.step);
+        kind.push_back(static_cast<std::uint8_t>(r.kind));
+        id.push_back(r.id);
+        other.push_back(r.other);
+        x.push_back(r.position.x);
+        y.push_back(r.position.y);
+        vx.push_back(r.velocity.x);
+        vy.push_back(r.velocity.y);
+    }
+
+    void clear()
+    {
+        step.clear();
+        kind.clear();
+        id.clear();
+        other.clear();
+        x.clear();
+        y.clear();
+        vx.clear();
+        vy.clear();
+    }
+
+    template <typename T>
+    static void write_column(std::ostream& out, const std::vector<T>& column)
+    {
+        out.write(reinterpret_cast<const char*>(column.data()),
+                  static_cast<std::streamsize>(column.size() * sizeof(T)));
+    }
+
+    void write(std::ostream& out) const
+    {
+        const auto count = static_cast<std::uint32_t>(step.size());
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        write_column(out, step);
+        write_column(out, kind);
+        write_column(out, id);
+        write_column(out, other);
+        write_column(out, x);
+        write_column(out, y);
+        write_column(out, vx);
+        write_column(out, vy);
+    }
+};
+
+// The stop flag is read before the ring, so every row pushed before
+// close() is written when the loop ends
+void TelemetryExporter::writer_loop(std::unique_ptr<std::ostream> out)
+{
+    const bool csv = m_settings.format == TelemetryFormat::Csv;
+    if (csv) {
+        *out << "step,kind,id,other,x,y,vx,vy\n";
+        out->precision(9);
+    } else {
+        const std::uint32_t magic = TELEMETRY_MAGIC;
+        const std::uint16_t version[2] = {TELEMETRY_VERSION, 0};
+        out->write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+        out->write(reinterpret_cast<const char*>(version), sizeof(version));
+    }
+
+    std::vector<TelemetryRecord> chunk(1024);
+    TelemetryColumns columns;
+    for (;;) {
+        const bool stopping = m_stop.load(std::memory_order_acquire);
+        const size_t n = m_ring->pop(chunk.data(), chunk.size());
+        for (size_t i = 0; i < n; ++i) {
+            const TelemetryRecord& r = chunk[i];
+            if (csv) {
+                *out << r.step << ',' << kind_name(r.kind) << ',' << r.id << ',' << r.other << ','
+                     << r.position.x << ',' << r.position.y << ','
+                     << r.velocity.x << ',' << r.velocity.y << '\n';
+                continue;
+            }
+            columns.add(r);
+            if (columns.step.size() >= m_settings.blockRecords) {
+                columns.write(*out);
+                columns.clear();
+            }
+        }
+        m_written.fetch_add(n, std::memory_order_relaxed);
+        if (n > 0)
+            continue;
+        if (stopping)
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    if (!columns.step.empty())
+        columns.write(*out);
+    out->flush();
+}
@@ -0,0 +1,111 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#ifndef ENGINELOOP_TELEMETRY_H
+#define ENGINELOOP_TELEMETRY_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "physics_world.h"
+#include "spsc_ring.h"
+
+enum class TelemetryKind : std::uint8_t {
+    Body = 1,           // id, position, velocity
+    Boid = 2,           // id, position, velocity
+    ContactBegin = 3,   // id = body A, other = body B
+    ContactEnd = 4
+};
+
+// One exported row. Fixed size, so rows go through the ring as they are.
+struct TelemetryRecord {
+    std::uint64_t step;
+    TelemetryKind kind;
+    std::uint32_t id;
+    std::uint32_t other;
+    glm::vec2 position;
+    glm::vec2 velocity;
+};
+
+enum class TelemetryFormat {
+    // step,kind,id,other,x,y,vx,vy with kind as body | boid | begin | end
+    Csv,
+    // "EGTM", u16 version, u16 0, then blocks of u32 count followed by
+    // the columns u64 step, u8 kind, u32 id, u32 other, f32 x, f32 y,
+    // f32 vx, f32 vy, count values each
+    Columnar
+};
+
+constexpr std::uint32_t TELEMETRY_MAGIC = 0x4D544745;   // "EGTM"
+constexpr std::uint16_t TELEMETRY_VERSION = 1;
+
+struct TelemetrySettings {
+    TelemetryFormat format = TelemetryFormat::Csv;
+    // Bodies and boids are sampled every decimation-th step. Contact
+    // begin / end events are exported from every step, they are rare
+    // and a decimated stream would miss short contacts.
+    std::uint32_t decimation = 1;
+    bool bodies = true;
+    bool dynamicBodiesOnly = true;      // static bodies never change
+    bool boids = true;
+    bool contacts = true;
+    std::size_t ringRecords = 1 << 16;  // queue to the writer thread
+    std::size_t blockRecords = 4096;    // rows per columnar block
+};
+
+// Exports per step state for offline analysis. Rows are copied into a
+// lock free ring on the stepping thread; a writer thread drains the ring
+// and does all formatting and file IO. A step whose rows do not fit into
+// the ring is dropped whole and counted, the step is not held up. A step
+// with more rows than the whole ring (ringRecords too small for the
+// world) makes the ring grow, see GrowingSpscRing.
+//
+// Attach with PhysicsWorld::add_step_listener.
+class TelemetryExporter : public StepListener {
+public:
+    TelemetryExporter() = default;
+    ~TelemetryExporter() override;
+
+    TelemetryExporter(const TelemetryExporter&) = delete;
+    TelemetryExporter& operator=(const TelemetryExporter&) = delete;
+
+    // false when the file cannot be created or an export is running
+    bool open(const std::string& path, const TelemetrySettings& settings = {});
+
+    // Writes out everything queued, then closes the file
+    void close();
+
+    [[nodiscard]] bool is_open() const { return m_ring != nullptr; }
+
+    void on_step(const PhysicsWorld& world) override;
+
+    [[nodiscard]] std::uint64_t records() const { return m_records; }
+    [[nodiscard]] std::uint64_t dropped_steps() const { return m_dropped; }
+    // Current size of the ring, grown from ringRecords if a step did not fit
+    [[nodiscard]] std::size_t ring_records() const { return m_ring ? m_ring->capacity() : 0; }
+
+    // Rows the writer thread has taken off the queue so far
+    [[nodiscard]] std::uint64_t records_written() const { return m_written.load(std::memory_order_relaxed); }
+
+private:
+    void writer_loop(std::unique_ptr<std::ostream> out);
+
+    TelemetrySettings m_settings;
+    std::unique_ptr<GrowingSpscRing<TelemetryRecord>> m_ring;
+    std::thread m_writer;
+    std::atomic<bool> m_stop{false};
+    std::atomic<std::uint64_t> m_written{0};
+
+    // Stepping thread only
+    std::vector<TelemetryRecord> m_batch;
+    std::uint64_t m_records = 0;
+    std::uint64_t m_dropped = 0;
+};
+
+#endif //ENGINELOOP_TELEMETRY_H
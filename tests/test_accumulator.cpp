@@ -94,3 +94,64 @@ TEST(Accumulator, LargeFrameDtMultipleSteps) {
     EXPECT_GE(world.accumulator(), 0.0f);
     EXPECT_LT(world.accumulator(), fixed_dt);
 }
+
+// --- Spiral of death guard ---
+
+TEST(Accumulator, DefaultUpdateNeverFallsBehind) {
+    PhysicsWorld world(1.0f / 60.0f);
+    world.update(1.0f);
+
+    EXPECT_EQ(world.fell_behind_count(), 0u);
+    EXPECT_DOUBLE_EQ(world.dropped_time(), 0.0);
+}
+
+TEST(Accumulator, MaxSubstepsDropsExcessTime) {
+    float fixed_dt = 1.0f / 60.0f;
+    PhysicsWorld world(fixed_dt);
+    world.update_settings().maxSubsteps = 5;
+
+    world.update(1.0f);
+
+    EXPECT_EQ(world.step_count(), 5u);
+    EXPECT_GE(world.accumulator(), 0.0f);
+    EXPECT_LT(world.accumulator(), fixed_dt);
+    EXPECT_EQ(world.fell_behind_count(), 1u);
+    EXPECT_NEAR(world.dropped_time(), 55.0 * fixed_dt, 1e-4);
+
+    // A normal frame afterwards is not counted
+    world.update(fixed_dt);
+    EXPECT_EQ(world.step_count(), 6u);
+    EXPECT_EQ(world.fell_behind_count(), 1u);
+}
+
+TEST(Accumulator, SlowDownCarriesOneUpdateOfSteps) {
+    float fixed_dt = 1.0f / 60.0f;
+    PhysicsWorld world(fixed_dt);
+    world.update_settings().maxSubsteps = 5;
+    world.update_settings().overrun = OverrunPolicy::SlowDown;
+
+    world.update(1.0f);
+
+    EXPECT_EQ(world.step_count(), 5u);
+    EXPECT_NEAR(world.accumulator(), 5.0f * fixed_dt, 1e-5f);
+    EXPECT_NEAR(world.dropped_time(), 50.0 * fixed_dt, 1e-4);
+
+    // The carried steps run on the next frame
+    world.update(0.0f);
+    EXPECT_EQ(world.step_count(), 10u);
+    EXPECT_LT(world.accumulator(), fixed_dt);
+    EXPECT_EQ(world.fell_behind_count(), 1u);
+}
+
+TEST(Accumulator, TimeBudgetStillRunsOneStep) {
+    float fixed_dt = 1.0f / 60.0f;
+    PhysicsWorld world(fixed_dt);
+    world.update_settings().timeBudget = engine::duration(1);
+
+    world.update(1.0f);
+
+    EXPECT_GE(world.step_count(), 1u);
+    EXPECT_LT(world.step_count(), 60u);
+    EXPECT_LT(world.accumulator(), fixed_dt);
+    EXPECT_EQ(world.fell_behind_count(), 1u);
+}
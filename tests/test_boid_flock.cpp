@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+#include "boid_flock.h"
+#include "test_helpers.h"
+
+// Boid with the bench steering parameters
+static Boid make_boid(BodyID id, glm::vec2 pos, glm::vec2 vel = {0, 0}, float perception = 2.5f) {
+    Boid boid;
+    boid.body = make_dynamic(id, pos, vel);
+    boid.perception = perception;
+    boid.max_speed = 9.0f;
+    boid.max_force = 2.5f;
+    boid.w_separation = 10.5f;
+    boid.w_alignment = 10.0f;
+    boid.w_cohesion = 1.0f;
+    return boid;
+}
+
+// Random flock over the whole world, the same seed gives the same boids
+// for both neighbour searches
+static Flock make_random_flock(int n, NeighbourSearch search, uint32_t seed = 7) {
+    std::mt19937 rng{seed};
+    std::uniform_real_distribution<float> rx(-Flock::WORLD_HALF_W, Flock::WORLD_HALF_W);
+    std::uniform_real_distribution<float> ry(-Flock::WORLD_HALF_H, Flock::WORLD_HALF_H);
+    std::uniform_real_distribution<float> rv(-2.0f, 2.0f);
+
+    Flock flock;
+    flock.set_neighbour_search(search);
+    for (int i = 0; i < n; ++i) {
+        const glm::vec2 pos{rx(rng), ry(rng)};
+        flock.add_boid(make_boid(static_cast<BodyID>(i), pos, {rv(rng), rv(rng)}));
+    }
+    return flock;
+}
+
+// The three rules written out one by one, as Flock did before they were
+// fused into a single neighbour pass
+static glm::vec2 reference_steering(const std::vector<Boid>& boids, size_t self) {
+    const Boid& boid = boids[self];
+    glm::vec2 sep{0, 0}, avg{0, 0}, center{0, 0};
+    int sepCount = 0, count = 0;
+    for (size_t i = 0; i < boids.size(); ++i) {
+        if (i == self) continue;
+        const glm::vec2 diff = boid.body.position - boids[i].body.position;
+        const float d = glm::length(diff);
+        if (d > 0.0f && d < boid.perception) {
+            sep += diff / d;
+            ++sepCount;
+        }
+        if (d < boid.perception) {
+            avg += boids[i].body.velocity;
+            center += boids[i].body.position;
+            ++count;
+        }
+    }
+    if (count == 0) return {0, 0};
+    if (sepCount > 0) sep /= static_cast<float>(sepCount);
+    avg /= static_cast<float>(count);
+    if (glm::length(avg) > boid.max_speed)
+        avg = glm::normalize(avg) * boid.max_speed;
+    center /= static_cast<float>(count);
+    glm::vec2 desired = center - boid.body.position;
+    if (glm::length(desired) > 0.0f)
+        desired = glm::normalize(desired) * boid.max_speed;
+
+    glm::vec2 steer = sep * boid.w_separation
+                    + (avg - boid.body.velocity) * boid.w_alignment
+                    + (desired - boid.body.velocity) * boid.w_cohesion;
+    if (glm::length(steer) > boid.max_force)
+        steer = glm::normalize(steer) * boid.max_force;
+    return steer;
+}
+
+static void expect_same_flock(const Flock& a, const Flock& b, float tolerance) {
+    ASSERT_EQ(a.getBoids().size(), b.getBoids().size());
+    for (size_t i = 0; i < a.getBoids().size(); ++i) {
+        const Body& ba = a.getBoids()[i].body;
+        const Body& bb = b.getBoids()[i].body;
+        EXPECT_NEAR(ba.position.x, bb.position.x, tolerance) << "boid " << i;
+        EXPECT_NEAR(ba.position.y, bb.position.y, tolerance) << "boid " << i;
+        EXPECT_NEAR(ba.velocity.x, bb.velocity.x, tolerance) << "boid " << i;
+        EXPECT_NEAR(ba.velocity.y, bb.velocity.y, tolerance) << "boid " << i;
+    }
+}
+
+// ============================================================
+// Neighbour search
+// ============================================================
+
+TEST(FlockNeighbours, GridIsDefault) {
+    Flock flock;
+    EXPECT_EQ(flock.neighbour_search(), NeighbourSearch::Grid);
+}
+
+// The grid visits the same neighbours in a different order, so the sums
+// only differ by rounding.
+TEST(FlockNeighbours, GridMatchesBruteForce) {
+    Flock brute = make_random_flock(400, NeighbourSearch::BruteForce);
+    Flock grid = make_random_flock(400, NeighbourSearch::Grid);
+
+    for (int i = 0; i < 3; ++i) {
+        brute.step(1.0f / 60.0f);
+        grid.step(1.0f / 60.0f);
+    }
+    expect_same_flock(brute, grid, 1e-4f);
+}
+
+// Neighbours on both sides of a cell border (cells start at the lowest
+// boid, so the border is at x = 1) still steer each other.
+TEST(FlockNeighbours, GridFindsNeighbourAcrossCells) {
+    Flock brute;
+    brute.set_neighbour_search(NeighbourSearch::BruteForce);
+    brute.add_boid(make_boid(0, {0.5f, 0.0f}, {0, 0}, 1.0f));
+    brute.add_boid(make_boid(1, {1.4f, 0.0f}, {0, 0}, 1.0f));
+    brute.add_boid(make_boid(2, {0.0f, 5.0f}, {1.0f, 0.0f}, 1.0f));
+
+    Flock grid = brute;
+    grid.set_neighbour_search(NeighbourSearch::Grid);
+
+    brute.step(0.1f);
+    grid.step(0.1f);
+
+    EXPECT_LT(grid.getBoids()[0].body.velocity.x, 0.0f);
+    EXPECT_GT(grid.getBoids()[1].body.velocity.x, 0.0f);
+    expect_same_flock(brute, grid, 0.0f);
+}
+
+// A single stray far away must not blow the grid up to millions of cells.
+TEST(FlockNeighbours, GridHandlesFarStray) {
+    Flock brute = make_random_flock(100, NeighbourSearch::BruteForce);
+    brute.add_boid(make_boid(1000, {1e6f, -1e6f}));
+
+    Flock grid = brute;
+    grid.set_neighbour_search(NeighbourSearch::Grid);
+
+    brute.step(1.0f / 60.0f);
+    grid.step(1.0f / 60.0f);
+    expect_same_flock(brute, grid, 1e-4f);
+}
+
+// Boids at infinity or at both ends of the float range must not blow up
+// the grid; the finite ones still steer like with brute force.
+TEST(FlockNeighbours, GridHandlesNonFinitePositions) {
+    Flock brute = make_random_flock(50, NeighbourSearch::BruteForce);
+    const float inf = std::numeric_limits<float>::infinity();
+    brute.add_boid(make_boid(100, {inf, 0.0f}));
+    brute.add_boid(make_boid(101, {-inf, inf}));
+    brute.add_boid(make_boid(102, {std::numeric_limits<float>::quiet_NaN(), 0.0f}));
+    brute.add_boid(make_boid(103, {3e38f, -3e38f}));
+    brute.add_boid(make_boid(104, {-3e38f, 3e38f}));
+
+    Flock grid = brute;
+    grid.set_neighbour_search(NeighbourSearch::Grid);
+
+    brute.step(1.0f / 60.0f);
+    grid.step(1.0f / 60.0f);
+
+    ASSERT_EQ(brute.getBoids().size(), grid.getBoids().size());
+    for (size_t i = 0; i < 50; ++i) {
+        EXPECT_NEAR(brute.getBoids()[i].body.velocity.x, grid.getBoids()[i].body.velocity.x, 1e-4f);
+        EXPECT_NEAR(brute.getBoids()[i].body.velocity.y, grid.getBoids()[i].body.velocity.y, 1e-4f);
+    }
+}
+
+// ============================================================
+// Fused steering pass
+// ============================================================
+
+// One step of the fused pass against the separate rules, including a
+// neighbour sitting exactly on a boid: it aligns and coheres but gives
+// no separation direction.
+TEST(FlockSteering, FusedPassMatchesSeparateRules) {
+    Flock flock = make_random_flock(60, NeighbourSearch::BruteForce, 11);
+    flock.add_boid(make_boid(60, flock.getBoids()[0].body.position, {1.0f, -1.0f}));
+    const std::vector<Boid> before = flock.getBoids();
+    const float dt = 1.0f / 60.0f;
+
+    flock.step(dt);
+
+    for (size_t i = 0; i < before.size(); ++i) {
+        const glm::vec2 v = before[i].body.velocity
+                          + reference_steering(before, i) * before[i].body.invMass * dt;
+        // below max_speed, so no clamp is involved
+        ASSERT_LT(glm::length(v), before[i].max_speed);
+        EXPECT_NEAR(flock.getBoids()[i].body.velocity.x, v.x, 1e-4f) << "boid " << i;
+        EXPECT_NEAR(flock.getBoids()[i].body.velocity.y, v.y, 1e-4f) << "boid " << i;
+    }
+}
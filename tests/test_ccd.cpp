@@ -318,6 +318,51 @@ TEST(FullSimulation, DynamicBodyStopsAtWall) {
     EXPECT_LE(b->position.x, 8.5f);
 }
 
+TEST(FullSimulation, FastBoxDoesNotTunnelThroughThinBox) {
+    float dt = 1.0f / 60.0f;
+    PhysicsWorld world(dt);
+
+    // One unit per step: the box ends the first step behind the wall
+    Body wall = make_static(0, {0.0f, 2.0f});
+    wall.halfWidth = 0.05f;
+    wall.halfHeight = 1.0f;
+    Body box = make_dynamic(1, {-0.6f, 2.0f}, {60.0f, 0.0f});
+    box.halfWidth = box.halfHeight = 0.2f;
+    world.getBodies().push_back(wall);
+    world.getBodies().push_back(box);
+
+    for (int i = 0; i < 30; ++i)
+        world.fixed_step(dt);
+
+    Body* b = find_body(world, 1);
+    ASSERT_NE(b, nullptr);
+    EXPECT_LE(b->position.x, -0.25f + PhysicsWorld::slop);
+    EXPECT_NEAR(b->velocity.x, 0.0f, 1e-3f);
+}
+
+TEST(FullSimulation, FastBoxesDoNotPassThroughEachOther) {
+    float dt = 1.0f / 60.0f;
+    PhysicsWorld world(dt);
+
+    // Closing at 80 m/s, they would overlap the wrong way round after one step
+    Body left = make_dynamic(0, {-0.5f, 2.0f}, {40.0f, 0.0f});
+    Body right = make_dynamic(1, {0.5f, 2.0f}, {-40.0f, 0.0f});
+    left.halfWidth = left.halfHeight = 0.2f;
+    right.halfWidth = right.halfHeight = 0.2f;
+    world.getBodies().push_back(left);
+    world.getBodies().push_back(right);
+
+    for (int i = 0; i < 30; ++i)
+        world.fixed_step(dt);
+
+    Body* a = find_body(world, 0);
+    Body* b = find_body(world, 1);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_LT(a->position.x, b->position.x);
+    EXPECT_GE(b->position.x - a->position.x, 0.4f - PhysicsWorld::slop);
+}
+
 TEST(FullSimulation, KinematicBodyPushesDynamicBody) {
     float dt = 1.0f / 60.0f;
     PhysicsWorld world(dt);
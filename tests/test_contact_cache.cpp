@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include "contact_cache.h"
+#include "physics_world.h"
+#include "test_helpers.h"
+
+static ContactManifold make_pair_manifold(BodyID a, BodyID b, float Pn = 0.0f) {
+    ContactManifold m{};
+    m.bodyA = a;
+    m.bodyB = b;
+    m.pointCount = 1;
+    m.points[0].normal = {-1.0f, 0.0f};
+    m.points[0].Pn = Pn;
+    return m;
+}
+
+// ============================================================
+// ContactCache
+// ============================================================
+
+TEST(ContactCache, ReportsBeginPersistAndEnd) {
+    ContactCache cache;
+    std::vector<ContactManifold> manifolds;
+
+    cache.begin_step(manifolds);
+    manifolds.clear();
+    cache.merge(manifolds, make_pair_manifold(0, 1));
+    cache.merge(manifolds, make_pair_manifold(2, 3));
+    cache.end_step();
+    EXPECT_EQ(cache.begun().size(), 2u);
+    EXPECT_TRUE(cache.persisted().empty());
+    EXPECT_TRUE(cache.ended().empty());
+
+    cache.begin_step(manifolds);
+    manifolds.clear();
+    cache.merge(manifolds, make_pair_manifold(0, 1));
+    cache.end_step();
+    ASSERT_EQ(cache.persisted().size(), 1u);
+    EXPECT_EQ(cache.persisted()[0].bodyA, 0u);
+    ASSERT_EQ(cache.ended().size(), 1u);
+    EXPECT_EQ(cache.ended()[0].bodyA, 2u);
+    EXPECT_EQ(cache.size(), 1u);
+}
+
+TEST(ContactCache, CarriesSolvedImpulsesToNextStep) {
+    ContactCache cache;
+    std::vector<ContactManifold> manifolds;
+
+    cache.begin_step(manifolds);
+    manifolds.clear();
+    cache.merge(manifolds, make_pair_manifold(4, 7));
+    cache.end_step();
+
+    // The solver writes its impulses into the step's manifolds
+    manifolds[0].points[0].Pn = 3.0f;
+    manifolds[0].points[0].Pt = -1.0f;
+
+    cache.begin_step(manifolds);
+    manifolds.clear();
+    cache.merge(manifolds, make_pair_manifold(4, 7));
+    cache.end_step();
+
+    ASSERT_EQ(manifolds.size(), 1u);
+    EXPECT_FLOAT_EQ(manifolds[0].points[0].Pn, 3.0f);
+    EXPECT_FLOAT_EQ(manifolds[0].points[0].Pt, -1.0f);
+}
+
+TEST(ContactCache, SwappedRolesStartCold) {
+    ContactCache cache;
+    std::vector<ContactManifold> manifolds;
+
+    cache.begin_step(manifolds);
+    manifolds.clear();
+    cache.merge(manifolds, make_pair_manifold(1, 2, 5.0f));
+    cache.end_step();
+
+    cache.begin_step(manifolds);
+    manifolds.clear();
+    cache.merge(manifolds, make_pair_manifold(2, 1));
+    cache.end_step();
+
+    ASSERT_EQ(manifolds.size(), 1u);
+    EXPECT_FLOAT_EQ(manifolds[0].points[0].Pn, 0.0f);
+    EXPECT_EQ(cache.persisted().size(), 1u);
+}
+
+TEST(ContactCache, ManyPairsMergeWithoutDuplicates) {
+    ContactCache cache;
+    std::vector<ContactManifold> manifolds;
+
+    cache.begin_step(manifolds);
+    manifolds.clear();
+    for (BodyID i = 0; i < 5000; ++i)
+        cache.merge(manifolds, make_pair_manifold(i, i + 1, 1.0f));
+    // Second manifold of each pair replaces the first and keeps its impulse
+    for (BodyID i = 0; i < 5000; ++i)
+        cache.merge(manifolds, make_pair_manifold(i, i + 1));
+    cache.end_step();
+
+    ASSERT_EQ(manifolds.size(), 5000u);
+    EXPECT_EQ(cache.size(), 5000u);
+    for (BodyID i = 0; i < 5000; ++i) {
+        EXPECT_EQ(manifolds[i].bodyA, i);
+        EXPECT_FLOAT_EQ(manifolds[i].points[0].Pn, 1.0f);
+    }
+}
+
+// ============================================================
+// Contact cache in PhysicsWorld
+// ============================================================
+
+TEST(ContactCache, WorldKeepsRestingBoxContact) {
+    float dt = 1.0f / 60.0f;
+    PhysicsWorld world(dt);
+    Body ground = make_static(0, {0.0f, 5.0f});
+    ground.halfWidth = ground.halfHeight = 0.5f;
+    Body box = make_kinematic(1, {0.0f, 6.0f});
+    box.halfWidth = box.halfHeight = 0.5f;
+    world.getBodies().push_back(ground);
+    world.getBodies().push_back(box);
+
+    world.fixed_step(dt);
+    EXPECT_EQ(world.contact_cache().begun().size(), 1u);
+
+    world.fixed_step(dt);
+    EXPECT_EQ(world.contact_cache().persisted().size(), 1u);
+
+    find_body(world, 1)->position.y = 7.0f;
+    world.fixed_step(dt);
+    EXPECT_EQ(world.contact_cache().ended().size(), 1u);
+    EXPECT_TRUE(world.getManifolds().empty());
+}
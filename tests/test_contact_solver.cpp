@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "physics_world.h"
 #include "test_helpers.h"
+#include "thread_pool.h"
 
 // ============================================================
 // Contact Solver
@@ -144,3 +145,663 @@ TEST(SplitImpulse, PseudoVelocityResetAfterIntegration) {
     EXPECT_FLOAT_EQ(b.pseudoVelocity.x, 0.0f);
     EXPECT_FLOAT_EQ(b.pseudoVelocity.y, 0.0f);
 }
+
+// ============================================================
+// Iterative Solver (ContactSolver)
+// ============================================================
+
+static ContactManifold make_x_contact(BodyID a, BodyID b, float Pn = 0.0f) {
+    ContactManifold m{};
+    m.bodyA = a;
+    m.bodyB = b;
+    m.pointCount = 1;
+    m.points[0].normal = {-1.0f, 0.0f};
+    m.points[0].penetration = 0.0f;
+    m.points[0].Pn = Pn;
+    return m;
+}
+
+TEST(IterativeSolver, UpdatesBothDynamicBodies) {
+    std::vector<Body> bodies = {
+        make_dynamic(0, {0.0f, 0.0f}, {5.0f, 0.0f}),
+        make_dynamic(1, {1.0f, 0.0f}, {-5.0f, 0.0f}),
+    };
+    std::vector<ContactManifold> manifolds = {make_x_contact(0, 1)};
+
+    ContactSolver solver;
+    solver.prepare(bodies, manifolds, SolverSettings{}, 0.0f);
+    solver.solve_velocities(bodies);
+
+    // Equal masses, inelastic: both stop
+    EXPECT_NEAR(bodies[0].velocity.x, 0.0f, 1e-5f);
+    EXPECT_NEAR(bodies[1].velocity.x, 0.0f, 1e-5f);
+}
+
+TEST(IterativeSolver, WarmStartAppliesCachedImpulse) {
+    std::vector<Body> bodies = {
+        make_dynamic(0, {0.0f, 0.0f}),
+        make_static(1, {1.0f, 0.0f}),
+    };
+    std::vector<ContactManifold> manifolds = {make_x_contact(0, 1, 2.0f)};
+
+    ContactSolver solver;
+    solver.prepare(bodies, manifolds, SolverSettings{}, 0.0f);
+    solver.warm_start(bodies);
+
+    EXPECT_FLOAT_EQ(bodies[0].velocity.x, -2.0f);
+    // Static body is never moved by the solver
+    EXPECT_FLOAT_EQ(bodies[1].velocity.x, 0.0f);
+}
+
+TEST(IterativeSolver, ImpulsesWrittenBackToManifolds) {
+    std::vector<Body> bodies = {
+        make_dynamic(0, {0.0f, 0.0f}, {3.0f, 0.0f}),
+        make_static(1, {1.0f, 0.0f}),
+    };
+    std::vector<ContactManifold> manifolds = {make_x_contact(0, 1)};
+
+    ContactSolver solver;
+    solver.prepare(bodies, manifolds, SolverSettings{}, 0.0f);
+    solver.solve_velocities(bodies);
+    solver.store_impulses(manifolds);
+
+    EXPECT_NEAR(manifolds[0].points[0].Pn, 3.0f, 1e-5f);
+}
+
+TEST(IterativeSolver, ChainConvergesWithIterations) {
+    // Two bodies pushed into a wall: 2 -> 1 -> wall(0)
+    auto run = [](int iterations) {
+        std::vector<Body> bodies = {
+            make_static(0, {2.0f, 0.0f}),
+            make_dynamic(1, {1.0f, 0.0f}, {4.0f, 0.0f}),
+            make_dynamic(2, {0.0f, 0.0f}, {4.0f, 0.0f}),
+        };
+        std::vector<ContactManifold> manifolds = {
+            make_x_contact(2, 1),
+            make_x_contact(1, 0),
+        };
+        SolverSettings settings;
+        settings.velocityIterations = iterations;
+
+        ContactSolver solver;
+        solver.prepare(bodies, manifolds, settings, 0.0f);
+        for (int i = 0; i < iterations; ++i)
+            solver.solve_velocities(bodies);
+        return bodies;
+    };
+
+    auto one = run(1);
+    auto many = run(30);
+
+    // A single pass leaves the outer body still closing on the inner one
+    EXPECT_GT(one[2].velocity.x - one[1].velocity.x, 0.1f);
+    EXPECT_NEAR(many[1].velocity.x, 0.0f, 1e-3f);
+    EXPECT_NEAR(many[2].velocity.x, 0.0f, 1e-3f);
+}
+
+TEST(IterativeSolver, IterationCountIsConfigurable) {
+    PhysicsWorld world(1.0f / 60.0f);
+    EXPECT_EQ(world.solver_settings().velocityIterations, 8);
+
+    world.solver_settings().velocityIterations = 2;
+    EXPECT_EQ(world.solver_settings().velocityIterations, 2);
+}
+
+// ============================================================
+// Contact Islands
+// ============================================================
+
+TEST(ContactIslands, SharedStaticWallDoesNotMergePiles) {
+    std::vector<Body> bodies = {
+        make_static(0, {0.0f, 0.0f}),
+        make_dynamic(1, {-1.0f, 0.0f}),
+        make_dynamic(2, {-2.0f, 0.0f}),
+        make_dynamic(3, {1.0f, 0.0f}),
+    };
+    std::vector<ContactManifold> manifolds = {
+        make_x_contact(1, 0),
+        make_x_contact(2, 1),
+        make_x_contact(3, 0),
+    };
+
+    ContactSolver solver;
+    solver.prepare(bodies, manifolds, SolverSettings{}, 0.0f);
+
+    ASSERT_EQ(solver.islands().size(), 2u);
+    // Largest island first
+    EXPECT_EQ(solver.islands()[0].count, 2u);
+    EXPECT_EQ(solver.islands()[1].count, 1u);
+}
+
+TEST(ContactIslands, ParallelSolveMatchesSerial) {
+    // Many independent two-body piles against their own walls
+    std::vector<Body> bodies;
+    std::vector<ContactManifold> manifolds;
+    for (BodyID pile = 0; pile < 64; ++pile) {
+        const BodyID base = pile * 3;
+        const float y = static_cast<float>(pile) * 10.0f;
+        const float v = 1.0f + static_cast<float>(pile % 7);
+        bodies.push_back(make_static(base, {2.0f, y}));
+        bodies.push_back(make_dynamic(base + 1, {1.0f, y}, {v, 0.0f}));
+        bodies.push_back(make_dynamic(base + 2, {0.0f, y}, {2.0f * v, 0.0f}));
+        manifolds.push_back(make_x_contact(base + 2, base + 1));
+        manifolds.push_back(make_x_contact(base + 1, base));
+    }
+
+    SolverSettings settings;
+    settings.parallelMinContacts = 0;
+
+    std::vector<Body> serial = bodies;
+    ContactSolver s0;
+    s0.prepare(serial, manifolds, settings, 0.0f);
+    s0.solve(serial, settings, nullptr);
+
+    std::vector<Body> parallel = bodies;
+    ThreadPool pool(3);
+    ContactSolver s1;
+    s1.prepare(parallel, manifolds, settings, 0.0f);
+    s1.solve(parallel, settings, &pool);
+
+    EXPECT_EQ(s1.islands().size(), 64u);
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        EXPECT_EQ(serial[i].velocity.x, parallel[i].velocity.x);
+        EXPECT_EQ(serial[i].velocity.y, parallel[i].velocity.y);
+    }
+}
+
+// ============================================================
+// Graph Coloured Batches
+// ============================================================
+
+// N x N grid of dynamic bodies, every neighbour pair in contact,
+// the left column pressed against a static wall. One big island.
+static void make_grid_pile(int n, std::vector<Body>& bodies,
+                           std::vector<ContactManifold>& manifolds) {
+    auto id = [n](int x, int y) { return static_cast<BodyID>(1 + y * n + x); };
+    bodies.push_back(make_static(0, {-1.0f, 0.0f}));
+    for (int y = 0; y < n; ++y)
+        for (int x = 0; x < n; ++x)
+            bodies.push_back(make_dynamic(id(x, y), {float(x), float(y)},
+                                          {-1.0f - 0.1f * float(x), -0.5f}));
+
+    for (int y = 0; y < n; ++y) {
+        ContactManifold wall{};
+        wall.bodyA = id(0, y);
+        wall.bodyB = 0;
+        wall.pointCount = 1;
+        wall.points[0].normal = {1.0f, 0.0f};
+        manifolds.push_back(wall);
+        for (int x = 0; x < n; ++x) {
+            if (x + 1 < n) {
+                ContactManifold m{};
+                m.bodyA = id(x + 1, y);
+                m.bodyB = id(x, y);
+                m.pointCount = 1;
+                m.points[0].normal = {1.0f, 0.0f};
+                manifolds.push_back(m);
+            }
+            if (y + 1 < n) {
+                ContactManifold m{};
+                m.bodyA = id(x, y + 1);
+                m.bodyB = id(x, y);
+                m.pointCount = 1;
+                m.points[0].normal = {0.0f, 1.0f};
+                manifolds.push_back(m);
+            }
+        }
+    }
+}
+
+TEST(ColoredBatches, NoBatchSharesADynamicBody) {
+    std::vector<Body> bodies;
+    std::vector<ContactManifold> manifolds;
+    make_grid_pile(12, bodies, manifolds);
+
+    SolverSettings settings;
+    settings.coloringMinContacts = 16;
+
+    ContactSolver solver;
+    solver.prepare(bodies, manifolds, settings, 0.0f);
+
+    ASSERT_EQ(solver.islands().size(), 1u);
+    ASSERT_GT(solver.islands()[0].batchCount, 1u);
+
+    const auto& rows = solver.contacts();
+    uint32_t covered = 0;
+    for (const ColorBatch& batch : solver.batches()) {
+        EXPECT_FALSE(batch.serial);
+        std::vector<int> seen(bodies.size(), 0);
+        for (uint32_t i = batch.begin; i < batch.begin + batch.count; ++i) {
+            if (rows[i].invMassA > 0.0f) {
+                EXPECT_EQ(seen[rows[i].indexA]++, 0);
+            }
+            if (rows[i].invMassB > 0.0f) {
+                EXPECT_EQ(seen[rows[i].indexB]++, 0);
+            }
+        }
+        covered += batch.count;
+    }
+    EXPECT_EQ(covered, rows.size());
+}
+
+static float max_closing_speed(const std::vector<Body>& bodies,
+                               const std::vector<SolverContact>& rows) {
+    float worst = 0.0f;
+    for (const SolverContact& c : rows) {
+        glm::vec2 dv = bodies[c.indexA].velocity - bodies[c.indexB].velocity;
+        float vn = dv.x * c.normal.x + dv.y * c.normal.y;
+        worst = std::max(worst, -vn);
+    }
+    return worst;
+}
+
+TEST(ColoredBatches, RemovesClosingVelocities) {
+    std::vector<Body> bodies;
+    std::vector<ContactManifold> manifolds;
+    make_grid_pile(10, bodies, manifolds);
+
+    SolverSettings settings;
+    settings.velocityIterations = 400;
+    settings.coloringMinContacts = 16;
+
+    std::vector<Body> solved = bodies;
+    ContactSolver solver;
+    solver.prepare(solved, manifolds, settings, 0.0f);
+    EXPECT_GT(max_closing_speed(solved, solver.contacts()), 0.5f);
+
+    solver.solve(solved, settings, nullptr);
+    EXPECT_LT(max_closing_speed(solved, solver.contacts()), 0.01f);
+}
+
+TEST(ColoredBatches, LaneWidthAndThreadsDoNotChangeResult) {
+    std::vector<Body> bodies;
+    std::vector<ContactManifold> manifolds;
+    make_grid_pile(10, bodies, manifolds);
+
+    auto run = [&](int lanes, ThreadPool* pool) {
+        SolverSettings settings;
+        settings.coloringMinContacts = 16;
+        settings.simdLanes = lanes;
+        settings.batchChunkRows = 16;
+
+        std::vector<Body> out = bodies;
+        ContactSolver solver;
+        solver.prepare(out, manifolds, settings, 0.0f);
+        solver.solve(out, settings, pool);
+        return out;
+    };
+
+    ThreadPool pool(3);
+    const std::vector<Body> reference = run(4, nullptr);
+    for (int lanes : {4, 8, 16}) {
+        const std::vector<Body> result = run(lanes, &pool);
+        for (size_t i = 0; i < bodies.size(); ++i) {
+            EXPECT_EQ(reference[i].velocity.x, result[i].velocity.x) << "lanes " << lanes;
+            EXPECT_EQ(reference[i].velocity.y, result[i].velocity.y) << "lanes " << lanes;
+        }
+    }
+}
+
+TEST(ColoredBatches, LaneKernelMatchesRowByRowSolve) {
+    std::vector<Body> bodies;
+    std::vector<ContactManifold> manifolds;
+    make_grid_pile(10, bodies, manifolds);
+    for (ContactManifold& m : manifolds)
+        m.points[0].Pn = 0.25f;
+
+    SolverSettings settings;
+    settings.coloringMinContacts = 16;
+    settings.velocityIterations = 1;
+
+    // Same row order, once through the lanes and once row by row
+    std::vector<Body> lanes = bodies;
+    ContactSolver batched;
+    batched.prepare(lanes, manifolds, settings, 0.0f);
+    ASSERT_GT(batched.batches().size(), 1u);
+    batched.solve(lanes, settings, nullptr);
+
+    std::vector<Body> rows = bodies;
+    ContactSolver serial;
+    serial.prepare(rows, manifolds, settings, 0.0f);
+    serial.warm_start(rows);
+    serial.solve_velocities(rows);
+
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        EXPECT_EQ(lanes[i].velocity.x, rows[i].velocity.x);
+        EXPECT_EQ(lanes[i].velocity.y, rows[i].velocity.y);
+    }
+}
+
+TEST(ColoredBatches, PositionPassesDoNotDependOnThreads) {
+    std::vector<Body> bodies;
+    std::vector<ContactManifold> manifolds;
+    make_grid_pile(10, bodies, manifolds);
+    for (ContactManifold& m : manifolds)
+        m.points[0].penetration = 0.05f;
+
+    auto run = [&](SolverMode mode, PositionSolver positions, ThreadPool* pool) {
+        SolverSettings settings;
+        settings.mode = mode;
+        settings.positionSolver = positions;
+        settings.coloringMinContacts = 16;
+        settings.batchChunkRows = 16;
+
+        std::vector<Body> out = bodies;
+        ContactSolver solver;
+        solver.prepare(out, manifolds, settings, 0.0f);
+        if (mode == SolverMode::SoftStep) {
+            solver.solve_soft(out, settings, 1.0f / 60.0f, pool);
+        } else {
+            solver.solve(out, settings, pool);
+            if (positions == PositionSolver::SplitImpulse)
+                solver.solve_split_impulse(out, 1.0f / 60.0f, settings, pool);
+            else
+                solver.solve_positions(out, settings, pool);
+        }
+        return out;
+    };
+
+    ThreadPool pool(3);
+    const std::pair<SolverMode, PositionSolver> cases[] = {
+        {SolverMode::SoftStep, PositionSolver::SplitImpulse},
+        {SolverMode::SplitImpulse, PositionSolver::SplitImpulse},
+        {SolverMode::SplitImpulse, PositionSolver::NonLinearGaussSeidel},
+    };
+    for (const auto& [mode, positions] : cases) {
+        const std::vector<Body> reference = run(mode, positions, nullptr);
+        const std::vector<Body> result = run(mode, positions, &pool);
+        for (size_t i = 0; i < bodies.size(); ++i) {
+            EXPECT_EQ(reference[i].position.x, result[i].position.x);
+            EXPECT_EQ(reference[i].position.y, result[i].position.y);
+            EXPECT_EQ(reference[i].velocity.x, result[i].velocity.x);
+            EXPECT_EQ(reference[i].velocity.y, result[i].velocity.y);
+            EXPECT_EQ(reference[i].pseudoVelocity.x, result[i].pseudoVelocity.x);
+            EXPECT_EQ(reference[i].pseudoVelocity.y, result[i].pseudoVelocity.y);
+        }
+    }
+}
+
+// ============================================================
+// Substepped Soft Solver (SolverMode::SoftStep)
+// ============================================================
+
+TEST(SoftStep, DefaultModeIsSplitImpulse) {
+    PhysicsWorld world(1.0f / 60.0f);
+    EXPECT_EQ(world.solver_settings().mode, SolverMode::SplitImpulse);
+}
+
+TEST(SoftStep, PushesOverlappingBodyOutOfWall) {
+    float dt = 1.0f / 60.0f;
+    PhysicsWorld world(dt);
+    world.solver_settings().mode = SolverMode::SoftStep;
+
+    world.getBodies().push_back(make_dynamic(0, {8.05f, 2.0f}));
+    world.getBodies().push_back(make_static(1, {8.0f, 2.0f}));
+
+    for (int i = 0; i < 30; ++i)
+        world.fixed_step(dt);
+
+    const Body& b = world.getBodies()[0];
+    EXPECT_LT(b.position.x, 8.0f + PhysicsWorld::slop);
+    // Overlap is handled by the springs, no pseudo velocity involved
+    EXPECT_FLOAT_EQ(b.pseudoVelocity.x, 0.0f);
+}
+
+TEST(SoftStep, StopsBodyHittingWall) {
+    float dt = 1.0f / 30.0f;
+    PhysicsWorld world(dt);
+    world.solver_settings().mode = SolverMode::SoftStep;
+    world.solver_settings().substeps = 4;
+
+    world.getBodies().push_back(make_dynamic(0, {7.99f, 2.0f}, {10.0f, 0.0f}));
+    world.getBodies().push_back(make_static(1, {8.0f, 2.0f}));
+
+    // Soft contacts remove the overshoot over a few steps, not in one
+    for (int i = 0; i < 60; ++i)
+        world.fixed_step(dt);
+
+    const Body& b = world.getBodies()[0];
+    EXPECT_LT(b.position.x, 8.0f + PhysicsWorld::slop);
+    EXPECT_NEAR(b.velocity.x, 0.0f, 1e-3f);
+}
+
+TEST(SoftStep, ContactReachedAtEndOfStepKeepsPositions) {
+    // Closing at 10 m/s, touching exactly at the end of the step:
+    // a substepped integration never overlaps, the bodies only stop.
+    const float dt = 1.0f / 60.0f;
+    std::vector<Body> bodies = {
+        make_dynamic(0, {0.0f, 0.0f}, {5.0f, 0.0f}),
+        make_dynamic(1, {0.1f, 0.0f}, {-5.0f, 0.0f}),
+    };
+    std::vector<ContactManifold> manifolds = {make_x_contact(0, 1)};
+
+    SolverSettings settings;
+    settings.mode = SolverMode::SoftStep;
+
+    ContactSolver solver;
+    solver.prepare(bodies, manifolds, settings, 0.0f);
+    solver.solve_soft(bodies, settings, dt, nullptr);
+
+    EXPECT_NEAR(bodies[0].velocity.x, 0.0f, 1e-4f);
+    EXPECT_NEAR(bodies[1].velocity.x, 0.0f, 1e-4f);
+    EXPECT_NEAR(bodies[0].position.x, 0.0f, 1e-5f);
+    EXPECT_NEAR(bodies[1].position.x, 0.1f, 1e-5f);
+}
+
+TEST(SoftStep, SolverMovesBothDynamicBodies) {
+    // Deep overlap: the approach of this step alone does not explain it
+    std::vector<Body> bodies = {
+        make_dynamic(0, {0.0f, 0.0f}, {5.0f, 0.0f}),
+        make_dynamic(1, {0.1f, 0.0f}, {-5.0f, 0.0f}),
+    };
+    std::vector<ContactManifold> manifolds = {make_x_contact(0, 1)};
+    manifolds[0].points[0].penetration = 0.5f;
+
+    SolverSettings settings;
+    settings.mode = SolverMode::SoftStep;
+
+    ContactSolver solver;
+    solver.prepare(bodies, manifolds, settings, 0.0f);
+    solver.solve_soft(bodies, settings, 1.0f / 60.0f, nullptr);
+
+    EXPECT_LE(bodies[0].velocity.x, 1e-4f);
+    EXPECT_GE(bodies[1].velocity.x, -1e-4f);
+    // Positions follow the corrected velocities
+    EXPECT_LT(bodies[0].position.x, 0.0f);
+    EXPECT_GT(bodies[1].position.x, 0.1f);
+}
+
+// ============================================================
+// Solver Statistics
+// ============================================================
+
+TEST(SolverStats, RecordsErrorOfEveryIteration) {
+    std::vector<Body> bodies = {
+        make_static(0, {2.0f, 0.0f}),
+        make_dynamic(1, {1.0f, 0.0f}, {4.0f, 0.0f}),
+        make_dynamic(2, {0.0f, 0.0f}, {4.0f, 0.0f}),
+    };
+    std::vector<ContactManifold> manifolds = {
+        make_x_contact(2, 1),
+        make_x_contact(1, 0),
+    };
+    SolverSettings settings;
+    settings.velocityIterations = 30;
+    settings.velocityTolerance = 0.0f;
+
+    ContactSolver solver;
+    solver.prepare(bodies, manifolds, settings, 0.0f);
+    solver.solve(bodies, settings, nullptr);
+
+    const SolverStats& stats = solver.stats();
+    EXPECT_EQ(stats.rows, 2u);
+    EXPECT_EQ(stats.iterations, 30);
+    EXPECT_EQ(stats.islandsConverged, 0u);
+    ASSERT_EQ(stats.maxVelocityError.size(), 30u);
+    ASSERT_EQ(stats.rmsVelocityError.size(), 30u);
+    EXPECT_GT(stats.maxVelocityError.front(), 1.0f);
+    EXPECT_LT(stats.maxVelocityError.back(), 1e-3f);
+    EXPECT_LE(stats.rmsVelocityError.back(), stats.maxVelocityError.back());
+    // Both bodies stop: 4 + 4 units of momentum end up in the wall
+    EXPECT_NEAR(stats.normalImpulse, 8.0f + 4.0f, 1e-2f);
+}
+
+TEST(SolverStats, ConvergedIslandStopsEarly) {
+    std::vector<Body> bodies = {
+        make_dynamic(0, {0.0f, 0.0f}, {3.0f, 0.0f}),
+        make_static(1, {1.0f, 0.0f}),
+    };
+    std::vector<ContactManifold> manifolds = {make_x_contact(0, 1)};
+
+    SolverSettings settings;
+    ContactSolver solver;
+    solver.prepare(bodies, manifolds, settings, 0.0f);
+    solver.solve(bodies, settings, nullptr);
+
+    // First iteration stops the body, the second one finds nothing to do
+    EXPECT_EQ(solver.stats().iterations, 2);
+    EXPECT_EQ(solver.stats().islandsConverged, 1u);
+    EXPECT_NEAR(solver.stats().maxVelocityError[0], 3.0f, 1e-5f);
+    EXPECT_FLOAT_EQ(bodies[0].velocity.x, 0.0f);
+}
+
+TEST(SolverStats, ColoredIslandStopsEarly) {
+    std::vector<Body> bodies;
+    std::vector<ContactManifold> manifolds;
+    make_grid_pile(12, bodies, manifolds);
+
+    SolverSettings settings;
+    settings.coloringMinContacts = 16;
+    settings.velocityIterations = 2000;
+    settings.velocityTolerance = 1e-3f;
+
+    ContactSolver solver;
+    solver.prepare(bodies, manifolds, settings, 0.0f);
+    ASSERT_GT(solver.batches().size(), 0u);
+    solver.solve(bodies, settings, nullptr);
+
+    const SolverStats& stats = solver.stats();
+    EXPECT_LT(stats.iterations, 2000);
+    EXPECT_EQ(stats.islandsConverged, 1u);
+    EXPECT_LT(stats.maxVelocityError.back(), 1e-3f);
+}
+
+TEST(SolverStats, WorldReportsPenetrationLeftAfterSplitImpulse) {
+    float dt = 1.0f / 60.0f;
+    PhysicsWorld world(dt);
+    Body ground = make_static(0, {0.0f, 5.0f});
+    ground.halfWidth = ground.halfHeight = 0.5f;
+    Body box = make_dynamic(1, {0.0f, 5.95f});
+    box.halfWidth = box.halfHeight = 0.5f;
+    world.getBodies().push_back(ground);
+    world.getBodies().push_back(box);
+
+    world.fixed_step(dt);
+
+    const SolverStats& stats = world.solver_stats();
+    EXPECT_EQ(stats.rows, 2u);
+    EXPECT_LT(stats.maxPenetration, 1e-4f);
+}
+
+// ============================================================
+// NGS Position Solver (PositionSolver::NonLinearGaussSeidel)
+// ============================================================
+
+TEST(PositionSolver, DefaultIsSplitImpulse) {
+    SolverSettings settings;
+    EXPECT_EQ(settings.positionSolver, PositionSolver::SplitImpulse);
+}
+
+TEST(PositionSolver, MovesBothBodiesOutOfOverlap) {
+    std::vector<Body> bodies = {
+        make_dynamic(0, {0.0f, 0.0f}),
+        make_dynamic(1, {0.1f, 0.0f}),
+    };
+    std::vector<ContactManifold> manifolds = {make_x_contact(0, 1)};
+    manifolds[0].points[0].penetration = 0.5f;
+
+    SolverSettings settings;
+    settings.maxLinearCorrection = 1.0f;
+
+    ContactSolver solver;
+    solver.prepare(bodies, manifolds, settings, 0.0f);
+    solver.solve_positions(bodies, settings, nullptr);
+
+    // Equal masses share the correction, the slop is left
+    const float moved = bodies[1].position.x - 0.1f;
+    EXPECT_NEAR(-bodies[0].position.x, moved, 1e-6f);
+    EXPECT_NEAR(moved * 2.0f, 0.5f - settings.linearSlop, 1e-5f);
+    // Velocities are not touched
+    EXPECT_FLOAT_EQ(bodies[0].velocity.x, 0.0f);
+    EXPECT_FLOAT_EQ(bodies[1].velocity.x, 0.0f);
+}
+
+TEST(PositionSolver, CorrectionIsCappedPerIteration) {
+    std::vector<Body> bodies = {
+        make_dynamic(0, {0.0f, 0.0f}),
+        make_static(1, {0.1f, 0.0f}),
+    };
+    std::vector<ContactManifold> manifolds = {make_x_contact(0, 1)};
+    manifolds[0].points[0].penetration = 1.0f;
+
+    SolverSettings settings;
+    settings.positionIterations = 2;
+    settings.maxLinearCorrection = 0.2f;
+
+    ContactSolver solver;
+    solver.prepare(bodies, manifolds, settings, 0.0f);
+    solver.solve_positions(bodies, settings, nullptr);
+
+    EXPECT_NEAR(bodies[0].position.x, -0.4f, 1e-5f);
+    EXPECT_EQ(solver.stats().positionIterations, 2);
+}
+
+TEST(PositionSolver, BothSolversResolveChain) {
+    // Box pressed between a box and a wall, both contacts overlapping
+    auto run = [](PositionSolver mode) {
+        float dt = 1.0f / 60.0f;
+        PhysicsWorld world(dt);
+        world.solver_settings().positionSolver = mode;
+        world.solver_settings().positionIterations = 10;
+        auto box = [](Body b) { b.halfWidth = b.halfHeight = 0.5f; return b; };
+        world.getBodies().push_back(box(make_static(0, {0.0f, 5.0f})));
+        world.getBodies().push_back(box(make_dynamic(1, {0.0f, 5.9f})));
+        world.getBodies().push_back(box(make_dynamic(2, {0.0f, 6.8f})));
+        world.fixed_step(dt);
+        return world.solver_stats().maxPenetration;
+    };
+
+    const float split = run(PositionSolver::SplitImpulse);
+    const float ngs = run(PositionSolver::NonLinearGaussSeidel);
+    EXPECT_LT(split, 3.0f * 0.005f);
+    EXPECT_LT(ngs, 3.0f * 0.005f);
+}
+
+TEST(PositionSolver, BoxStackStaysOnStaticBox) {
+    // Default split impulse: once the stack has settled the bottom box
+    // must neither sink into the static box nor be thrown back up
+    float dt = 1.0f / 60.0f;
+    PhysicsWorld world(dt);
+    auto box = [](Body b, float h) { b.halfWidth = b.halfHeight = h; return b; };
+    world.getBodies().push_back(box(make_static(0, {0.0f, -1.0f}), 1.0f));
+    const float y0[] = {0.5f, 1.45f, 2.4f};
+    for (int i = 0; i < 3; ++i)
+        world.getBodies().push_back(box(make_dynamic(static_cast<BodyID>(i + 1), {0.0f, y0[i]},
+                                                     {0.0f, 0.0f}, {0.0f, -9.8f}), 0.5f));
+
+    float maxPenetration = 0.0f;
+    float maxDrift = 0.0f;
+    for (int step = 0; step < 400; ++step) {
+        world.fixed_step(dt);
+        if (step < 120)
+            continue;
+        maxPenetration = std::max(maxPenetration, world.solver_stats().maxPenetration);
+        for (int i = 0; i < 3; ++i) {
+            const Body* b = find_body(world, static_cast<BodyID>(i + 1));
+            ASSERT_NE(b, nullptr);
+            maxDrift = std::max(maxDrift, std::abs(b->position.y - (0.5f + float(i))));
+        }
+    }
+    EXPECT_LT(maxPenetration, PhysicsWorld::slop);
+    EXPECT_LT(maxDrift, 3.0f * PhysicsWorld::slop);
+}
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <cfenv>
+#include <vector>
+#include "determinism.h"
+#include "boid_flock.h"
+#include "rvo_solver.h"
+#include "thread_pool.h"
+#include "test_helpers.h"
+
+// ============================================================
+// StateHash
+// ============================================================
+
+TEST(StateHash, SensitiveToEveryBit) {
+    StateHash a;
+    StateHash b;
+    a.add(1.0f);
+    b.add(std::nextafter(1.0f, 2.0f));
+
+    EXPECT_NE(a.value(), b.value());
+}
+
+TEST(StateHash, SensitiveToOrder) {
+    StateHash a;
+    StateHash b;
+    a.add(glm::vec2{1.0f, 2.0f});
+    b.add(glm::vec2{2.0f, 1.0f});
+
+    EXPECT_NE(a.value(), b.value());
+}
+
+TEST(StateHash, FpScopeRestoresRounding) {
+    std::fesetround(FE_UPWARD);
+    {
+        const DeterministicFpScope fp;
+        EXPECT_EQ(std::fegetround(), FE_TONEAREST);
+    }
+    EXPECT_EQ(std::fegetround(), FE_UPWARD);
+    std::fesetround(FE_TONEAREST);
+}
+
+// ============================================================
+// Lockstep world
+// ============================================================
+
+// Boxes dropped onto a floor in overlapping rows, plus a flock
+static void make_lockstep_scene(PhysicsWorld& world, Flock& flock) {
+    make_box_scene(world, 12, 6, {-6.0f, 0.5f});
+
+    for (int i = 0; i < 20; ++i) {
+        Boid boid{};
+        boid.body = make_dynamic(static_cast<BodyID>(i), {0.3f * float(i) - 3.0f, 2.0f},
+                                 {1.0f, 0.1f * float(i)});
+        boid.perception = 2.0f;
+        boid.max_speed = 4.0f;
+        boid.max_force = 2.0f;
+        boid.w_separation = 1.5f;
+        boid.w_alignment = 1.0f;
+        boid.w_cohesion = 1.0f;
+        flock.add_boid(boid);
+    }
+    world.attach_flock(&flock);
+    world.set_deterministic(true);
+}
+
+TEST(Lockstep, HashIsZeroWhenDisabled) {
+    PhysicsWorld world(1.0f / 60.0f);
+    world.getBodies().push_back(make_dynamic(0, {0, 5}, {1, 0}));
+    world.update(0.1f);
+
+    EXPECT_EQ(world.state_hash(), 0u);
+}
+
+TEST(Lockstep, IdenticalPeersAgreeEveryStep) {
+    PhysicsWorld a(1.0f / 60.0f);
+    PhysicsWorld b(1.0f / 60.0f);
+    Flock fa;
+    Flock fb;
+    make_lockstep_scene(a, fa);
+    make_lockstep_scene(b, fb);
+
+    for (int i = 0; i < 60; ++i) {
+        a.fixed_step(1.0f / 60.0f);
+        b.fixed_step(1.0f / 60.0f);
+        ASSERT_EQ(a.state_hash(), b.state_hash()) << "step " << i;
+    }
+    EXPECT_NE(a.state_hash(), 0u);
+}
+
+TEST(Lockstep, DivergenceIsNeverForgotten) {
+    PhysicsWorld a(1.0f / 60.0f);
+    PhysicsWorld b(1.0f / 60.0f);
+    Flock fa;
+    Flock fb;
+    make_lockstep_scene(a, fa);
+    make_lockstep_scene(b, fb);
+
+    a.fixed_step(1.0f / 60.0f);
+    Body* nudged = find_body(b, 5);
+    nudged->position.x = std::nextafter(nudged->position.x, 100.0f);
+    b.fixed_step(1.0f / 60.0f);
+    ASSERT_NE(a.state_hash(), b.state_hash());
+
+    // Even if the states met again, the chained hashes would not
+    b.getBodies() = a.getBodies();
+    a.fixed_step(1.0f / 60.0f);
+    b.fixed_step(1.0f / 60.0f);
+    EXPECT_NE(a.state_hash(), b.state_hash());
+}
+
+// Shape parameters and the slot a body points at are state as well
+TEST(Lockstep, HashCoversShapes) {
+    PhysicsWorld base(1.0f / 60.0f);
+    base.add_circle(make_dynamic(0, {0.0f, 5.0f}), 0.5f);
+    base.add_circle(make_dynamic(1, {3.0f, 5.0f}), 0.5f);
+    StateHash hBase;
+    base.hash_state(hBase);
+
+    PhysicsWorld radius = base;
+    radius.shapes().circles[1].radius = 0.6f;
+    StateHash hRadius;
+    radius.hash_state(hRadius);
+    EXPECT_NE(hBase.value(), hRadius.value());
+
+    PhysicsWorld index = base;
+    index.getBodies()[1].shape.index = 0;
+    StateHash hIndex;
+    index.hash_state(hIndex);
+    EXPECT_NE(hBase.value(), hIndex.value());
+}
+
+TEST(Lockstep, ThreadPoolDoesNotChangeHash) {
+    PhysicsWorld serial(1.0f / 60.0f);
+    PhysicsWorld parallel(1.0f / 60.0f);
+    Flock fs;
+    Flock fp;
+    make_lockstep_scene(serial, fs);
+    make_lockstep_scene(parallel, fp);
+
+    // Same colouring on both sides, only the threads differ
+    for (PhysicsWorld* w : {&serial, &parallel}) {
+        w->solver_settings().parallelMinContacts = 1;
+        w->solver_settings().coloringMinContacts = 8;
+        w->solver_settings().batchChunkRows = 16;
+    }
+    ThreadPool pool(3);
+    parallel.attach_thread_pool(&pool);
+
+    for (int i = 0; i < 60; ++i) {
+        serial.fixed_step(1.0f / 60.0f);
+        parallel.fixed_step(1.0f / 60.0f);
+        ASSERT_EQ(serial.state_hash(), parallel.state_hash()) << "step " << i;
+    }
+    EXPECT_FALSE(serial.getManifolds().empty());
+}
+
+TEST(Lockstep, RvoHashTracksAgents) {
+    RVOSolver a(0.1f);
+    RVOSolver b(0.1f);
+    for (RVOSolver* sim : {&a, &b}) {
+        sim->addAgent({0, 0}, {1, 0}, 0.5f, 2.0f);
+        sim->addAgent({3, 0}, {-1, 0}, 0.5f, 2.0f);
+        sim->setPreferredVelocity(0, {1, 0});
+        sim->setPreferredVelocity(1, {-1, 0});
+    }
+    b.setPreferredVelocity(1, {-1.0f, 0.001f});
+
+    a.step();
+    b.step();
+    StateHash ha;
+    StateHash hb;
+    a.hashState(ha);
+    b.hashState(hb);
+
+    EXPECT_NE(ha.value(), hb.value());
+}
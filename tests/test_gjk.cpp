@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "gjk.h"
+#include "test_helpers.h"
+
+static Body make_box_body(BodyID id, glm::vec2 pos, float hw, float hh) {
+    Body b = make_dynamic(id, pos);
+    b.halfWidth = hw;
+    b.halfHeight = hh;
+    return b;
+}
+
+// ============================================================
+// GJK distance
+// ============================================================
+
+TEST(Gjk, DistanceBetweenSeparatedBoxes) {
+    ShapeStore shapes;
+    const GjkProxy a = make_proxy(make_box_body(0, {3.0f, 0.2f}, 0.5f, 0.5f), shapes);
+    const GjkProxy b = make_proxy(make_box_body(1, {0.0f, 0.0f}, 0.5f, 0.5f), shapes);
+
+    SimplexCache cache;
+    const GjkOutput out = gjk_distance(a, b, cache);
+
+    EXPECT_FALSE(out.overlap);
+    EXPECT_NEAR(out.distance, 2.0f, 1e-5f);
+    EXPECT_NEAR(out.pointA.x, 2.5f, 1e-5f);
+    EXPECT_NEAR(out.pointB.x, 0.5f, 1e-5f);
+}
+
+TEST(Gjk, CircleCoreIsItsCentre) {
+    ShapeStore shapes;
+    shapes.circles.push_back({0.25f});
+    Body ball = make_dynamic(0, {0.0f, 2.0f});
+    ball.shape.type = Type::circle;
+
+    const GjkProxy a = make_proxy(ball, shapes);
+    const GjkProxy b = make_proxy(make_box_body(1, {0.0f, 0.0f}, 1.0f, 0.5f), shapes);
+
+    SimplexCache cache;
+    const GjkOutput out = gjk_distance(a, b, cache);
+
+    EXPECT_FLOAT_EQ(a.radius, 0.25f);
+    EXPECT_NEAR(out.distance, 1.5f, 1e-5f);
+}
+
+TEST(Gjk, CachedSimplexConvergesWithoutNewVertices) {
+    ShapeStore shapes;
+    const GjkProxy a = make_proxy(make_box_body(0, {0.3f, 1.01f}, 0.5f, 0.5f), shapes);
+    const GjkProxy b = make_proxy(make_box_body(1, {0.0f, 0.0f}, 0.5f, 0.5f), shapes);
+
+    SimplexCache cache;
+    const GjkOutput cold = gjk_distance(a, b, cache);
+    const GjkOutput warm = gjk_distance(a, b, cache);
+
+    EXPECT_GT(cold.iterations, warm.iterations);
+    EXPECT_LE(warm.iterations, 1);
+    EXPECT_NEAR(warm.distance, cold.distance, 1e-6f);
+}
+
+// ============================================================
+// EPA penetration
+// ============================================================
+
+TEST(Epa, DepthAndNormalOfOverlappingBoxes) {
+    ShapeStore shapes;
+    const GjkProxy a = make_proxy(make_box_body(0, {0.8f, 0.1f}, 0.5f, 0.5f), shapes);
+    const GjkProxy b = make_proxy(make_box_body(1, {0.0f, 0.0f}, 0.5f, 0.5f), shapes);
+
+    SimplexCache cache;
+    const GjkOutput gjk = gjk_distance(a, b, cache);
+    ASSERT_TRUE(gjk.overlap);
+
+    EpaOutput epa;
+    ASSERT_TRUE(epa_penetration(a, b, gjk, epa));
+    EXPECT_NEAR(epa.normal.x, 1.0f, 1e-4f);
+    EXPECT_NEAR(epa.normal.y, 0.0f, 1e-4f);
+    EXPECT_NEAR(epa.depth, 0.2f, 1e-4f);
+    EXPECT_NEAR(epa.pointB.x, 0.5f, 1e-4f);
+}
+
+// ============================================================
+// SimplexCacheTable
+// ============================================================
+
+TEST(SimplexCacheTable, DropsPairsNotUsedInAStep) {
+    SimplexCacheTable table;
+    table.get(1, 2).count = 2;
+    table.get(3, 4).count = 1;
+    table.end_step();
+    EXPECT_EQ(table.size(), 2u);
+
+    EXPECT_EQ(table.get(1, 2).count, 2);
+    table.end_step();
+    EXPECT_EQ(table.size(), 1u);
+}
@@ -41,6 +41,31 @@ inline Body make_kinematic(BodyID id, glm::vec2 pos, glm::vec2 vel = {0, 0}) {
     return b;
 }
 
+// Static floor with its top face at y = 0 over x in [-14, 14], tiled from
+// 2x2 boxes with ids from 1000 on. Shapes larger than a broadphase cell
+// do not collide, so a single wide floor would let everything sink
+// (assets/scenes/demo.scene tiles its ground the same way). Then
+// columns x rows dynamic 1x1 boxes under gravity, ids 1, 2, ... row by
+// row from origin.
+inline void make_box_scene(PhysicsWorld& world, int columns, int rows,
+                           glm::vec2 origin, glm::vec2 spacing = {0.95f, 0.95f}) {
+    for (int i = 0; i < 14; ++i) {
+        Body tile = make_static(static_cast<BodyID>(1000 + i), {-13.0f + 2.0f * float(i), -1.0f});
+        tile.halfWidth = 1.0f;
+        tile.halfHeight = 1.0f;
+        world.getBodies().push_back(tile);
+    }
+    for (int y = 0; y < rows; ++y)
+        for (int x = 0; x < columns; ++x) {
+            Body b = make_dynamic(static_cast<BodyID>(1 + y * columns + x),
+                                  origin + glm::vec2{spacing.x * float(x), spacing.y * float(y)},
+                                  {0.0f, 0.0f}, {0.0f, -9.8f});
+            b.halfWidth = 0.5f;
+            b.halfHeight = 0.5f;
+            world.getBodies().push_back(b);
+        }
+}
+
 inline Body* find_body(PhysicsWorld& world, BodyID id) {
     for (auto& b : world.getBodies()) {
         if (b.id == id) return &b;
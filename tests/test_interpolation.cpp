@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "interpolation.h"
+#include "boid_flock.h"
+#include "rvo_solver.h"
+#include "test_helpers.h"
+
+// ============================================================
+// Batch interpolation
+// ============================================================
+
+TEST(Interpolation, BatchMatchesScalar) {
+    std::vector<glm::vec2> prev{{0, 0}, {1, 2}, {-4, 8}};
+    std::vector<glm::vec2> curr{{2, 2}, {3, -2}, {-4, 0}};
+    std::vector<glm::vec2> out(3);
+
+    interpolate(prev, curr, 0.25f, out);
+
+    for (size_t i = 0; i < out.size(); ++i) {
+        const glm::vec2 expected = interpolate(prev[i], curr[i], 0.25f);
+        EXPECT_FLOAT_EQ(out[i].x, expected.x);
+        EXPECT_FLOAT_EQ(out[i].y, expected.y);
+    }
+}
+
+TEST(Interpolation, EntriesWithoutPreviousTakeCurrent) {
+    std::vector<glm::vec2> prev{{0, 0}};
+    std::vector<glm::vec2> curr{{2, 0}, {5, 5}};
+
+    // In place, as the callers use it
+    interpolate(prev, curr, 0.5f, curr);
+
+    EXPECT_FLOAT_EQ(curr[0].x, 1.0f);
+    EXPECT_FLOAT_EQ(curr[1].x, 5.0f);
+    EXPECT_FLOAT_EQ(curr[1].y, 5.0f);
+}
+
+// ============================================================
+// Previous state buffers
+// ============================================================
+
+TEST(Interpolation, WorldAlphaFollowsAccumulator) {
+    float fixed_dt = 1.0f / 30.0f;
+    PhysicsWorld world(fixed_dt);
+
+    world.update(fixed_dt * 1.5f);
+
+    EXPECT_EQ(world.step_count(), 1u);
+    EXPECT_NEAR(world.alpha(), 0.5f, 1e-4f);
+}
+
+TEST(Interpolation, WorldBlendsPreviousAndCurrentPositions) {
+    float fixed_dt = 1.0f / 30.0f;
+    PhysicsWorld world(fixed_dt);
+    world.getBodies().push_back(make_dynamic(0, {0, 5}, {3, 0}));
+
+    world.update(fixed_dt);
+    const glm::vec2 before = world.previous_positions()[0];
+    const glm::vec2 after = world.getBodies()[0].position;
+
+    std::vector<glm::vec2> drawn;
+    world.interpolated_positions(0.5f, drawn);
+
+    ASSERT_EQ(drawn.size(), 1u);
+    EXPECT_FLOAT_EQ(before.x, 0.0f);
+    EXPECT_GT(after.x, before.x);
+    EXPECT_NEAR(drawn[0].x, 0.5f * (before.x + after.x), 1e-6f);
+}
+
+TEST(Interpolation, WrappedBoidIsNotDrawnAcrossTheWorld) {
+    Flock flock;
+    Boid boid{};
+    boid.body = make_dynamic(0, {Flock::WORLD_HALF_W - 0.01f, 0}, {5, 0});
+    boid.perception = 1.0f;
+    boid.max_speed = 10.0f;
+    boid.max_force = 1.0f;
+    flock.add_boid(boid);
+
+    flock.step(0.1f);
+    std::vector<glm::vec2> drawn;
+    flock.interpolated_positions(0.5f, drawn);
+
+    ASSERT_EQ(drawn.size(), 1u);
+    EXPECT_FLOAT_EQ(drawn[0].x, -Flock::WORLD_HALF_W);
+}
+
+TEST(Interpolation, RvoKeepsPreviousAgentPositions) {
+    RVOSolver sim(0.1f);
+    sim.addAgent({0, 0}, {1, 0}, 0.5f, 2.0f);
+    sim.setPreferredVelocity(0, {1, 0});
+
+    sim.step();
+    std::vector<glm::vec2> drawn;
+    sim.interpolatedPositions(0.0f, drawn);
+
+    ASSERT_EQ(sim.getPreviousPositions().size(), 1u);
+    EXPECT_FLOAT_EQ(drawn[0].x, 0.0f);
+    EXPECT_GT(sim.getAgents()[0].body.position.x, 0.0f);
+}
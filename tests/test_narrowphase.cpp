@@ -0,0 +1,370 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "narrowphase.h"
+#include "physics_world.h"
+#include "test_helpers.h"
+
+static Body make_box(Body b, float halfWidth, float halfHeight) {
+    b.halfWidth = halfWidth;
+    b.halfHeight = halfHeight;
+    return b;
+}
+
+// ============================================================
+// Box-box SAT (collide_boxes)
+// ============================================================
+
+TEST(BoxNarrowphase, StackedBoxesGiveTwoPointsOnTopFace) {
+    Body top = make_box(make_dynamic(0, {0.2f, 0.95f}), 0.5f, 0.5f);
+    Body bottom = make_box(make_static(1, {0.0f, 0.0f}), 0.5f, 0.5f);
+
+    ContactManifold m;
+    ASSERT_TRUE(collide_boxes(top, bottom, PhysicsWorld::slop, m));
+
+    EXPECT_EQ(m.bodyA, 0u);
+    EXPECT_EQ(m.bodyB, 1u);
+    ASSERT_EQ(m.pointCount, 2);
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_FLOAT_EQ(m.points[i].normal.x, 0.0f);
+        EXPECT_FLOAT_EQ(m.points[i].normal.y, 1.0f);
+        EXPECT_NEAR(m.points[i].penetration, 0.05f, 1e-5f);
+        EXPECT_FLOAT_EQ(m.points[i].position.y, 0.5f);
+    }
+    // Overlap of the faces is [-0.3, 0.5]
+    EXPECT_NEAR(m.points[0].position.x, -0.3f, 1e-5f);
+    EXPECT_NEAR(m.points[1].position.x, 0.5f, 1e-5f);
+    EXPECT_NE(m.points[0].feature, m.points[1].feature);
+}
+
+TEST(BoxNarrowphase, SideOverlapGivesHorizontalNormal) {
+    Body left = make_box(make_dynamic(0, {-0.9f, 0.1f}), 0.5f, 0.5f);
+    Body right = make_box(make_dynamic(1, {0.0f, 0.0f}), 0.5f, 0.5f);
+
+    ContactManifold m;
+    ASSERT_TRUE(collide_boxes(left, right, PhysicsWorld::slop, m));
+
+    ASSERT_EQ(m.pointCount, 2);
+    EXPECT_FLOAT_EQ(m.points[0].normal.x, -1.0f);
+    EXPECT_FLOAT_EQ(m.points[0].normal.y, 0.0f);
+    EXPECT_NEAR(m.points[0].penetration, 0.1f, 1e-5f);
+    EXPECT_FLOAT_EQ(m.points[0].position.x, -0.5f);
+}
+
+TEST(BoxNarrowphase, SeparatedBoxesDoNotCollide) {
+    Body a = make_box(make_dynamic(0, {0.0f, 1.2f}), 0.5f, 0.5f);
+    Body b = make_box(make_static(1, {0.0f, 0.0f}), 0.5f, 0.5f);
+
+    ContactManifold m;
+    EXPECT_FALSE(collide_boxes(a, b, PhysicsWorld::slop, m));
+}
+
+TEST(BoxNarrowphase, CornerTouchGivesSinglePoint) {
+    Body a = make_box(make_dynamic(0, {1.0f, 0.999f}), 0.5f, 0.5f);
+    Body b = make_box(make_static(1, {0.0f, 0.0f}), 0.5f, 0.5f);
+
+    ContactManifold m;
+    ASSERT_TRUE(collide_boxes(a, b, PhysicsWorld::slop, m));
+    EXPECT_EQ(m.pointCount, 1);
+}
+
+TEST(BoxNarrowphase, CarryImpulsesMatchesFeatures) {
+    Body top = make_box(make_dynamic(0, {0.2f, 0.95f}), 0.5f, 0.5f);
+    Body bottom = make_box(make_static(1, {0.0f, 0.0f}), 0.5f, 0.5f);
+
+    ContactManifold old;
+    ASSERT_TRUE(collide_boxes(top, bottom, PhysicsWorld::slop, old));
+    old.points[0].Pn = 1.0f;
+    old.points[1].Pn = 2.0f;
+    // Points stored in the other order must still find their impulse
+    std::swap(old.points[0], old.points[1]);
+
+    ContactManifold now;
+    ASSERT_TRUE(collide_boxes(top, bottom, PhysicsWorld::slop, now));
+    carry_impulses(old, now);
+
+    EXPECT_FLOAT_EQ(now.points[0].Pn, 1.0f);
+    EXPECT_FLOAT_EQ(now.points[1].Pn, 2.0f);
+}
+
+// ============================================================
+// Box contacts in PhysicsWorld
+// ============================================================
+
+TEST(BoxNarrowphase, WorldWarmStartsBoxContactsAcrossSteps) {
+    float dt = 1.0f / 60.0f;
+    PhysicsWorld world(dt);
+    world.getBodies().push_back(make_box(make_static(0, {0.0f, 5.0f}), 0.5f, 0.5f));
+    world.getBodies().push_back(make_box(make_static(1, {0.2f, 5.95f}), 0.5f, 0.5f));
+    world.getBodies()[1].type = BodyType::Kinematic;
+
+    std::vector<ContactManifold> manifolds;
+    world.step_bodies_with_ccd(dt, manifolds);
+    ASSERT_EQ(manifolds.size(), 1u);
+    ASSERT_EQ(manifolds[0].pointCount, 2);
+    EXPECT_EQ(manifolds[0].bodyA, 1u);
+    manifolds[0].points[0].Pn = 0.25f;
+    manifolds[0].points[1].Pn = 0.75f;
+
+    world.step_bodies_with_ccd(dt, manifolds);
+    ASSERT_EQ(manifolds.size(), 1u);
+    EXPECT_FLOAT_EQ(manifolds[0].points[0].Pn, 0.25f);
+    EXPECT_FLOAT_EQ(manifolds[0].points[1].Pn, 0.75f);
+}
+
+TEST(BoxNarrowphase, FallingBoxStopsOnStaticBox) {
+    float dt = 1.0f / 60.0f;
+    PhysicsWorld world(dt);
+    world.getBodies().push_back(make_box(make_static(0, {0.0f, 5.0f}), 0.5f, 0.5f));
+    world.getBodies().push_back(make_box(make_dynamic(1, {0.1f, 6.0f}, {0.0f, -1.0f}), 0.5f, 0.5f));
+
+    world.fixed_step(dt);
+
+    const Body* box = find_body(world, 1);
+    ASSERT_NE(box, nullptr);
+    EXPECT_NEAR(box->velocity.y, 0.0f, 1e-4f);
+    ASSERT_EQ(world.getManifolds().size(), 1u);
+    EXPECT_EQ(world.getManifolds()[0].pointCount, 2);
+    EXPECT_FLOAT_EQ(world.getManifolds()[0].points[0].normal.y, 1.0f);
+}
+
+// ============================================================
+// Circles and capsules (shape-pair dispatch)
+// ============================================================
+
+static Body make_circle(Body b, ShapeStore& shapes, float radius) {
+    b.shape.type = Type::circle;
+    b.shape.index = static_cast<uint32_t>(shapes.circles.size());
+    shapes.circles.push_back({radius});
+    return b;
+}
+
+static Body make_capsule(Body b, ShapeStore& shapes, glm::vec2 halfSegment, float radius) {
+    b.shape.type = Type::capsule;
+    b.shape.index = static_cast<uint32_t>(shapes.capsules.size());
+    shapes.capsules.push_back({halfSegment, radius});
+    return b;
+}
+
+TEST(ShapeDispatch, OverlappingCirclesGiveOnePoint) {
+    ShapeStore shapes;
+    Body a = make_circle(make_dynamic(0, {0.0f, 0.0f}), shapes, 0.5f);
+    Body b = make_circle(make_dynamic(1, {0.8f, 0.0f}), shapes, 0.5f);
+
+    ContactManifold m;
+    ASSERT_TRUE(collide(a, b, shapes, PhysicsWorld::slop, m));
+    ASSERT_EQ(m.pointCount, 1);
+    EXPECT_FLOAT_EQ(m.points[0].normal.x, -1.0f);
+    EXPECT_NEAR(m.points[0].penetration, 0.2f, 1e-5f);
+    EXPECT_NEAR(m.points[0].position.x, 0.3f, 1e-5f);
+}
+
+TEST(ShapeDispatch, CircleRestingOnBoxCorner) {
+    ShapeStore shapes;
+    Body ball = make_circle(make_dynamic(0, {0.8f, 0.8f}), shapes, 0.5f);
+    Body box = make_box(make_static(1, {0.0f, 0.0f}), 0.5f, 0.5f);
+
+    ContactManifold m;
+    ASSERT_TRUE(collide(ball, box, shapes, PhysicsWorld::slop, m));
+    ASSERT_EQ(m.pointCount, 1);
+    // Normal leaves the corner towards the centre of the ball
+    const float s = 1.0f / std::sqrt(2.0f);
+    EXPECT_NEAR(m.points[0].normal.x, s, 1e-5f);
+    EXPECT_NEAR(m.points[0].normal.y, s, 1e-5f);
+    EXPECT_NEAR(m.points[0].penetration, 0.5f - 0.3f * std::sqrt(2.0f), 1e-5f);
+}
+
+TEST(ShapeDispatch, MirroredPairFlipsNormal) {
+    ShapeStore shapes;
+    Body ball = make_circle(make_dynamic(0, {0.0f, 0.9f}), shapes, 0.5f);
+    Body box = make_box(make_dynamic(1, {0.0f, 0.0f}), 0.5f, 0.5f);
+
+    ContactManifold ballFirst;
+    ContactManifold boxFirst;
+    ASSERT_TRUE(collide(ball, box, shapes, PhysicsWorld::slop, ballFirst));
+    ASSERT_TRUE(collide(box, ball, shapes, PhysicsWorld::slop, boxFirst));
+
+    EXPECT_EQ(boxFirst.bodyA, 1u);
+    EXPECT_EQ(boxFirst.bodyB, 0u);
+    EXPECT_FLOAT_EQ(ballFirst.points[0].normal.y, 1.0f);
+    EXPECT_FLOAT_EQ(boxFirst.points[0].normal.y, -1.0f);
+    EXPECT_FLOAT_EQ(ballFirst.points[0].penetration, boxFirst.points[0].penetration);
+}
+
+TEST(ShapeDispatch, LyingCapsuleGetsTwoPointsOnBox) {
+    ShapeStore shapes;
+    Body cap = make_capsule(make_dynamic(0, {0.0f, 0.7f}), shapes, {0.4f, 0.0f}, 0.25f);
+    Body box = make_box(make_static(1, {0.0f, 0.0f}), 1.0f, 0.5f);
+
+    ContactManifold m;
+    ASSERT_TRUE(collide(cap, box, shapes, PhysicsWorld::slop, m));
+    ASSERT_EQ(m.pointCount, 2);
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_FLOAT_EQ(m.points[i].normal.y, 1.0f);
+        EXPECT_NEAR(m.points[i].penetration, 0.05f, 1e-5f);
+    }
+    EXPECT_NE(m.points[0].feature, m.points[1].feature);
+}
+
+TEST(ShapeDispatch, CrossingCapsulesTouchAtClosestPoints) {
+    ShapeStore shapes;
+    Body a = make_capsule(make_dynamic(0, {0.0f, 0.3f}), shapes, {1.0f, 0.0f}, 0.2f);
+    Body b = make_capsule(make_dynamic(1, {0.5f, -0.5f}), shapes, {0.0f, 0.6f}, 0.2f);
+
+    ContactManifold m;
+    ASSERT_TRUE(collide(a, b, shapes, PhysicsWorld::slop, m));
+    ASSERT_EQ(m.pointCount, 1);
+    // b's upper end (0.5, 0.1) is closest to a's segment at (0.5, 0.3)
+    EXPECT_NEAR(m.points[0].normal.y, 1.0f, 1e-5f);
+    EXPECT_NEAR(m.points[0].penetration, 0.2f, 1e-5f);
+}
+
+TEST(ShapeDispatch, PlanesAreNotCollided) {
+    ShapeStore shapes;
+    Body ball = make_circle(make_dynamic(0, {0.0f, 0.0f}), shapes, 0.5f);
+    Body plane = make_static(1, {0.0f, 0.0f}, Type::plane);
+
+    ContactManifold m;
+    EXPECT_FALSE(collide(ball, plane, shapes, PhysicsWorld::slop, m));
+}
+
+TEST(ShapeDispatch, WorldStopsBallOnBox) {
+    float dt = 1.0f / 60.0f;
+    PhysicsWorld world(dt);
+    world.getBodies().push_back(make_box(make_static(0, {0.0f, 5.0f}), 0.5f, 0.5f));
+    world.add_circle(make_dynamic(1, {0.0f, 5.98f}, {0.0f, -2.0f}), 0.5f);
+    world.add_circle(make_dynamic(2, {5.0f, 5.0f}), 0.25f);
+
+    world.fixed_step(dt);
+
+    ASSERT_EQ(world.shapes().circles.size(), 2u);
+    const Body* ball = find_body(world, 1);
+    ASSERT_NE(ball, nullptr);
+    EXPECT_EQ(ball->shape.type, Type::circle);
+    EXPECT_FLOAT_EQ(ball->halfWidth, 0.5f);
+    EXPECT_NEAR(ball->velocity.y, 0.0f, 1e-4f);
+    ASSERT_EQ(world.getManifolds().size(), 1u);
+    EXPECT_EQ(world.getManifolds()[0].bodyA, 1u);
+}
+
+TEST(ShapeDispatch, WorldRejectsShapesLargerThanACell) {
+    PhysicsWorld world(1.0f / 60.0f);
+    EXPECT_FALSE(world.add_circle(make_dynamic(0, {0.0f, 0.0f}), 1.5f));
+    EXPECT_FALSE(world.add_circle(make_dynamic(0, {0.0f, 0.0f}), 0.0f));
+    EXPECT_FALSE(world.add_capsule(make_dynamic(0, {0.0f, 0.0f}), {1.0f, 0.0f}, 0.25f));
+    EXPECT_TRUE(world.getBodies().empty());
+    EXPECT_TRUE(world.shapes().circles.empty());
+    EXPECT_TRUE(world.shapes().capsules.empty());
+
+    EXPECT_TRUE(world.add_circle(make_dynamic(0, {0.0f, 0.0f}), 1.0f));
+    EXPECT_TRUE(world.add_capsule(make_dynamic(1, {3.0f, 0.0f}), {0.75f, 0.0f}, 0.25f));
+}
+
+// ============================================================
+// Convex polygons (GJK / EPA)
+// ============================================================
+
+static Body make_polygon(Body b, ShapeStore& shapes, std::initializer_list<glm::vec2> verts) {
+    PolygonShape poly{};
+    poly.count = static_cast<uint32_t>(verts.size());
+    uint32_t i = 0;
+    for (const glm::vec2& v : verts)
+        poly.vertices[i++] = v;
+    for (i = 0; i < poly.count; ++i) {
+        const glm::vec2 e = poly.vertices[(i + 1) % poly.count] - poly.vertices[i];
+        const float len = std::sqrt(e.x * e.x + e.y * e.y);
+        poly.normals[i] = glm::vec2{e.y / len, -e.x / len};
+    }
+    b.shape.type = Type::polygon;
+    b.shape.index = static_cast<uint32_t>(shapes.polygons.size());
+    shapes.polygons.push_back(poly);
+    return b;
+}
+
+TEST(PolygonNarrowphase, BoxOnRampGetsTwoPointsAlongSlope) {
+    ShapeStore shapes;
+    // 45 degree ramp, slope face from (-1,-1) to (1,1)
+    Body ramp = make_polygon(make_static(0, {0.0f, 0.0f}), shapes,
+                             {{-1.0f, -1.0f}, {1.0f, -1.0f}, {1.0f, 1.0f}});
+    // Square turned to lie flat on the slope, sunk in by 0.01
+    const float s = 0.5f * std::sqrt(2.0f);
+    const float lift = 0.5f - 0.01f;
+    const glm::vec2 n{-s, s};   // slope normal (-1, 1) / sqrt(2)
+    Body box = make_polygon(make_dynamic(1, n * lift), shapes,
+                            {{0.0f, -s}, {s, 0.0f}, {0.0f, s}, {-s, 0.0f}});
+
+    ContactManifold m;
+    ASSERT_TRUE(collide(box, ramp, shapes, PhysicsWorld::slop, m));
+    ASSERT_EQ(m.pointCount, 2);
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_NEAR(m.points[i].normal.x, n.x, 1e-4f);
+        EXPECT_NEAR(m.points[i].normal.y, n.y, 1e-4f);
+        EXPECT_NEAR(m.points[i].penetration, 0.01f, 1e-4f);
+    }
+    EXPECT_NE(m.points[0].feature, m.points[1].feature);
+}
+
+TEST(PolygonNarrowphase, CircleAgainstTriangleGivesOnePoint) {
+    ShapeStore shapes;
+    Body tri = make_polygon(make_static(0, {0.0f, 0.0f}), shapes,
+                            {{-1.0f, 0.0f}, {1.0f, 0.0f}, {0.0f, 1.0f}});
+    Body ball = make_circle(make_dynamic(1, {0.0f, -0.4f}), shapes, 0.5f);
+
+    ContactManifold m;
+    ASSERT_TRUE(collide(ball, tri, shapes, PhysicsWorld::slop, m));
+    ASSERT_EQ(m.pointCount, 1);
+    EXPECT_NEAR(m.points[0].normal.y, -1.0f, 1e-4f);
+    EXPECT_NEAR(m.points[0].penetration, 0.1f, 1e-4f);
+}
+
+TEST(PolygonNarrowphase, DeepOverlapUsesEpa) {
+    ShapeStore shapes;
+    Body a = make_polygon(make_dynamic(0, {0.0f, 0.7f}), shapes,
+                          {{-0.5f, -0.5f}, {0.5f, -0.5f}, {0.5f, 0.5f}, {-0.5f, 0.5f}});
+    Body b = make_box(make_static(1, {0.1f, 0.0f}), 0.5f, 0.5f);
+
+    ContactManifold m;
+    ASSERT_TRUE(collide(a, b, shapes, PhysicsWorld::slop, m));
+    ASSERT_EQ(m.pointCount, 2);
+    EXPECT_NEAR(m.points[0].normal.y, 1.0f, 1e-4f);
+    EXPECT_NEAR(m.points[0].penetration, 0.3f, 1e-4f);
+}
+
+TEST(PolygonNarrowphase, WorldRejectsBadPolygons) {
+    PhysicsWorld world(1.0f / 60.0f);
+    const glm::vec2 two[] = {{0.0f, 0.0f}, {1.0f, 0.0f}};
+    const glm::vec2 nine[9] = {};
+    EXPECT_FALSE(world.add_polygon(make_static(0, {0.0f, 0.0f}), two));
+    EXPECT_FALSE(world.add_polygon(make_static(0, {0.0f, 0.0f}), nine));
+    const glm::vec2 wide[] = {{-1.5f, 0.0f}, {1.5f, 0.0f}, {0.0f, 0.5f}};
+    EXPECT_FALSE(world.add_polygon(make_static(0, {0.0f, 0.0f}), wide));
+    EXPECT_TRUE(world.getBodies().empty());
+
+    // Clockwise input is stored counter clockwise
+    const glm::vec2 cw[] = {{0.0f, 1.0f}, {1.0f, 0.0f}, {-1.0f, 0.0f}};
+    ASSERT_TRUE(world.add_polygon(make_static(0, {0.0f, 0.0f}), cw));
+    const PolygonShape& poly = world.shapes().polygons[0];
+    EXPECT_FLOAT_EQ(poly.vertices[0].x, -1.0f);
+    EXPECT_FLOAT_EQ(poly.normals[0].y, -1.0f);
+    EXPECT_FLOAT_EQ(world.getBodies()[0].halfWidth, 1.0f);
+}
+
+TEST(PolygonNarrowphase, WorldStopsBoxSlidingIntoRamp) {
+    float dt = 1.0f / 60.0f;
+    PhysicsWorld world(dt);
+    const glm::vec2 ramp[] = {{-1.0f, -1.0f}, {1.0f, -1.0f}, {1.0f, 1.0f}};
+    ASSERT_TRUE(world.add_polygon(make_static(0, {0.0f, 5.0f}), ramp));
+    const float s = 0.5f * std::sqrt(2.0f);
+    const glm::vec2 diamond[] = {{0.0f, -s}, {s, 0.0f}, {0.0f, s}, {-s, 0.0f}};
+    const glm::vec2 n{-s, s};   // slope normal (-1, 1) / sqrt(2)
+    ASSERT_TRUE(world.add_polygon(make_dynamic(1, glm::vec2{0.0f, 5.0f} + n * 0.5f, n * -1.0f), diamond));
+
+    world.fixed_step(dt);
+    world.fixed_step(dt);
+
+    const Body* box = find_body(world, 1);
+    ASSERT_NE(box, nullptr);
+    // No speed left into the slope
+    EXPECT_GT(box->velocity.x * n.x + box->velocity.y * n.y, -1e-3f);
+    ASSERT_EQ(world.getManifolds().size(), 1u);
+    EXPECT_EQ(world.getManifolds()[0].pointCount, 2);
+}
@@ -372,3 +372,89 @@ TEST(Accessors, ReturnsFirstBodyState) {
     EXPECT_FLOAT_EQ(world.velocity().x, 1.0f);
     EXPECT_FLOAT_EQ(world.velocity().y, 2.0f);
 }
+
+// ============================================================
+// step_n
+// ============================================================
+
+// Overlapping boxes falling onto a floor, so every step has contacts
+static void make_box_pile(PhysicsWorld& world) {
+    Body floor = make_static(0, {0.0f, -1.0f});
+    floor.halfWidth = 10.0f;
+    floor.halfHeight = 1.0f;
+    world.getBodies().push_back(floor);
+    for (int y = 0; y < 4; ++y)
+        for (int x = 0; x < 6; ++x) {
+            Body b = make_dynamic(static_cast<BodyID>(1 + y * 6 + x),
+                                  {-3.0f + 0.95f * float(x), 0.5f + 0.95f * float(y)},
+                                  {0.0f, 0.0f}, {0.0f, -9.8f});
+            b.halfWidth = 0.5f;
+            b.halfHeight = 0.5f;
+            world.getBodies().push_back(b);
+        }
+}
+
+TEST(StepN, MatchesFixedStepLoop) {
+    const float dt = 1.0f / 60.0f;
+    PhysicsWorld looped(dt);
+    PhysicsWorld batched(dt);
+    make_box_pile(looped);
+    make_box_pile(batched);
+
+    for (int i = 0; i < 90; ++i)
+        looped.fixed_step(dt);
+    batched.step_n(90);
+
+    const auto& a = looped.getBodies();
+    const auto& b = batched.getBodies();
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(a[i].position.x, b[i].position.x);
+        EXPECT_EQ(a[i].position.y, b[i].position.y);
+        EXPECT_EQ(a[i].velocity.x, b[i].velocity.x);
+        EXPECT_EQ(a[i].velocity.y, b[i].velocity.y);
+    }
+    EXPECT_EQ(looped.getManifolds().size(), batched.getManifolds().size());
+    EXPECT_FLOAT_EQ(looped.solver_stats().maxPenetration,
+                    batched.solver_stats().maxPenetration);
+}
+
+TEST(StepN, CountsStepsAndKeepsAccumulator) {
+    PhysicsWorld world(1.0f / 60.0f);
+    world.update(0.01f);
+
+    world.step_n(600);
+
+    EXPECT_EQ(world.step_count(), 600u);
+    EXPECT_FLOAT_EQ(world.accumulator(), 0.01f);
+}
+
+TEST(StepN, PreviousPositionsAreFromLastStep) {
+    const float dt = 1.0f / 60.0f;
+    PhysicsWorld world(dt);
+    PhysicsWorld reference(dt);
+    world.getBodies().push_back(make_dynamic(0, {0.0f, 5.0f}, {6.0f, 0.0f}));
+    reference.getBodies().push_back(make_dynamic(0, {0.0f, 5.0f}, {6.0f, 0.0f}));
+
+    world.step_n(10);
+    reference.step_n(9);
+
+    EXPECT_EQ(world.previous_positions()[0].x, reference.getBodies()[0].position.x);
+    EXPECT_GT(world.getBodies()[0].position.x, world.previous_positions()[0].x);
+}
+
+TEST(StepN, LockstepHashMatchesFixedStepLoop) {
+    const float dt = 1.0f / 60.0f;
+    PhysicsWorld looped(dt);
+    PhysicsWorld batched(dt);
+    make_box_pile(looped);
+    make_box_pile(batched);
+    looped.set_deterministic(true);
+    batched.set_deterministic(true);
+
+    for (int i = 0; i < 30; ++i)
+        looped.fixed_step(dt);
+    batched.step_n(30);
+
+    EXPECT_EQ(looped.state_hash(), batched.state_hash());
+}
@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "replay.h"
+#include "test_helpers.h"
+
+static std::string temp_path(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// Boxes falling onto a floor: they move for a while, then come to rest,
+// the floor never moves
+static void make_replay_scene(PhysicsWorld& world) {
+    make_box_scene(world, 10, 1, {-5.0f, 1.0f}, {1.1f, 0.0f});
+}
+
+// ============================================================
+// Recording and playback
+// ============================================================
+
+TEST(Replay, PlaybackMatchesRecordedPositions) {
+    const std::string path = temp_path("engine_replay_playback.rep");
+    const float dt = 1.0f / 60.0f;
+    PhysicsWorld world(dt);
+    make_replay_scene(world);
+
+    ReplaySettings settings;
+    settings.keyframeInterval = 50;
+    ReplayRecorder recorder;
+    ASSERT_TRUE(recorder.open(path, dt, settings));
+    world.add_step_listener(&recorder);
+
+    std::vector<std::vector<Body>> reference;
+    for (int i = 0; i < 200; ++i) {
+        world.fixed_step(dt);
+        reference.push_back(world.getBodies());
+    }
+    recorder.close();
+    EXPECT_EQ(recorder.frames(), 200u);
+    EXPECT_EQ(recorder.keyframes(), 4u);
+    EXPECT_EQ(recorder.dropped_frames(), 0u);
+
+    ReplayPlayer player;
+    ASSERT_TRUE(player.open(path));
+    EXPECT_EQ(player.fixed_dt(), dt);
+    EXPECT_EQ(player.frame_count(), 200u);
+    EXPECT_EQ(player.keyframe_count(), 4u);
+    EXPECT_EQ(player.first_step(), 1u);
+    EXPECT_EQ(player.last_step(), 200u);
+
+    const float tolerance = settings.quantum * 0.5f + 1e-6f;
+    for (size_t s = 0; s < reference.size(); ++s) {
+        ASSERT_TRUE(player.next());
+        ASSERT_EQ(player.step(), s + 1);
+        ASSERT_EQ(player.positions().size(), reference[s].size());
+        for (size_t i = 0; i < reference[s].size(); ++i) {
+            EXPECT_EQ(player.ids()[i], reference[s][i].id);
+            EXPECT_NEAR(player.positions()[i].x, reference[s][i].position.x, tolerance);
+            EXPECT_NEAR(player.positions()[i].y, reference[s][i].position.y, tolerance);
+        }
+    }
+    EXPECT_FALSE(player.next());
+    std::filesystem::remove(path);
+}
+
+TEST(Replay, SeekLandsOnTheRequestedStep) {
+    const std::string path = temp_path("engine_replay_seek.rep");
+    const float dt = 1.0f / 60.0f;
+    PhysicsWorld world(dt);
+    make_replay_scene(world);
+
+    ReplaySettings settings;
+    settings.keyframeInterval = 30;
+    ReplayRecorder recorder;
+    ASSERT_TRUE(recorder.open(path, dt, settings));
+
+    std::vector<std::vector<Body>> reference;
+    for (int i = 0; i < 120; ++i) {
+        world.fixed_step(dt);
+        recorder.record(world.step_count(), world.getBodies());
+        reference.push_back(world.getBodies());
+    }
+    recorder.close();
+
+    ReplayPlayer player;
+    ASSERT_TRUE(player.open(path));
+    EXPECT_FALSE(player.seek(0));
+    for (const std::uint64_t step: {97u, 31u, 120u, 1u, 60u}) {
+        ASSERT_TRUE(player.seek(step));
+        EXPECT_EQ(player.step(), step);
+        for (size_t i = 0; i < player.positions().size(); ++i)
+            EXPECT_NEAR(player.positions()[i].y, reference[step - 1][i].position.y, settings.quantum);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(Replay, DeltasOnlyCarryMovingBodies) {
+    const std::string path = temp_path("engine_replay_delta.rep");
+    const float dt = 1.0f / 60.0f;
+    PhysicsWorld world(dt);
+    for (int i = 0; i < 1000; ++i)
+        world.getBodies().push_back(make_static(static_cast<BodyID>(i), {float(i), 0.0f}));
+    world.getBodies().push_back(make_dynamic(1000, {0.0f, 50.0f}, {1.0f, 0.0f}));
+
+    ReplayRecorder recorder;
+    ASSERT_TRUE(recorder.open(path, dt));
+    world.add_step_listener(&recorder);
+    world.step_n(100, true);
+    recorder.close();
+
+    // One keyframe of 1001 bodies, then 99 frames with one body each
+    EXPECT_EQ(recorder.keyframes(), 1u);
+    const auto size = std::filesystem::file_size(path);
+    EXPECT_LT(size, 1001u * 12u + 99u * 24u);
+    EXPECT_EQ(recorder.bytes_written(), size);
+    std::filesystem::remove(path);
+}
+
+TEST(Replay, BodyCountChangeWritesKeyframe) {
+    const std::string path = temp_path("engine_replay_spawn.rep");
+    ReplayRecorder recorder;
+    ASSERT_TRUE(recorder.open(path, 1.0f / 60.0f));
+
+    std::vector<Body> bodies = {make_dynamic(3, {1, 1})};
+    recorder.record(1, bodies);
+    recorder.record(2, bodies);
+    bodies.push_back(make_dynamic(9, {2, 2}));
+    recorder.record(3, bodies);
+    // Same step again (rollback correction)
+    bodies[0].position.x = 5.0f;
+    recorder.record(3, bodies);
+    recorder.close();
+    EXPECT_EQ(recorder.keyframes(), 3u);
+
+    ReplayPlayer player;
+    ASSERT_TRUE(player.open(path));
+    ASSERT_TRUE(player.seek(3));
+    ASSERT_EQ(player.ids().size(), 2u);
+    EXPECT_EQ(player.ids()[1], 9u);
+    EXPECT_FLOAT_EQ(player.positions()[0].x, 5.0f);
+    std::filesystem::remove(path);
+}
+
+// A keyframe of 100 bodies never fits into 64 bytes: the queue grows
+// instead of the frame being dropped on every step or the step waiting.
+TEST(Replay, FrameLargerThanTheQueueGrowsIt) {
+    const std::string path = temp_path("engine_replay_grow.rep");
+    ReplaySettings settings;
+    settings.ringBytes = 64;
+    ReplayRecorder recorder;
+    ASSERT_TRUE(recorder.open(path, 1.0f / 60.0f, settings));
+
+    std::vector<Body> bodies;
+    for (int i = 0; i < 100; ++i)
+        bodies.push_back(make_dynamic(static_cast<BodyID>(i), {float(i), 0.0f}));
+    recorder.record(1, bodies);
+    EXPECT_GT(recorder.queue_bytes(), 64u);
+    bodies[99].position.x = 200.0f;
+    recorder.record(2, bodies);
+    recorder.close();
+
+    EXPECT_EQ(recorder.frames(), 2u);
+    EXPECT_EQ(recorder.dropped_frames(), 0u);
+
+    ReplayPlayer player;
+    ASSERT_TRUE(player.open(path));
+    ASSERT_TRUE(player.seek(2));
+    ASSERT_EQ(player.positions().size(), 100u);
+    EXPECT_FLOAT_EQ(player.positions()[98].x, 98.0f);
+    EXPECT_FLOAT_EQ(player.positions()[99].x, 200.0f);
+    std::filesystem::remove(path);
+}
+
+TEST(Replay, PlayerRejectsOtherFiles) {
+    const std::string path = temp_path("engine_replay_bogus.rep");
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "not a replay file at all";
+    }
+    ReplayPlayer player;
+    EXPECT_FALSE(player.open(path));
+    EXPECT_FALSE(player.open(temp_path("engine_replay_missing.rep")));
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include "boid_flock.h"
+#include "rollback.h"
+#include "test_helpers.h"
+
+// Falling boxes on a floor plus a small flock, in lockstep mode so the
+// whole state can be compared through state_hash()
+static void make_rollback_scene(PhysicsWorld& world, Flock& flock) {
+    make_box_scene(world, 8, 3, {-4.0f, 0.5f});
+    for (int i = 0; i < 10; ++i) {
+        Boid boid{};
+        boid.body = make_dynamic(static_cast<BodyID>(i), {0.5f * float(i) - 3.0f, 2.0f},
+                                 {1.0f, 0.1f * float(i)});
+        boid.perception = 2.0f;
+        boid.max_speed = 4.0f;
+        boid.max_force = 2.0f;
+        boid.w_separation = 1.5f;
+        boid.w_alignment = 1.0f;
+        boid.w_cohesion = 1.0f;
+        flock.add_boid(boid);
+    }
+    world.attach_flock(&flock);
+    world.set_deterministic(true);
+}
+
+// The "network input": a kick to one box at step 12
+static void kick_at_12(const std::uint64_t step, PhysicsWorld& world) {
+    if (step == 12)
+        find_body(world, 20)->velocity += glm::vec2{3.0f, 4.0f};
+}
+
+TEST(Rollback, ResimulatingWithSameInputsChangesNothing) {
+    PhysicsWorld world(1.0f / 60.0f);
+    Flock flock;
+    make_rollback_scene(world, flock);
+    RollbackBuffer rb(world, &flock, 16);
+
+    rb.save();
+    for (int i = 0; i < 30; ++i) {
+        world.step_once(true);
+        rb.save();
+    }
+    const std::uint64_t hash = world.state_hash();
+
+    ASSERT_TRUE(rb.resimulate(22, nullptr));
+    EXPECT_EQ(world.step_count(), 30u);
+    EXPECT_EQ(world.state_hash(), hash);
+}
+
+TEST(Rollback, LateInputMatchesInputOnTime) {
+    const float dt = 1.0f / 60.0f;
+    PhysicsWorld onTime(dt);
+    Flock onTimeFlock;
+    make_rollback_scene(onTime, onTimeFlock);
+    for (std::uint64_t s = 0; s < 20; ++s) {
+        kick_at_12(s, onTime);
+        onTime.step_once(true);
+    }
+
+    // The kick for step 12 only arrives at step 20
+    PhysicsWorld late(dt);
+    Flock lateFlock;
+    make_rollback_scene(late, lateFlock);
+    RollbackBuffer rb(late, &lateFlock, 10);
+    rb.save();
+    for (int i = 0; i < 20; ++i) {
+        late.step_once(true);
+        rb.save();
+    }
+    ASSERT_NE(late.state_hash(), onTime.state_hash());
+
+    ASSERT_TRUE(rb.resimulate(12, kick_at_12));
+    EXPECT_EQ(late.step_count(), 20u);
+    EXPECT_EQ(late.state_hash(), onTime.state_hash());
+    EXPECT_EQ(late.previous_positions(), onTime.previous_positions());
+
+    // The re-simulated steps replaced the old ones in the buffer
+    for (int i = 0; i < 5; ++i) {
+        onTime.step_once(true);
+        late.step_once(true);
+    }
+    ASSERT_TRUE(rb.resimulate(18, nullptr));
+    EXPECT_EQ(late.state_hash(), onTime.state_hash());
+}
+
+TEST(Rollback, KeepsOnlyTheLastSteps) {
+    PhysicsWorld world(1.0f / 60.0f);
+    Flock flock;
+    make_rollback_scene(world, flock);
+    RollbackBuffer rb(world, &flock, 4);
+
+    rb.save();
+    for (int i = 0; i < 10; ++i) {
+        world.step_once(false);
+        rb.save();
+    }
+    EXPECT_FALSE(rb.has(6));
+    EXPECT_TRUE(rb.has(7));
+    EXPECT_TRUE(rb.has(10));
+
+    const std::uint64_t hash = world.state_hash();
+    EXPECT_FALSE(rb.resimulate(3, nullptr));
+    EXPECT_FALSE(rb.resimulate(11, nullptr));
+    EXPECT_EQ(world.step_count(), 10u);
+    EXPECT_EQ(world.state_hash(), hash);
+    EXPECT_GT(rb.memory_bytes(), 0u);
+}
+
+TEST(Rollback, RewindForgetsTheFuture) {
+    PhysicsWorld world(1.0f / 60.0f);
+    Flock flock;
+    make_rollback_scene(world, flock);
+    RollbackBuffer rb(world, &flock, 8);
+
+    rb.save();
+    for (int i = 0; i < 6; ++i) {
+        world.step_once(true);
+        rb.save();
+    }
+    ASSERT_TRUE(rb.rewind(3));
+    EXPECT_EQ(world.step_count(), 3u);
+    EXPECT_TRUE(rb.has(3));
+    EXPECT_FALSE(rb.has(4));
+    EXPECT_FALSE(rb.has(6));
+}
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "boid_flock.h"
+#include "rvo_solver.h"
+#include "scenario_file.h"
+#include "test_helpers.h"
+
+static std::string temp_path(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static void make_scenario_scene(PhysicsWorld& world, Flock& flock, RVOSolver& rvo) {
+    make_box_scene(world, 6, 1, {-3.0f, 1.0f}, {1.1f, 0.0f});
+    world.add_circle(make_dynamic(10, {0.0f, 4.0f}, {0.0f, 0.0f}, {0.0f, -9.8f}), 0.4f);
+    world.add_capsule(make_dynamic(11, {2.0f, 4.0f}, {0.0f, 0.0f}, {0.0f, -9.8f}), {0.3f, 0.0f}, 0.2f);
+    const glm::vec2 triangle[] = {{-0.4f, -0.3f}, {0.4f, -0.3f}, {0.0f, 0.4f}};
+    world.add_polygon(make_dynamic(12, {-2.0f, 4.0f}, {0.0f, 0.0f}, {0.0f, -9.8f}), triangle);
+    world.solver_settings().velocityIterations = 5;
+    world.set_deterministic(true);
+
+    for (int i = 0; i < 8; ++i) {
+        Boid boid{};
+        boid.body = make_dynamic(static_cast<BodyID>(i), {0.5f * float(i), 2.0f}, {1.0f, 0.2f});
+        boid.perception = 2.0f;
+        boid.max_speed = 4.0f;
+        boid.max_force = 2.0f;
+        boid.w_separation = 1.5f;
+        boid.w_alignment = 1.0f;
+        boid.w_cohesion = 1.0f;
+        flock.add_boid(boid);
+    }
+    world.attach_flock(&flock);
+
+    rvo.addAgent({-3.0f, 0.0f}, {1.0f, 0.0f}, 0.3f, 2.0f);
+    rvo.addAgent({3.0f, 0.0f}, {-1.0f, 0.0f}, 0.3f, 2.0f);
+}
+
+TEST(ScenarioFile, RoundTripSimulatesIdentically) {
+    const std::string path = temp_path("engine_scenario_roundtrip.scn");
+    const float dt = 1.0f / 60.0f;
+    PhysicsWorld original(dt);
+    Flock originalFlock;
+    RVOSolver originalRvo(dt);
+    make_scenario_scene(original, originalFlock, originalRvo);
+    ASSERT_TRUE(write_scenario(path, original, &originalFlock, &originalRvo));
+
+    ScenarioFile file;
+    ASSERT_TRUE(file.open(path));
+    EXPECT_EQ(file.fixed_dt(), dt);
+    EXPECT_TRUE(file.deterministic());
+    EXPECT_EQ(file.solver_settings().velocityIterations, 5);
+    EXPECT_EQ(file.bodies().size(), original.getBodies().size());
+    EXPECT_EQ(file.circles().size(), 1u);
+    EXPECT_EQ(file.capsules().size(), 1u);
+    EXPECT_EQ(file.polygons().size(), 1u);
+    EXPECT_EQ(file.boids().size(), 8u);
+    EXPECT_EQ(file.agents().size(), 2u);
+    EXPECT_EQ(file.bodies().back().id, 12u);
+
+    PhysicsWorld loaded(file.fixed_dt());
+    Flock loadedFlock;
+    RVOSolver loadedRvo(file.fixed_dt());
+    ASSERT_TRUE(file.build(loaded, loadedFlock, loadedRvo));
+    file.close();
+    EXPECT_EQ(loaded.flock(), &loadedFlock);
+
+    for (int i = 0; i < 60; ++i) {
+        original.fixed_step(dt);
+        loaded.fixed_step(dt);
+        originalRvo.step();
+        loadedRvo.step();
+    }
+    EXPECT_EQ(loaded.state_hash(), original.state_hash());
+    StateHash a;
+    StateHash b;
+    originalRvo.hashState(a);
+    loadedRvo.hashState(b);
+    EXPECT_EQ(a.value(), b.value());
+    std::filesystem::remove(path);
+}
+
+TEST(ScenarioFile, WorldWithoutFlockOrCrowd) {
+    const std::string path = temp_path("engine_scenario_bodies.scn");
+    PhysicsWorld world(1.0f / 30.0f);
+    world.getBodies().push_back(make_dynamic(4, {1.0f, 2.0f}));
+    ASSERT_TRUE(write_scenario(path, world, nullptr, nullptr));
+
+    ScenarioFile file;
+    ASSERT_TRUE(file.open(path));
+    EXPECT_EQ(file.fixed_dt(), 1.0f / 30.0f);
+    ASSERT_EQ(file.bodies().size(), 1u);
+    EXPECT_EQ(file.bodies()[0].position.y, 2.0f);
+    EXPECT_TRUE(file.boids().empty());
+    EXPECT_TRUE(file.agents().empty());
+    std::filesystem::remove(path);
+}
+
+TEST(ScenarioFile, RejectsOtherFiles) {
+    const std::string text = temp_path("engine_scenario_text.scn");
+    {
+        std::ofstream out(text);
+        out << "box dynamic 0 0 1 1 0 0\n";
+    }
+    ScenarioFile file;
+    EXPECT_FALSE(file.open(text));
+    EXPECT_FALSE(file.open(temp_path("engine_scenario_missing.scn")));
+
+    // Cut short
+    const std::string cut = temp_path("engine_scenario_cut.scn");
+    PhysicsWorld world(1.0f / 60.0f);
+    world.getBodies().push_back(make_dynamic(0, {0, 0}));
+    ASSERT_TRUE(write_scenario(cut, world, nullptr, nullptr));
+    std::filesystem::resize_file(cut, std::filesystem::file_size(cut) - 8);
+    EXPECT_FALSE(file.open(cut));
+
+    PhysicsWorld target(1.0f / 60.0f);
+    Flock flock;
+    RVOSolver rvo(1.0f / 60.0f);
+    EXPECT_FALSE(file.build(target, flock, rvo));
+    std::filesystem::remove(text);
+    std::filesystem::remove(cut);
+}
+
+TEST(ScenarioFile, RejectsShapeIndexOutOfRange) {
+    const std::string path = temp_path("engine_scenario_shapes.scn");
+    PhysicsWorld world(1.0f / 60.0f);
+    ASSERT_TRUE(world.add_circle(make_dynamic(0, {0, 0}), 0.5f));
+    world.getBodies().push_back(world.getBodies()[0]);
+    world.getBodies()[1].shape.index = 1;
+    ASSERT_TRUE(write_scenario(path, world, nullptr, nullptr));
+
+    ScenarioFile file;
+    EXPECT_FALSE(file.open(path));
+
+    world.getBodies()[1].shape.index = 0;
+    ASSERT_TRUE(write_scenario(path, world, nullptr, nullptr));
+    EXPECT_TRUE(file.open(path));
+    file.close();
+    std::filesystem::remove(path);
+}
+
+// A floor wider than a broadphase cell would be loaded into a world that
+// misses its pairs
+TEST(ScenarioFile, RejectsBodyLargerThanACell) {
+    const std::string path = temp_path("engine_scenario_oversized.scn");
+    PhysicsWorld world(1.0f / 60.0f);
+    Body floor = make_static(0, {0.0f, -1.0f});
+    floor.halfWidth = 20.0f;
+    floor.halfHeight = 1.0f;
+    world.getBodies().push_back(floor);
+    ASSERT_TRUE(write_scenario(path, world, nullptr, nullptr));
+
+    ScenarioFile file;
+    EXPECT_FALSE(file.open(path));
+
+    world.getBodies()[0].halfWidth = 1.0f;
+    ASSERT_TRUE(write_scenario(path, world, nullptr, nullptr));
+    EXPECT_TRUE(file.open(path));
+    file.close();
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include "scene_description.h"
+#include "boid_flock.h"
+#include "rvo_solver.h"
+#include "physics_world.h"
+
+static bool parse(const std::string& text, SceneDescription& scene, std::string* error = nullptr) {
+    std::istringstream in(text);
+    return parse_scene(in, scene, error);
+}
+
+TEST(SceneDescription, ReadsEveryEntryKind) {
+    SceneDescription scene;
+    ASSERT_TRUE(parse(
+        "# header comment\n"
+        "fixed_dt 0.02\n"
+        "deterministic\n"
+        "box static 0 -1 1 1 0 0\n"
+        "gravity 0 -9.8\n"
+        "mass 2\n"
+        "box dynamic 0 1 0.5 0.5 1 0   # trailing comment\n"
+        "circle dynamic 2 1 0.25 0 0\n"
+        "capsule kinematic 4 1 0.5 0 0.2 1 0\n"
+        "polygon dynamic 6 1 0 0 3 -0.5 -0.5 0.5 -0.5 0 0.5\n"
+        "plane 0 0\n"
+        "boid 1 2 3 4\n"
+        "boids 5 1\n"
+        "agent 0 0 0 0 0.5 2 1 0\n", scene));
+
+    EXPECT_FLOAT_EQ(scene.fixedDt, 0.02f);
+    EXPECT_TRUE(scene.deterministic);
+    ASSERT_EQ(scene.bodies.size(), 6u);
+    EXPECT_EQ(scene.bodies[0].body.invMass, 0.0f);
+    EXPECT_EQ(scene.bodies[0].body.acceleration.y, 0.0f);
+    EXPECT_FLOAT_EQ(scene.bodies[1].body.invMass, 0.5f);
+    EXPECT_FLOAT_EQ(scene.bodies[1].body.acceleration.y, -9.8f);
+    EXPECT_EQ(scene.bodies[1].body.id, 1u);
+    EXPECT_EQ(scene.bodies[2].body.shape.type, Type::circle);
+    EXPECT_EQ(scene.bodies[3].body.type, BodyType::Kinematic);
+    EXPECT_EQ(scene.bodies[3].body.acceleration.y, 0.0f);
+    EXPECT_EQ(scene.bodies[4].vertices.size(), 3u);
+    EXPECT_EQ(scene.bodies[5].body.shape.type, Type::plane);
+    EXPECT_EQ(scene.boids.size(), 6u);
+    EXPECT_EQ(scene.boids[5].body.id, 5u);
+    EXPECT_EQ(scene.agents.size(), 1u);
+}
+
+TEST(SceneDescription, ReportsLineOfBadEntry) {
+    SceneDescription scene;
+    std::string error;
+
+    EXPECT_FALSE(parse("fixed_dt 0.01\n\nbox dynamic 0 0 1\n", scene, &error));
+    EXPECT_EQ(error, "line 3: cannot read 'box' entry");
+
+    EXPECT_FALSE(parse("teleport 1 2\n", scene, &error));
+    EXPECT_FALSE(parse("box wobbly 0 0 1 1 0 0\n", scene, &error));
+    EXPECT_FALSE(parse("circle dynamic 0 0 1 0 0 extra\n", scene, &error));
+    EXPECT_FALSE(parse("polygon dynamic 0 0 0 0 2 0 0 1 1\n", scene, &error));
+}
+
+TEST(SceneDescription, RejectsShapesLargerThanACell) {
+    SceneDescription scene;
+    std::string error;
+
+    EXPECT_FALSE(parse("gravity 0 -9.8\nbox static 0 -1 20 1 0 0\n", scene, &error));
+    EXPECT_EQ(error, "line 2: cannot read 'box' entry");
+    EXPECT_FALSE(parse("box dynamic 0 0 0 0.5 0 0\n", scene));
+    EXPECT_FALSE(parse("circle dynamic 0 0 1.5 0 0\n", scene));
+    EXPECT_FALSE(parse("capsule dynamic 0 0 1 0 0.25 0 0\n", scene));
+    EXPECT_FALSE(parse("polygon dynamic 0 0 0 0 3 -2 0 2 0 0 1\n", scene));
+
+    ASSERT_TRUE(parse("box static 0 -1 1 1 0 0\ncircle dynamic 0 0 1 0 0\n", scene));
+    EXPECT_EQ(scene.bodies.size(), 2u);
+}
+
+TEST(SceneDescription, RandomBoidsAreReproducible) {
+    SceneDescription a;
+    SceneDescription b;
+    ASSERT_TRUE(parse("boids 20 42\n", a));
+    ASSERT_TRUE(parse("boids 20 42\n", b));
+
+    for (size_t i = 0; i < a.boids.size(); ++i) {
+        EXPECT_EQ(a.boids[i].body.position.x, b.boids[i].body.position.x);
+        EXPECT_EQ(a.boids[i].body.velocity.y, b.boids[i].body.velocity.y);
+    }
+}
+
+TEST(SceneDescription, BuildsWorldFlockAndCrowd) {
+    SceneDescription scene;
+    ASSERT_TRUE(parse(
+        "fixed_dt 0.02\n"
+        "deterministic\n"
+        "box dynamic 0 1 0.5 0.5 0 0\n"
+        "circle dynamic 2 1 0.25 0 0\n"
+        "polygon dynamic 6 1 0 0 3 -0.5 -0.5 0.5 -0.5 0 0.5\n"
+        "boids 3 1\n"
+        "agent 0 0 0 0 0.5 2 1 0\n", scene));
+
+    PhysicsWorld world(scene.fixedDt);
+    Flock flock;
+    RVOSolver rvo(scene.fixedDt);
+    ASSERT_TRUE(build_scene(scene, world, flock, rvo));
+
+    EXPECT_TRUE(world.deterministic());
+    EXPECT_EQ(world.getBodies().size(), 3u);
+    EXPECT_EQ(world.shapes().circles.size(), 1u);
+    EXPECT_EQ(world.shapes().polygons.size(), 1u);
+    EXPECT_EQ(world.flock(), &flock);
+    EXPECT_EQ(flock.getBoids().size(), 3u);
+    ASSERT_EQ(rvo.getAgents().size(), 1u);
+    EXPECT_FLOAT_EQ(rvo.getAgents()[0].prefVelocity.x, 1.0f);
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include "simulation_thread.h"
+#include "triple_buffer.h"
+#include "boid_flock.h"
+#include "test_helpers.h"
+
+// ============================================================
+// TripleBuffer
+// ============================================================
+
+TEST(TripleBuffer, ReaderSeesNothingBeforePublish) {
+    TripleBuffer<int> buf;
+    buf.back() = 7;
+
+    EXPECT_FALSE(buf.update());
+    EXPECT_EQ(buf.front(), 0);
+}
+
+TEST(TripleBuffer, ReaderGetsNewestValue) {
+    TripleBuffer<int> buf;
+    buf.back() = 1;
+    buf.publish();
+    buf.back() = 2;
+    buf.publish();
+
+    EXPECT_TRUE(buf.update());
+    EXPECT_EQ(buf.front(), 2);
+
+    // Nothing new: front stays put
+    EXPECT_FALSE(buf.update());
+    EXPECT_EQ(buf.front(), 2);
+}
+
+TEST(TripleBuffer, ConcurrentValuesAreNeverTorn) {
+    struct Pair { int a = 0; int b = 0; };
+    TripleBuffer<Pair> buf;
+    constexpr int count = 100000;
+
+    std::thread writer([&] {
+        for (int i = 1; i <= count; ++i) {
+            buf.back() = {i, -i};
+            buf.publish();
+        }
+    });
+
+    int last = 0;
+    bool torn = false;
+    bool backwards = false;
+    while (last < count) {
+        buf.update();
+        const Pair& p = buf.front();
+        torn |= p.a != -p.b;
+        backwards |= p.a < last;
+        last = p.a;
+    }
+    writer.join();
+
+    EXPECT_FALSE(torn);
+    EXPECT_FALSE(backwards);
+}
+
+// ============================================================
+// SimulationThread
+// ============================================================
+
+TEST(SimulationThread, StartPublishesInitialState) {
+    PhysicsWorld world(1.0f / 60.0f);
+    world.getBodies().push_back(make_dynamic(0, {1, 5}));
+
+    SimulationThread sim(world);
+    sim.start();
+    const RenderSnapshot& snap = sim.latest();
+    sim.stop();
+
+    ASSERT_EQ(snap.bodies.size(), 1u);
+    EXPECT_GE(sim.published(), 1u);
+}
+
+TEST(SimulationThread, StepsAtFixedRateAndPublishes) {
+    PhysicsWorld world(1.0f / 240.0f);
+    world.getBodies().push_back(make_dynamic(0, {0, 5}, {2, 0}));
+    Flock flock;
+    Boid boid{};
+    boid.body = make_dynamic(0, {0, 0}, {1, 0});
+    boid.perception = 1.0f;
+    boid.max_speed = 2.0f;
+    boid.max_force = 1.0f;
+    flock.add_boid(boid);
+    world.attach_flock(&flock);
+
+    SimulationThread sim(world);
+    sim.start();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (sim.published() < 5 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    const RenderSnapshot snap = sim.latest();
+    sim.stop();
+
+    EXPECT_FALSE(sim.running());
+    EXPECT_GT(snap.step, 0u);
+    EXPECT_LE(snap.step, world.step_count());
+    ASSERT_EQ(snap.bodies.size(), 1u);
+    EXPECT_GT(snap.bodies[0].position.x, 0.0f);
+    ASSERT_EQ(snap.boids.size(), 1u);
+}
+
+TEST(SimulationThread, StopWithoutStartIsHarmless) {
+    PhysicsWorld world(1.0f / 60.0f);
+    SimulationThread sim(world);
+    sim.stop();
+
+    EXPECT_FALSE(sim.running());
+    EXPECT_EQ(sim.published(), 0u);
+}
@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include "boid_flock.h"
+#include "rvo_solver.h"
+#include "snapshot.h"
+#include "test_helpers.h"
+
+// Boxes on a floor, circles and polygons falling into them (so the GJK
+// simplex caches are in use), plus a flock
+static void make_snapshot_scene(PhysicsWorld& world, Flock& flock) {
+    make_box_scene(world, 8, 3, {-4.0f, 0.5f});
+
+    const glm::vec2 triangle[] = {{-0.4f, -0.3f}, {0.4f, -0.3f}, {0.0f, 0.4f}};
+    for (int i = 0; i < 4; ++i) {
+        world.add_circle(make_dynamic(static_cast<BodyID>(100 + i), {-3.0f + 2.0f * float(i), 4.0f},
+                                      {0.0f, 0.0f}, {0.0f, -9.8f}), 0.3f);
+        world.add_polygon(make_dynamic(static_cast<BodyID>(200 + i), {-2.0f + 2.0f * float(i), 5.0f},
+                                       {0.0f, 0.0f}, {0.0f, -9.8f}), triangle);
+    }
+
+    for (int i = 0; i < 12; ++i) {
+        Boid boid{};
+        boid.body = make_dynamic(static_cast<BodyID>(i), {0.4f * float(i) - 3.0f, 2.0f},
+                                 {1.0f, 0.1f * float(i)});
+        boid.perception = 2.0f;
+        boid.max_speed = 4.0f;
+        boid.max_force = 2.0f;
+        boid.w_separation = 1.5f;
+        boid.w_alignment = 1.0f;
+        boid.w_cohesion = 1.0f;
+        flock.add_boid(boid);
+    }
+    world.attach_flock(&flock);
+    world.set_deterministic(true);
+}
+
+// ============================================================
+// PhysicsWorld
+// ============================================================
+
+TEST(Snapshot, RestoredWorldContinuesIdentically) {
+    const float dt = 1.0f / 60.0f;
+    PhysicsWorld original(dt);
+    Flock originalFlock;
+    make_snapshot_scene(original, originalFlock);
+    for (int i = 0; i < 40; ++i)
+        original.fixed_step(dt);
+    ASSERT_FALSE(original.getManifolds().empty());
+
+    std::vector<std::byte> worldData;
+    std::vector<std::byte> flockData;
+    original.save_snapshot(worldData);
+    originalFlock.save_snapshot(flockData);
+
+    // Empty world, everything comes from the snapshot
+    PhysicsWorld restored(dt);
+    Flock restoredFlock;
+    restored.attach_flock(&restoredFlock);
+    ASSERT_TRUE(restored.load_snapshot(worldData));
+    ASSERT_TRUE(restoredFlock.load_snapshot(flockData));
+    EXPECT_EQ(restored.step_count(), original.step_count());
+    EXPECT_EQ(restored.state_hash(), original.state_hash());
+    EXPECT_TRUE(restored.deterministic());
+
+    for (int i = 0; i < 60; ++i) {
+        original.fixed_step(dt);
+        restored.fixed_step(dt);
+        ASSERT_EQ(original.state_hash(), restored.state_hash()) << "step " << i;
+    }
+}
+
+TEST(Snapshot, LoadRewindsTheSameWorld) {
+    const float dt = 1.0f / 60.0f;
+    PhysicsWorld world(dt);
+    Flock flock;
+    make_snapshot_scene(world, flock);
+    world.step_n(20);
+
+    std::vector<std::byte> worldData;
+    std::vector<std::byte> flockData;
+    world.save_snapshot(worldData);
+    flock.save_snapshot(flockData);
+
+    world.step_n(30);
+    const std::uint64_t first = world.state_hash();
+    const std::vector<Body> firstBodies = world.getBodies();
+
+    ASSERT_TRUE(world.load_snapshot(worldData));
+    ASSERT_TRUE(flock.load_snapshot(flockData));
+    EXPECT_EQ(world.step_count(), 20u);
+    world.step_n(30);
+
+    EXPECT_EQ(world.state_hash(), first);
+    ASSERT_EQ(world.getBodies().size(), firstBodies.size());
+    for (size_t i = 0; i < firstBodies.size(); ++i) {
+        EXPECT_EQ(world.getBodies()[i].position.x, firstBodies[i].position.x);
+        EXPECT_EQ(world.getBodies()[i].position.y, firstBodies[i].position.y);
+    }
+}
+
+TEST(Snapshot, KeepsAccumulatorAndSettings) {
+    PhysicsWorld world(1.0f / 60.0f);
+    world.getBodies().push_back(make_dynamic(0, {0, 5}, {1, 0}));
+    world.solver_settings().velocityIterations = 3;
+    world.update_settings().maxSubsteps = 2;
+    world.update(0.025f);
+
+    std::vector<std::byte> data;
+    world.save_snapshot(data);
+
+    PhysicsWorld restored(1.0f / 60.0f);
+    ASSERT_TRUE(restored.load_snapshot(data));
+    EXPECT_EQ(restored.accumulator(), world.accumulator());
+    EXPECT_EQ(restored.solver_settings().velocityIterations, 3);
+    EXPECT_EQ(restored.update_settings().maxSubsteps, 2);
+    EXPECT_EQ(restored.previous_positions(), world.previous_positions());
+}
+
+TEST(Snapshot, SavingAgainReusesTheBuffer) {
+    PhysicsWorld world(1.0f / 60.0f);
+    Flock flock;
+    make_snapshot_scene(world, flock);
+    world.step_n(10);
+
+    std::vector<std::byte> data;
+    world.save_snapshot(data);
+    const std::byte* storage = data.data();
+    const size_t size = data.size();
+
+    world.step_n(1);
+    world.save_snapshot(data);
+    EXPECT_EQ(data.data(), storage);
+    EXPECT_EQ(data.size() % 8, 0u);
+    EXPECT_LE(data.size(), data.capacity());
+    EXPECT_GT(size, world.getBodies().size() * sizeof(Body));
+}
+
+TEST(Snapshot, RejectsForeignBuffers) {
+    const float dt = 1.0f / 60.0f;
+    PhysicsWorld world(dt);
+    Flock flock;
+    make_snapshot_scene(world, flock);
+    world.step_n(5);
+    std::vector<std::byte> data;
+    world.save_snapshot(data);
+
+    PhysicsWorld target(dt);
+    target.getBodies().push_back(make_dynamic(7, {1, 2}));
+
+    // Truncated
+    std::vector<std::byte> cut(data.begin(), data.end() - 8);
+    EXPECT_FALSE(target.load_snapshot(cut));
+
+    // Other version
+    std::vector<std::byte> old = data;
+    old[4] = std::byte{0x7f};
+    EXPECT_FALSE(target.load_snapshot(old));
+
+    // Flock snapshot given to a world
+    std::vector<std::byte> flockData;
+    flock.save_snapshot(flockData);
+    EXPECT_FALSE(target.load_snapshot(flockData));
+    EXPECT_FALSE(target.load_snapshot({}));
+
+    // Other fixed_dt
+    PhysicsWorld slower(1.0f / 30.0f);
+    EXPECT_FALSE(slower.load_snapshot(data));
+
+    ASSERT_EQ(target.getBodies().size(), 1u);
+    EXPECT_EQ(target.getBodies()[0].id, 7u);
+    EXPECT_EQ(target.step_count(), 0u);
+}
+
+// accepts_snapshot() answers what load_snapshot() would do, so callers
+// restoring several objects can check all of them first.
+TEST(Snapshot, AcceptsWithoutLoading) {
+    const float dt = 1.0f / 60.0f;
+    PhysicsWorld world(dt);
+    Flock flock;
+    make_snapshot_scene(world, flock);
+    std::vector<std::byte> worldData;
+    std::vector<std::byte> flockData;
+    world.save_snapshot(worldData);
+    flock.save_snapshot(flockData);
+
+    PhysicsWorld target(dt);
+    Flock targetFlock;
+    EXPECT_TRUE(target.accepts_snapshot(worldData));
+    EXPECT_FALSE(target.accepts_snapshot(flockData));
+    EXPECT_FALSE(PhysicsWorld(1.0f / 30.0f).accepts_snapshot(worldData));
+    EXPECT_TRUE(targetFlock.accepts_snapshot(flockData));
+    EXPECT_FALSE(targetFlock.accepts_snapshot(worldData));
+
+    EXPECT_TRUE(target.getBodies().empty());
+    EXPECT_TRUE(targetFlock.getBoids().empty());
+}
+
+// The last record ends off the 8 byte grid and the file stops without
+// padding, while the header claims one more section.
+TEST(Snapshot, RejectsSectionCountPastTruncatedPadding) {
+    std::vector<std::byte> data(sizeof(SnapshotHeader) + sizeof(SnapshotSection) + 3);
+    const SnapshotHeader header{SNAPSHOT_MAGIC, SNAPSHOT_VERSION,
+                                static_cast<uint16_t>(SnapshotKind::World), 2, 0, data.size()};
+    const SnapshotSection section{1, 1, 3};
+    std::memcpy(data.data(), &header, sizeof(header));
+    std::memcpy(data.data() + sizeof(header), &section, sizeof(section));
+
+    const SnapshotReader r(data, SnapshotKind::World);
+    EXPECT_FALSE(r.valid());
+}
+
+// ============================================================
+// RVOSolver
+// ============================================================
+
+TEST(Snapshot, RestoredRvoContinuesIdentically) {
+    const float dt = 1.0f / 60.0f;
+    RVOSolver original(dt);
+    for (int i = 0; i < 8; ++i) {
+        const float s = i % 2 == 0 ? 1.0f : -1.0f;
+        const uint32_t id = original.addAgent({-4.0f * s, 0.2f * float(i)}, {0.0f, 0.0f}, 0.3f, 2.0f);
+        original.setPreferredVelocity(id, {1.5f * s, 0.0f});
+    }
+    for (int i = 0; i < 30; ++i)
+        original.step();
+
+    std::vector<std::byte> data;
+    original.saveSnapshot(data);
+    RVOSolver restored(dt);
+    ASSERT_TRUE(restored.loadSnapshot(data));
+
+    RVOSolver other(1.0f / 30.0f);
+    EXPECT_FALSE(other.loadSnapshot(data));
+
+    for (int i = 0; i < 30; ++i) {
+        original.step();
+        restored.step();
+    }
+    StateHash a;
+    StateHash b;
+    original.hashState(a);
+    restored.hashState(b);
+    EXPECT_EQ(a.value(), b.value());
+}
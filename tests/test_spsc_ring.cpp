@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "spsc_ring.h"
+
+TEST(SpscRing, RoundsCapacityUpToPowerOfTwo) {
+    SpscRing<int> ring(100);
+    EXPECT_EQ(ring.capacity(), 128u);
+}
+
+TEST(SpscRing, PopsInPushOrderAcrossTheWrap) {
+    SpscRing<int> ring(8);
+    int out[8];
+    for (int round = 0; round < 5; ++round) {
+        const int items[5] = {round, round + 1, round + 2, round + 3, round + 4};
+        ASSERT_TRUE(ring.try_push(items, 5));
+        ASSERT_EQ(ring.pop(out, 8), 5u);
+        for (int i = 0; i < 5; ++i)
+            EXPECT_EQ(out[i], round + i);
+    }
+}
+
+TEST(SpscRing, RejectsWhatDoesNotFitWhole) {
+    SpscRing<int> ring(4);
+    const int items[3] = {1, 2, 3};
+    ASSERT_TRUE(ring.try_push(items, 3));
+    EXPECT_FALSE(ring.try_push(items, 2));
+    EXPECT_TRUE(ring.try_push(7));
+    EXPECT_FALSE(ring.try_push(8));
+    EXPECT_EQ(ring.size(), 4u);
+
+    int out[2];
+    EXPECT_EQ(ring.pop(out, 2), 2u);
+    EXPECT_TRUE(ring.try_push(items, 2));
+}
+
+TEST(SpscRing, TwoThreadsSeeEveryItemOnce) {
+    constexpr std::uint32_t count = 200000;
+    SpscRing<std::uint32_t> ring(1024);
+
+    std::thread producer([&] {
+        for (std::uint32_t i = 0; i < count;) {
+            if (ring.try_push(i))
+                ++i;
+            else
+                std::this_thread::yield();
+        }
+    });
+
+    std::uint32_t expected = 0;
+    std::uint32_t buffer[64];
+    while (expected < count) {
+        const size_t n = ring.pop(buffer, 64);
+        if (n == 0)
+            std::this_thread::yield();
+        for (size_t i = 0; i < n; ++i)
+            ASSERT_EQ(buffer[i], expected++);
+    }
+    producer.join();
+    EXPECT_EQ(ring.size(), 0u);
+}
+
+// ============================================================
+// GrowingSpscRing
+// ============================================================
+
+TEST(GrowingSpscRing, BatchLargerThanTheRingGrowsItInOrder) {
+    GrowingSpscRing<int> ring(4);
+    const int small[3] = {1, 2, 3};
+    ASSERT_TRUE(ring.try_push(small, 3));
+
+    int big[10];
+    for (int i = 0; i < 10; ++i)
+        big[i] = 10 + i;
+    ASSERT_TRUE(ring.try_push(big, 10));
+    EXPECT_GE(ring.capacity(), 10u);
+    EXPECT_EQ(ring.grows(), 1u);
+
+    // The consumer has not left the first ring yet
+    std::vector<int> huge(100, 0);
+    EXPECT_FALSE(ring.try_push(huge.data(), huge.size()));
+
+    int out[16];
+    ASSERT_EQ(ring.pop(out, 16), 3u);
+    ASSERT_EQ(ring.pop(out + 3, 16), 10u);
+    EXPECT_EQ(out[2], 3);
+    EXPECT_EQ(out[3], 10);
+    EXPECT_EQ(out[12], 19);
+
+    EXPECT_TRUE(ring.try_push(huge.data(), huge.size()));
+    EXPECT_EQ(ring.grows(), 2u);
+}
+
+TEST(GrowingSpscRing, TwoThreadsSeeEveryItemOnceWhileGrowing) {
+    constexpr std::uint32_t batches = 2000;
+    GrowingSpscRing<std::uint32_t> ring(16);
+
+    std::uint32_t total = 0;
+    for (std::uint32_t b = 0; b < batches; ++b)
+        total += 1 + b % 97;
+
+    std::thread producer([&] {
+        std::vector<std::uint32_t> batch;
+        std::uint32_t next = 0;
+        for (std::uint32_t b = 0; b < batches;) {
+            batch.resize(1 + b % 97);
+            for (std::uint32_t i = 0; i < batch.size(); ++i)
+                batch[i] = next + i;
+            if (ring.try_push(batch.data(), batch.size())) {
+                next += static_cast<std::uint32_t>(batch.size());
+                ++b;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::uint32_t expected = 0;
+    std::uint32_t buffer[64];
+    while (expected < total) {
+        const size_t n = ring.pop(buffer, 64);
+        if (n == 0)
+            std::this_thread::yield();
+        for (size_t i = 0; i < n; ++i)
+            ASSERT_EQ(buffer[i], expected++);
+    }
+    producer.join();
+    EXPECT_GT(ring.grows(), 0u);
+}
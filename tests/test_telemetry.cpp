@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "boid_flock.h"
+#include "telemetry.h"
+#include "test_helpers.h"
+
+static std::string temp_path(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// Floor plus three boxes dropped onto it, so contacts begin mid run
+static void make_telemetry_scene(PhysicsWorld& world) {
+    make_box_scene(world, 3, 1, {-3.0f, 0.7f}, {3.0f, 0.0f});
+}
+
+static std::vector<std::string> read_lines(const std::string& path) {
+    std::ifstream in(path);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);)
+        lines.push_back(line);
+    return lines;
+}
+
+TEST(Telemetry, CsvRowsAreDecimatedButContactsAreNot) {
+    const std::string path = temp_path("engine_telemetry.csv");
+    const float dt = 1.0f / 60.0f;
+    PhysicsWorld world(dt);
+    make_telemetry_scene(world);
+
+    TelemetrySettings settings;
+    settings.decimation = 4;
+    TelemetryExporter exporter;
+    ASSERT_TRUE(exporter.open(path, settings));
+    world.add_step_listener(&exporter);
+
+    int begun = 0;
+    for (int i = 0; i < 40; ++i) {
+        world.fixed_step(dt);
+        begun += static_cast<int>(world.contact_cache().begun().size());
+    }
+    exporter.close();
+    ASSERT_GT(begun, 0);
+    EXPECT_EQ(exporter.dropped_steps(), 0u);
+    EXPECT_EQ(exporter.records_written(), exporter.records());
+
+    const std::vector<std::string> lines = read_lines(path);
+    ASSERT_FALSE(lines.empty());
+    EXPECT_EQ(lines[0], "step,kind,id,other,x,y,vx,vy");
+
+    int bodyRows = 0;
+    int beginRows = 0;
+    for (size_t i = 1; i < lines.size(); ++i) {
+        std::istringstream row(lines[i]);
+        std::string step;
+        std::string kind;
+        std::getline(row, step, ',');
+        std::getline(row, kind, ',');
+        if (kind == "body") {
+            ++bodyRows;
+            EXPECT_EQ(std::stoull(step) % 4, 0u);
+        }
+        if (kind == "begin")
+            ++beginRows;
+    }
+    // 10 sampled steps x 3 dynamic bodies, the floor is left out
+    EXPECT_EQ(bodyRows, 30);
+    EXPECT_EQ(beginRows, begun);
+    EXPECT_EQ(lines.size() - 1, exporter.records());
+    std::filesystem::remove(path);
+}
+
+TEST(Telemetry, ColumnarBlocksHoldTheSampledState) {
+    const std::string path = temp_path("engine_telemetry.bin");
+    const float dt = 1.0f / 60.0f;
+    PhysicsWorld world(dt);
+    make_telemetry_scene(world);
+    Flock flock;
+    Boid boid{};
+    boid.body = make_dynamic(7, {1.0f, 2.0f}, {0.5f, 0.0f});
+    boid.perception = 1.0f;
+    boid.max_speed = 2.0f;
+    boid.max_force = 1.0f;
+    flock.add_boid(boid);
+    world.attach_flock(&flock);
+
+    TelemetrySettings settings;
+    settings.format = TelemetryFormat::Columnar;
+    settings.contacts = false;
+    settings.blockRecords = 5;
+    TelemetryExporter exporter;
+    ASSERT_TRUE(exporter.open(path, settings));
+    world.add_step_listener(&exporter);
+
+    world.step_n(3, true);
+    const glm::vec2 boidPosition = flock.getBoids()[0].body.position;
+    const glm::vec2 lastPosition = find_body(world, 3)->position;
+    exporter.close();
+
+    std::ifstream in(path, std::ios::binary);
+    const std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    ASSERT_GE(data.size(), 8u);
+    std::uint32_t magic;
+    std::memcpy(&magic, data.data(), 4);
+    EXPECT_EQ(magic, TELEMETRY_MAGIC);
+
+    // 3 steps x (3 bodies + 1 boid) in blocks of 5, 5 and 2
+    std::vector<std::uint64_t> steps;
+    std::vector<std::uint8_t> kinds;
+    std::vector<float> xs;
+    std::vector<float> ys;
+    size_t offset = 8;
+    int blocks = 0;
+    while (offset < data.size()) {
+        std::uint32_t count;
+        std::memcpy(&count, data.data() + offset, 4);
+        offset += 4;
+        const size_t base = steps.size();
+        steps.resize(base + count);
+        kinds.resize(base + count);
+        xs.resize(base + count);
+        ys.resize(base + count);
+        std::memcpy(&steps[base], data.data() + offset, count * 8);
+        offset += count * 8;
+        std::memcpy(&kinds[base], data.data() + offset, count);
+        offset += count + count * 4 * 2;    // kind, id, other
+        std::memcpy(&xs[base], data.data() + offset, count * 4);
+        offset += count * 4;
+        std::memcpy(&ys[base], data.data() + offset, count * 4);
+        offset += count * 4 * 3;            // y, vx, vy
+        ++blocks;
+    }
+    EXPECT_EQ(offset, data.size());
+    EXPECT_EQ(blocks, 3);
+    ASSERT_EQ(steps.size(), 12u);
+    EXPECT_EQ(steps.back(), 3u);
+    EXPECT_EQ(kinds[10], static_cast<std::uint8_t>(TelemetryKind::Body));
+    EXPECT_EQ(kinds[11], static_cast<std::uint8_t>(TelemetryKind::Boid));
+    EXPECT_EQ(xs[10], lastPosition.x);
+    EXPECT_EQ(ys[10], lastPosition.y);
+    EXPECT_EQ(xs[11], boidPosition.x);
+    std::filesystem::remove(path);
+}
+
+// 20 rows per step never fit into a ring of 16: instead of dropping
+// every step or holding it up, the exporter grows the ring.
+TEST(Telemetry, StepLargerThanTheRingGrowsIt) {
+    const std::string path = temp_path("engine_telemetry_grow.csv");
+    PhysicsWorld world(1.0f / 60.0f);
+    for (int i = 0; i < 20; ++i)
+        world.getBodies().push_back(make_dynamic(static_cast<BodyID>(i), {4.0f * float(i), 10.0f}));
+
+    TelemetrySettings settings;
+    settings.ringRecords = 16;
+    TelemetryExporter exporter;
+    ASSERT_TRUE(exporter.open(path, settings));
+    world.add_step_listener(&exporter);
+    world.step_n(2, true);
+    EXPECT_GE(exporter.ring_records(), 20u);
+    exporter.close();
+
+    EXPECT_EQ(exporter.records(), 40u);
+    EXPECT_EQ(exporter.dropped_steps(), 0u);
+    EXPECT_EQ(read_lines(path).size(), 41u);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <vector>
+#include "thread_pool.h"
+
+TEST(ThreadPool, VisitsEveryIndexOnce) {
+    ThreadPool pool(3);
+    std::vector<std::atomic<int>> hits(1000);
+
+    pool.parallel_for(static_cast<uint32_t>(hits.size()),
+                      [&](uint32_t i) { hits[i].fetch_add(1); });
+
+    for (const auto& h : hits)
+        EXPECT_EQ(h.load(), 1);
+}
+
+TEST(ThreadPool, ReusableAcrossCalls) {
+    ThreadPool pool(2);
+    std::atomic<int> sum{0};
+
+    for (int round = 0; round < 50; ++round)
+        pool.parallel_for(10, [&](uint32_t i) { sum += static_cast<int>(i); });
+
+    EXPECT_EQ(sum.load(), 50 * 45);
+}
+
+TEST(ThreadPool, NestedCallRunsInline) {
+    ThreadPool pool(2);
+    std::atomic<int> inner{0};
+
+    pool.parallel_for(4, [&](uint32_t) {
+        pool.parallel_for(5, [&](uint32_t) { ++inner; });
+    });
+
+    EXPECT_EQ(inner.load(), 20);
+}
+
+TEST(ThreadPool, NoWorkersRunsSerially) {
+    ThreadPool pool(0);
+    std::vector<uint32_t> order;
+
+    pool.parallel_for(4, [&](uint32_t i) { order.push_back(i); });
+
+    EXPECT_EQ(order, (std::vector<uint32_t>{0, 1, 2, 3}));
+    EXPECT_EQ(pool.thread_count(), 1u);
+}
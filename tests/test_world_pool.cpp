@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "world_pool.h"
+#include "thread_pool.h"
+#include "test_helpers.h"
+
+// World i: i + 1 falling bodies and a flock of 2 * i boids
+static void fill_pool(WorldPool& pool) {
+    for (uint32_t i = 0; i < pool.size(); ++i) {
+        PhysicsWorld& world = pool.world(i);
+        world.set_deterministic(true);
+        for (uint32_t b = 0; b <= i; ++b)
+            world.getBodies().push_back(
+                make_dynamic(b, {float(b) * 3.0f, 5.0f}, {1.0f, 0.0f}, {0.0f, -9.8f}));
+        for (uint32_t k = 0; k < 2 * i; ++k) {
+            Boid boid{};
+            boid.body = make_dynamic(k, {0.2f * float(k), 0.0f}, {1.0f, 0.5f});
+            boid.perception = 2.0f;
+            boid.max_speed = 3.0f;
+            boid.max_force = 1.0f;
+            boid.w_separation = 1.0f;
+            boid.w_alignment = 1.0f;
+            boid.w_cohesion = 1.0f;
+            pool.flock(i).add_boid(boid);
+        }
+    }
+}
+
+TEST(WorldPool, ParallelRunMatchesSerialRun) {
+    WorldPool serial(1.0f / 60.0f, 40);
+    WorldPool parallel(1.0f / 60.0f, 40);
+    fill_pool(serial);
+    fill_pool(parallel);
+    ThreadPool threads(3);
+
+    serial.run(30, nullptr);
+    parallel.run(30, &threads);
+    // Second run partitions by the measured times
+    serial.run(30, nullptr);
+    parallel.run(30, &threads);
+
+    EnsembleResults a;
+    EnsembleResults b;
+    serial.collect(a);
+    parallel.collect(b);
+
+    ASSERT_EQ(a.stateHash.size(), 40u);
+    EXPECT_EQ(a.stateHash, b.stateHash);
+    EXPECT_EQ(a.kineticEnergy, b.kineticEnergy);
+    for (uint32_t i = 0; i < 40; ++i)
+        EXPECT_EQ(b.steps[i], 60u);
+}
+
+TEST(WorldPool, WorldMatchesStandaloneWorld) {
+    WorldPool pool(1.0f / 60.0f, 4);
+    fill_pool(pool);
+
+    // Same start state as world 3, outside the pool
+    PhysicsWorld alone(1.0f / 60.0f);
+    Flock flock = pool.flock(3);
+    alone.set_deterministic(true);
+    alone.attach_flock(&flock);
+    alone.getBodies() = pool.world(3).getBodies();
+
+    ThreadPool threads(2);
+    pool.run(20, &threads);
+    alone.step_n(20);
+
+    EXPECT_EQ(alone.state_hash(), pool.world(3).state_hash());
+}
+
+TEST(WorldPool, ChunksCoverAllWorldsByCost) {
+    WorldPool pool(1.0f / 60.0f, 200);
+    fill_pool(pool);
+    EXPECT_EQ(pool.chunk_count(), 0u);
+    ThreadPool threads(3);
+    pool.run(1, &threads);
+
+    EXPECT_GT(pool.chunk_count(), 1u);
+    EXPECT_LT(pool.chunk_count(), 200u);
+
+    EnsembleResults r;
+    pool.collect(r);
+    for (uint32_t i = 0; i < pool.size(); ++i)
+        EXPECT_EQ(r.steps[i], 1u);
+}
+
+TEST(WorldPool, CustomMetricColumn) {
+    WorldPool pool(1.0f / 60.0f, 3);
+    fill_pool(pool);
+    pool.add_metric([](const PhysicsWorld& w, const Flock& f) {
+        return float(w.getBodies().size() + f.getBoids().size());
+    });
+
+    EnsembleResults r;
+    pool.collect(r);
+
+    ASSERT_EQ(r.metrics.size(), 1u);
+    EXPECT_EQ(r.metrics[0], (std::vector<float>{1.0f, 4.0f, 7.0f}));
+}
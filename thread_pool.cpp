@@ -0,0 +1,105 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#include "thread_pool.h"
+
+#include "determinism.h"
+
+static thread_local bool t_inside_pool = false;
+
+unsigned ThreadPool::default_workers()
+{
+    const unsigned hw = std::thread::hardware_concurrency();
+    return hw > 1 ? hw - 1 : 0;
+}
+
+ThreadPool::ThreadPool(const unsigned workers)
+{
+    m_workers.reserve(workers);
+    for (unsigned i = 0; i < workers; ++i)
+        m_workers.emplace_back([this] { worker_loop(); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& t: m_workers)
+        t.join();
+}
+
+void ThreadPool::run_indices()
+{
+    for (;;) {
+        const uint32_t i = m_next.fetch_add(1, std::memory_order_relaxed);
+        if (i >= m_count)
+            return;
+        (*m_job)(i);
+    }
+}
+
+// Every worker takes part in every generation exactly once, the submitter
+// waits until all of them reported back. This keeps a late waking worker
+// from picking up indices of the next job with a stale job pointer.
+//
+// Workers run in the default floating point environment whatever the
+// creating thread had set, so a job gives the same bits on any thread.
+void ThreadPool::worker_loop()
+{
+    set_deterministic_fp_env();
+    t_inside_pool = true;
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+            if (m_stop)
+                return;
+            seen = m_generation;
+        }
+
+        run_indices();
+
+        {
+            std::lock_guard lock(m_mutex);
+            if (++m_finished == m_workers.size())
+                m_done.notify_one();
+        }
+    }
+}
+
+void ThreadPool::parallel_for(const uint32_t count,
+                              const std::function<void(uint32_t)>& fn)
+{
+    if (count == 0)
+        return;
+
+    if (m_workers.empty() || count == 1 || t_inside_pool) {
+        for (uint32_t i = 0; i < count; ++i)
+            fn(i);
+        return;
+    }
+
+    std::lock_guard submit(m_submit);
+    {
+        std::lock_guard lock(m_mutex);
+        m_job = &fn;
+        m_count = count;
+        m_next.store(0, std::memory_order_relaxed);
+        m_finished = 0;
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    t_inside_pool = true;
+    run_indices();
+    t_inside_pool = false;
+
+    std::unique_lock lock(m_mutex);
+    m_done.wait(lock, [&] { return m_finished == m_workers.size(); });
+    m_job = nullptr;
+}
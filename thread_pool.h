@@ -0,0 +1,54 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#ifndef ENGINELOOP_THREAD_POOL_H
+#define ENGINELOOP_THREAD_POOL_H
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for data-parallel loops.
+// parallel_for blocks until every index is processed, the calling thread
+// takes part in the work. Indices are handed out in increasing order, so
+// work sorted by cost (largest first) is scheduled largest first.
+// Calls made from inside a job run serially on the calling thread.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned workers = default_workers());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void parallel_for(uint32_t count, const std::function<void(uint32_t)>& fn);
+
+    // Workers plus the calling thread.
+    [[nodiscard]] unsigned thread_count() const { return static_cast<unsigned>(m_workers.size()) + 1; }
+
+    static unsigned default_workers();
+
+private:
+    void worker_loop();
+    void run_indices();
+
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_submit;            // one parallel_for at a time
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+
+    const std::function<void(uint32_t)>* m_job = nullptr;
+    uint32_t m_count = 0;
+    std::atomic<uint32_t> m_next{0};
+    uint64_t m_generation = 0;
+    unsigned m_finished = 0;
+    bool m_stop = false;
+};
+
+#endif //ENGINELOOP_THREAD_POOL_H
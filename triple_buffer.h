@@ -0,0 +1,56 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#ifndef ENGINELOOP_TRIPLE_BUFFER_H
+#define ENGINELOOP_TRIPLE_BUFFER_H
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Lock free hand over of the newest value from one writer thread to one
+// reader thread. The writer fills back() and publishes it, the reader
+// picks up the newest published slot with update() and reads front().
+// Neither side ever waits; values the reader was too slow for are skipped.
+//
+// The three slots rotate through the roles back / middle / front. Only
+// the middle index is shared, packed together with a flag that tells
+// whether it holds a value the reader has not seen yet.
+template <typename T>
+class TripleBuffer {
+public:
+    // --- Writer side ---
+    T& back() { return m_slots[m_back]; }
+
+    void publish()
+    {
+        const uint8_t old = m_middle.exchange(static_cast<uint8_t>(m_back | FRESH),
+                                              std::memory_order_acq_rel);
+        m_back = old & INDEX;
+    }
+
+    // --- Reader side ---
+    // true when front() changed to a newer value
+    bool update()
+    {
+        if ((m_middle.load(std::memory_order_relaxed) & FRESH) == 0)
+            return false;
+        const uint8_t old = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = old & INDEX;
+        return true;
+    }
+
+    [[nodiscard]] const T& front() const { return m_slots[m_front]; }
+
+private:
+    static constexpr uint8_t INDEX = 0x3;
+    static constexpr uint8_t FRESH = 0x4;
+
+    std::array<T, 3> m_slots{};
+    // Writer and reader indices on their own cache lines
+    alignas(64) uint8_t m_back = 0;
+    alignas(64) std::atomic<uint8_t> m_middle{1};
+    alignas(64) uint8_t m_front = 2;
+};
+
+#endif //ENGINELOOP_TRIPLE_BUFFER_H
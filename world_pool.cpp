@@ -0,0 +1,141 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#include "world_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+#include "engine_time.h"
+#include "thread_pool.h"
+
+// Chunks per thread: enough to even out estimates that are off, few
+// enough that handing out chunks stays cheap next to stepping them.
+static constexpr unsigned CHUNKS_PER_THREAD = 8;
+
+WorldPool::WorldPool(const float fixed_dt_seconds, const std::uint32_t count)
+{
+    m_worlds.reserve(count);
+    m_flocks.resize(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        m_worlds.emplace_back(fixed_dt_seconds);
+        m_worlds.back().attach_flock(&m_flocks[i]);
+    }
+    m_run_micros.assign(count, 0.0f);
+}
+
+// Before the first run: bodies are about linear, and so are boids with
+// the grid neighbour search. Only a flock switched to brute force is
+// quadratic.
+static double estimate_cost(const PhysicsWorld& world, const Flock& flock)
+{
+    const auto bodies = static_cast<double>(world.getBodies().size());
+    const auto boids = static_cast<double>(flock.getBoids().size());
+    const double boidCost = (flock.neighbour_search() == NeighbourSearch::BruteForce)
+                                ? boids * boids * 0.05
+                                : boids * 4.0;
+    return 1.0 + bodies * 4.0 + boidCost;
+}
+
+void WorldPool::partition(const unsigned threads)
+{
+    const std::uint32_t n = size();
+    if (m_cost.size() != n) {
+        m_cost.resize(n);
+        for (std::uint32_t i = 0; i < n; ++i)
+            m_cost[i] = estimate_cost(m_worlds[i], m_flocks[i]);
+    }
+
+    m_order.resize(n);
+    std::iota(m_order.begin(), m_order.end(), 0u);
+    std::stable_sort(m_order.begin(), m_order.end(), [&](const std::uint32_t a, const std::uint32_t b) {
+        return m_cost[a] > m_cost[b];
+    });
+
+    // Cut the sorted order into chunks of about total / chunks cost. An
+    // expensive world makes a chunk of its own.
+    const double total = std::accumulate(m_cost.begin(), m_cost.end(), 0.0);
+    const double target = total / static_cast<double>(std::max(1u, threads * CHUNKS_PER_THREAD));
+    m_chunks.clear();
+    m_chunks.push_back(0);
+    double acc = 0.0;
+    for (std::uint32_t k = 0; k < n; ++k) {
+        acc += m_cost[m_order[k]];
+        if (acc >= target || k + 1 == n) {
+            m_chunks.push_back(k + 1);
+            acc = 0.0;
+        }
+    }
+}
+
+void WorldPool::run(const std::uint32_t steps, ThreadPool* pool)
+{
+    if (size() == 0)
+        return;
+
+    partition(pool ? pool->thread_count() : 1);
+
+    auto run_chunk = [&](const std::uint32_t c) {
+        for (std::uint32_t k = m_chunks[c]; k < m_chunks[c + 1]; ++k) {
+            const std::uint32_t i = m_order[k];
+            const engine::time_point start = engine::now();
+            m_worlds[i].step_n(steps);
+            const std::chrono::duration<float, std::micro> took = engine::now() - start;
+            m_run_micros[i] = took.count();
+        }
+    };
+
+    const std::uint32_t chunks = chunk_count();
+    if (pool) {
+        pool->parallel_for(chunks, run_chunk);
+    } else {
+        for (std::uint32_t c = 0; c < chunks; ++c)
+            run_chunk(c);
+    }
+
+    // Measured time is the cost for the next run
+    for (std::uint32_t i = 0; i < size(); ++i)
+        m_cost[i] = std::max(static_cast<double>(m_run_micros[i]), 1e-3);
+}
+
+static float kinetic_energy(const Body& b)
+{
+    const float mass = b.invMass > 0.0f ? 1.0f / b.invMass : 1.0f;
+    return 0.5f * mass * (b.velocity.x * b.velocity.x + b.velocity.y * b.velocity.y);
+}
+
+void WorldPool::collect(EnsembleResults& out) const
+{
+    const std::uint32_t n = size();
+    out.steps.resize(n);
+    out.stateHash.resize(n);
+    out.manifolds.resize(n);
+    out.kineticEnergy.resize(n);
+    out.maxPenetration.resize(n);
+    out.runMicros.assign(m_run_micros.begin(), m_run_micros.end());
+    out.metrics.resize(m_metrics.size());
+
+    for (std::uint32_t i = 0; i < n; ++i) {
+        const PhysicsWorld& world = m_worlds[i];
+        out.steps[i] = world.step_count();
+        out.stateHash[i] = world.state_hash();
+        out.manifolds[i] = static_cast<std::uint32_t>(world.getManifolds().size());
+        out.maxPenetration[i] = world.solver_stats().maxPenetration;
+
+        float energy = 0.0f;
+        for (const Body& b: world.getBodies())
+            if (b.type == BodyType::Dynamic)
+                energy += kinetic_energy(b);
+        for (const Boid& b: m_flocks[i].getBoids())
+            energy += kinetic_energy(b.body);
+        out.kineticEnergy[i] = energy;
+    }
+
+    for (size_t m = 0; m < m_metrics.size(); ++m) {
+        out.metrics[m].resize(n);
+        for (std::uint32_t i = 0; i < n; ++i)
+            out.metrics[m][i] = m_metrics[m](m_worlds[i], m_flocks[i]);
+    }
+}
@@ -0,0 +1,79 @@
+//
+// Created by oguzh on 18.10.2026.
+//
+
+#ifndef ENGINELOOP_WORLD_POOL_H
+#define ENGINELOOP_WORLD_POOL_H
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "boid_flock.h"
+#include "physics_world.h"
+
+class ThreadPool;
+
+// One entry per world in every column, indexed like WorldPool::world().
+struct EnsembleResults {
+    std::vector<std::uint64_t> steps;
+    std::vector<std::uint64_t> stateHash;       // 0 unless deterministic
+    std::vector<std::uint32_t> manifolds;
+    std::vector<float> kineticEnergy;           // bodies and boids, unit mass where invMass is 0
+    std::vector<float> maxPenetration;
+    std::vector<float> runMicros;               // wall time of the last run()
+    std::vector<std::vector<float>> metrics;    // [metric][world], see add_metric()
+};
+
+// Many small independent simulations (parameter sweeps, Monte Carlo)
+// stepped in parallel inside one process. Worlds and flocks live in two
+// contiguous arrays allocated once; flock i is attached to world i.
+//
+// run() hands the worlds to the thread pool in chunks of about equal
+// cost, largest first. The cost of a world is the time its last run()
+// took, or an estimate from its body and boid counts before the first
+// one. A world is always stepped by one thread, so results do not
+// depend on the partitioning.
+class WorldPool {
+public:
+    WorldPool(float fixed_dt_seconds, std::uint32_t count);
+
+    WorldPool(const WorldPool&) = delete;
+    WorldPool& operator=(const WorldPool&) = delete;
+
+    [[nodiscard]] std::uint32_t size() const { return static_cast<std::uint32_t>(m_worlds.size()); }
+
+    PhysicsWorld& world(const std::uint32_t i) { return m_worlds[i]; }
+    Flock& flock(const std::uint32_t i) { return m_flocks[i]; }
+    [[nodiscard]] const PhysicsWorld& world(const std::uint32_t i) const { return m_worlds[i]; }
+    [[nodiscard]] const Flock& flock(const std::uint32_t i) const { return m_flocks[i]; }
+
+    // Extra result column, evaluated per world by collect()
+    using Metric = std::function<float(const PhysicsWorld&, const Flock&)>;
+    void add_metric(Metric metric) { m_metrics.push_back(std::move(metric)); }
+
+    // PhysicsWorld::step_n(steps) on every world. Without a pool the
+    // worlds are stepped on the calling thread.
+    void run(std::uint32_t steps, ThreadPool* pool);
+
+    void collect(EnsembleResults& out) const;
+
+    // Chunks of the last run(), as ranges into the cost sorted order.
+    // 0 before the first run().
+    [[nodiscard]] std::uint32_t chunk_count() const
+    {
+        return m_chunks.empty() ? 0 : static_cast<std::uint32_t>(m_chunks.size()) - 1;
+    }
+
+private:
+    void partition(unsigned threads);
+
+    std::vector<PhysicsWorld> m_worlds;
+    std::vector<Flock> m_flocks;
+    std::vector<Metric> m_metrics;
+    std::vector<double> m_cost;             // per world, micros or estimate
+    std::vector<float> m_run_micros;
+    std::vector<std::uint32_t> m_order;     // world indices, most expensive first
+    std::vector<std::uint32_t> m_chunks;    // chunk k is m_order[m_chunks[k], m_chunks[k+1])
+};
+
+#endif //ENGINELOOP_WORLD_POOL_H